@@ -34,12 +34,15 @@ enum class InterruptType {
 enum class MemoryAllocationStrategy {
     CONTINUOUS,     // 连续分配
     PARTITIONED,    // 分区分配
-    PAGED          // 分页分配
+    PAGED,          // 分页分配
+    BUDDY           // 伙伴系统分配
 };
 
 // 分页相关常量
 const uint64_t PAGE_SIZE = 4096;  // 4KB页面大小
 const uint64_t TOTAL_PAGES = MEMORY_SIZE / PAGE_SIZE;
+const uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;           // 2MB大页
+const uint64_t HUGE_PAGE_FRAMES = HUGE_PAGE_SIZE / PAGE_SIZE; // 每个大页包含的页框数
 
 // Scheduling algorithms
 enum class SchedulingAlgorithm {
@@ -121,6 +121,14 @@ struct FileAddresses {
     std::optional<uint32_t> indexed_index_block;
 };
 
+// 文件数据块的顺序列表，供内存映射按页读写
+struct FileBlockMap {
+    uint32_t inode;
+    uint64_t size;               // simulated_size
+    std::vector<uint32_t> blocks; // 第 i 块对应文件第 i 页
+    uint32_t block_payload;      // 每块可存放数据的字节数（链接分配的块尾保存下一块的指针）
+};
+
 enum class FsCreateResult {
     Success,
     AlreadyExists,
@@ -149,10 +157,22 @@ public:
     // File system status and info
     FileSystemStatus get_filesystem_status();
     FileAddresses get_file_addresses(const std::string& path);
+    // 按 inode 的分配方式解析出全部数据块，路径不是文件时返回 nullopt
+    std::optional<FileBlockMap> get_file_block_map(const std::string& path);
     std::vector<FileSystemLog> get_filesystem_logs(const std::string& start_time = "", 
                                                  const std::string& end_time = "", 
                                                  const std::string& operation_type = "");
 
+    // --- 裸块访问（供交换区等内核组件使用，不经过 inode） ---
+    // 预留一段连续的磁盘块，之后不会被文件分配使用
+    std::optional<ContiguousAllocation> reserve_blocks(uint32_t block_count);
+    // 归还预留的块并丢弃其内容
+    void release_blocks(const ContiguousAllocation& blocks);
+    void read_block(uint32_t block_num, void* buffer);
+    void write_block(uint32_t block_num, const void* data);
+    // 丢弃块内容（之后读取为全 0），释放模拟磁盘占用的内存
+    void discard_block(uint32_t block_num);
+
     // --- Internal quick lookup (performance) ---
     bool lookup_dir_entry(uint32_t dir_inode_idx, const std::string& name, uint32_t& out_inode_idx);
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "frame_bitmap.h"
+
+// 模拟内存池的后备存储方式
+enum class MemoryBackingMode {
+    EAGER,  // 启动时一次性分配整个内存池
+    LAZY    // 只预留地址空间，首次写入时才按粒度提交
+};
+
+// 模拟内存池的后备存储
+// LAZY 模式下只保留虚拟地址空间，写入时按 COMMIT_GRANULE 提交，
+// 读取未提交的区域直接返回 0，不会触发提交。
+class BackingStore {
+public:
+    static const uint64_t COMMIT_GRANULE = 64 * 1024;
+
+    BackingStore();
+    ~BackingStore();
+
+    BackingStore(const BackingStore&) = delete;
+    BackingStore& operator=(const BackingStore&) = delete;
+
+    // 预留 size 字节；失败时抛出 std::runtime_error
+    void reserve(uint64_t size, MemoryBackingMode mode);
+    void release();
+
+    void read(uint64_t address, void* buffer, size_t size) const;
+    void write(uint64_t address, const void* data, size_t size);
+    // 确保区间已提交（调用方随后要通过裸指针写入时使用）
+    void commit(uint64_t address, uint64_t size);
+    // 归还完全落在区间内的提交粒度，之后读取为 0
+    void decommit(uint64_t address, uint64_t size);
+    bool is_committed(uint64_t address) const;
+
+    // 整个池的起始指针；LAZY 模式下只有已提交的区间可以直接访问
+    char* data() { return base_; }
+    const char* data() const { return base_; }
+    MemoryBackingMode mode() const { return mode_; }
+    uint64_t reserved_bytes() const { return size_; }
+    uint64_t committed_bytes() const;
+
+private:
+    char* base_;
+    uint64_t size_;
+    MemoryBackingMode mode_;
+    FrameBitmap committed_; // 每一位对应一个提交粒度
+
+    bool platform_commit(uint64_t first_granule, uint64_t count);
+    void platform_decommit(uint64_t first_granule, uint64_t count);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// 伙伴系统分配器
+// 管理 [0, 2^max_order * min_block) 的地址区间，按阶维护空闲链表：
+// 分配时向上取整到 2 的幂并逐阶拆分，释放时与伙伴块逐阶合并，拆分/合并最多 max_order 次。
+class BuddyAllocator {
+public:
+    BuddyAllocator(uint64_t total_size, uint64_t min_block);
+
+    void reset();
+
+    // 分配至少 size 字节的块，返回块起始地址
+    std::optional<uint64_t> allocate(uint64_t size);
+    // 释放 address 处的已分配块，返回块大小；地址无效时返回 0
+    uint64_t free(uint64_t address);
+
+    // 已分配块的大小（未分配时返回 0）
+    uint64_t block_size(uint64_t address) const;
+    // 满足 size 的块大小（2 的幂）
+    uint64_t rounded_size(uint64_t size) const;
+
+    uint32_t max_order() const { return max_order_; }
+    uint64_t min_block() const { return min_block_; }
+    size_t free_block_count(uint32_t order) const { return free_areas_[order].size(); }
+    uint64_t largest_free_block() const;
+
+private:
+    uint64_t min_block_;
+    uint32_t max_order_;
+    // 每阶一个空闲链表，按地址排序，优先使用低地址块
+    std::vector<std::set<uint64_t>> free_areas_;
+    std::unordered_map<uint64_t, uint32_t> allocated_; // 块地址 -> 阶
+
+    uint32_t order_for(uint64_t size) const;
+    uint64_t order_size(uint32_t order) const { return min_block_ << order; }
+};
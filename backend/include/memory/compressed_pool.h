@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// 压缩池统计
+struct CompressedPoolStats {
+    uint64_t stored_pages = 0;
+    uint64_t compressed_bytes = 0;        // 压缩后数据的总字节数
+    uint64_t pool_bytes = 0;              // 各尺寸类占用的内存，包括空闲槽
+    uint64_t limit = 0;                   // 0 表示不限
+    uint64_t stores = 0;                  // 存入的页面数（即少写一次磁盘）
+    uint64_t loads = 0;
+    uint64_t rejected_incompressible = 0; // 压缩后仍超过 MAX_STORED_SIZE 的页面
+    uint64_t rejected_full = 0;           // 池已达上限而没有存入的页面
+    uint64_t compress_ns = 0;             // 压缩、解压累计耗时
+    uint64_t decompress_ns = 0;
+};
+
+// 压缩页面池（类似 zram）
+// 页面用 LZ4 风格的 LZ77 编码压缩后存入按 CLASS_SIZE 划分的尺寸类，每个尺寸类一块连续的内存，
+// 释放的槽位留在该类的空闲链表中复用。压缩效果不好的页面不存入，由调用方写入磁盘交换区。
+class CompressedPool {
+public:
+    static const uint64_t CLASS_SIZE = 64;
+    static const uint64_t MAX_STORED_SIZE = PAGE_SIZE * 3 / 4;
+
+    explicit CompressedPool(uint64_t limit = 0);
+
+    void set_limit(uint64_t bytes) { limit_ = bytes; } // 不回收已占用的内存，只限制之后的增长
+    uint64_t limit() const { return limit_; }
+
+    // 存入一页，返回句柄；压缩率不足或池已满时返回 std::nullopt
+    std::optional<uint64_t> store(const void* page);
+    bool load(uint64_t handle, void* buffer);
+    void release(uint64_t handle);
+    void clear();
+
+    CompressedPoolStats stats() const;
+    void reset_stats(); // 清零累计计数，不影响已存入的页面
+
+    // 压缩到 dst，超过 capacity 时返回 0；解压后的长度必须恰好为 expected
+    static size_t compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+    static bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t expected);
+
+private:
+    struct SizeClass {
+        std::vector<uint8_t> arena;      // 槽位 i 位于 [i * 槽大小, (i + 1) * 槽大小)
+        std::vector<uint16_t> lengths;   // 各槽位中压缩数据的长度，0 表示空闲
+        std::vector<uint32_t> free_slots;
+    };
+
+    uint64_t limit_;
+    uint64_t pool_bytes_;
+    std::vector<SizeClass> classes_; // 第 i 类的槽大小为 (i + 1) * CLASS_SIZE
+    CompressedPoolStats counters_;
+};
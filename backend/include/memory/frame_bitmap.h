@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 分层页框位图
+// 第 0 层每一位对应一个页框（1 = 已使用）；上一层每一位表示下一层对应的 64 位字是否已满。
+// 查找空闲页框时自顶向下逐层取首个 0 位，每层只访问一个字，配合维护的计数器，
+// 分配、释放与统计都与页框总数无关。
+class FrameBitmap {
+public:
+    explicit FrameBitmap(uint64_t frame_count);
+
+    // 将所有页框标记为空闲
+    void reset();
+
+    bool test(uint64_t frame) const;
+    // 标记/清除单个页框，状态未变化时返回 false
+    bool set(uint64_t frame);
+    bool clear(uint64_t frame);
+
+    // 返回编号最小的空闲页框，没有时返回 UINT64_MAX
+    uint64_t find_first_free() const;
+    // 查找并占用一个空闲页框，没有时返回 UINT64_MAX
+    uint64_t allocate();
+    // 查找并占用 count 个连续空闲页框，起点按 count 对齐（count 为 64 的整数倍），没有时返回 UINT64_MAX
+    uint64_t allocate_aligned_run(uint64_t count);
+
+    uint64_t size() const { return frame_count_; }
+    uint64_t used_count() const { return used_count_; }
+    uint64_t free_count() const { return frame_count_ - used_count_; }
+
+private:
+    uint64_t frame_count_;
+    uint64_t used_count_;
+    // levels_[0] 为页框位图，levels_.back() 只有一个字
+    std::vector<std::vector<uint64_t>> levels_;
+
+    void mark_full(size_t level, uint64_t index);
+    void mark_not_full(size_t level, uint64_t index);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+// 表示一个内存块
+struct FreeBlock {
+    uint64_t base_address;
+    uint64_t size;
+};
+
+// 连续分配的放置策略
+enum class PlacementPolicy {
+    FIRST_FIT,  // 首次适应：地址最低的足够大空闲块
+    BEST_FIT,   // 最佳适应：满足要求的最小空闲块
+    WORST_FIT,  // 最坏适应：最大的空闲块
+    NEXT_FIT    // 循环首次适应：从上次分配位置之后继续查找
+};
+
+// 空闲块索引
+// 按地址排序的树堆（treap）保存空闲块，每个结点额外维护子树中最大的块大小，
+// 首次/循环首次适应沿树下降即可定位；另有按 (大小, 地址) 排序的索引服务最佳/最坏适应。
+// 分配、释放与相邻块合并均为 O(log n)。
+class FreeBlockIndex {
+public:
+    // 按地址顺序遍历空闲块（供 UI 使用，不复制整个列表）
+    class const_iterator {
+    public:
+        const FreeBlock& operator*() const { return current_; }
+        const FreeBlock* operator->() const { return &current_; }
+        const_iterator& operator++();
+        bool operator==(const const_iterator& other) const { return stack_ == other.stack_; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class FreeBlockIndex;
+        const_iterator(const FreeBlockIndex* owner, int32_t root);
+        void descend_left(int32_t node);
+        void load();
+
+        const FreeBlockIndex* owner_;
+        std::vector<int32_t> stack_;
+        FreeBlock current_;
+    };
+
+    FreeBlockIndex();
+
+    // 清空后放入一个覆盖 [base, base + size) 的空闲块
+    void reset(uint64_t base, uint64_t size);
+
+    // 按策略切出 size 字节，返回起始地址
+    std::optional<uint64_t> allocate(uint64_t size, PlacementPolicy policy);
+    // 从某个空闲块中切出指定区间；区间不完整地落在一个空闲块内时返回 false
+    bool claim(uint64_t base, uint64_t size);
+    // 归还区间并与相邻空闲块合并；与已有空闲块重叠时返回 false
+    bool release(uint64_t base, uint64_t size);
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    FreeBlock front() const;
+    const_iterator begin() const { return const_iterator(this, root_); }
+    const_iterator end() const { return const_iterator(this, NIL); }
+
+    uint64_t total_free() const { return total_free_; }
+    uint64_t largest_block() const;
+
+private:
+    static const int32_t NIL = -1;
+
+    struct Node {
+        uint64_t base;
+        uint64_t size;
+        uint64_t max_size; // 子树中最大的块
+        uint32_t priority;
+        int32_t left;
+        int32_t right;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<int32_t> free_nodes_;
+    int32_t root_;
+    size_t count_;
+    uint64_t total_free_;
+    uint32_t rng_state_;
+    uint64_t next_fit_cursor_;
+    std::set<std::pair<uint64_t, uint64_t>> by_size_; // (size, base)
+
+    int32_t new_node(uint64_t base, uint64_t size);
+    void pull(int32_t node);
+    void split(int32_t node, uint64_t key, int32_t& left, int32_t& right);
+    int32_t merge(int32_t left, int32_t right);
+
+    void insert(uint64_t base, uint64_t size);
+    void erase(uint64_t base);
+    void resize(uint64_t base, uint64_t new_size);
+    bool resize_in(int32_t node, uint64_t base, uint64_t new_size);
+
+    int32_t predecessor(uint64_t address) const; // base < address 的最大结点
+    int32_t successor(uint64_t address) const;   // base >= address 的最小结点
+    int32_t first_fit(uint64_t size, uint64_t min_base) const;
+    int32_t first_fit_in(int32_t node, uint64_t size, uint64_t min_base) const;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "free_block_index.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// 进程堆的分配策略
+enum class HeapPolicy {
+    TLSF,      // 两级分离适配：按大小两级索引的空闲链表加位图，分配与释放均为 O(1)
+    FIRST_FIT, // 地址最低的足够大空闲块
+    BEST_FIT   // 满足要求的最小空闲块
+};
+
+struct HeapStats {
+    uint64_t capacity = 0;
+    uint64_t allocated = 0;    // 已分配块的大小之和（按对齐取整后）
+    uint64_t requested = 0;    // 已分配块请求的字节数之和
+    uint64_t live_blocks = 0;
+    uint64_t free_blocks = 0;
+    uint64_t largest_free = 0;
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t failures = 0;     // 没有合适空闲块的次数（调用方扩大堆之前）
+};
+
+// 进程堆分配器
+// 管理 [0, capacity) 的偏移区间，块的元数据保存在分配器中而不是堆内存里。
+// 堆只能在末尾扩大或收缩；释放时与地址相邻的空闲块合并。
+// TLSF 的一级索引为大小的最高位，二级把每个 2 的幂区间再分成 16 份，
+// 小于 256 字节的块按 16 字节线性划分；查找时把请求向上取整到下一个二级区间，
+// 保证取到的链表头一定足够大，不需要遍历链表。首次/最佳适应使用 FreeBlockIndex。
+class HeapAllocator {
+public:
+    static const uint64_t ALIGNMENT = 16;
+
+    explicit HeapAllocator(HeapPolicy policy = HeapPolicy::TLSF);
+
+    HeapPolicy policy() const { return policy_; }
+    uint64_t capacity() const { return capacity_; }
+
+    // 返回块的偏移；没有合适的空闲块时返回 nullopt，调用方可以扩大堆后重试
+    std::optional<uint64_t> allocate(uint64_t size);
+    // offset 不是已分配块的起点时返回 false
+    bool free(uint64_t offset);
+    // 已分配块的大小（对齐后），未分配时返回 0
+    uint64_t block_size(uint64_t offset) const;
+
+    // 新增的空间与末尾的空闲块合并
+    void grow(uint64_t new_capacity);
+    uint64_t trailing_free() const; // 末尾连续空闲的字节数
+    // [new_capacity, capacity) 不完全空闲时返回 false
+    bool shrink(uint64_t new_capacity);
+
+    HeapStats stats() const;
+
+private:
+    static const uint32_t SL_LOG2 = 4;
+    static const uint32_t SL_COUNT = 1u << SL_LOG2;
+    static const uint32_t FL_SHIFT = SL_LOG2 + 4;      // 小于 2^FL_SHIFT 的块都在第 0 级
+    static const uint32_t FL_COUNT = 64 - FL_SHIFT + 1;
+    static constexpr int32_t NIL = -1;
+
+    struct TlsfBlock {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t requested;
+        bool free;
+        int32_t prev_phys; // 地址相邻的块
+        int32_t next_phys;
+        int32_t prev_free; // 所在的空闲链表
+        int32_t next_free;
+    };
+
+    struct Allocation {
+        uint64_t size;
+        uint64_t requested;
+    };
+
+    HeapPolicy policy_;
+    uint64_t capacity_;
+    HeapStats counters_; // allocated、requested 与各项计数，其余字段由 stats() 计算
+
+    // TLSF
+    std::vector<TlsfBlock> blocks_;
+    std::vector<int32_t> spare_blocks_;
+    uint64_t fl_bitmap_;
+    uint32_t sl_bitmap_[FL_COUNT];
+    int32_t heads_[FL_COUNT][SL_COUNT];
+    int32_t last_block_; // 地址最高的块
+    uint64_t tlsf_free_count_;
+    std::unordered_map<uint64_t, int32_t> tlsf_used_; // 偏移 -> 块
+
+    // 首次/最佳适应
+    FreeBlockIndex index_;
+    std::map<uint64_t, Allocation> index_used_;
+
+    static void mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+    int32_t new_block(uint64_t offset, uint64_t size);
+    void insert_free(int32_t block);
+    void remove_free(int32_t block);
+    int32_t find_suitable(uint64_t size);
+    // 把 block 并入地址相邻的前一个块并回收 block
+    void absorb_into_prev(int32_t block);
+    std::optional<uint64_t> tlsf_allocate(uint64_t size, uint64_t requested);
+    bool tlsf_free(uint64_t offset);
+};
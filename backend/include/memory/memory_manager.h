@@ -3,17 +3,28 @@
 #include "../common.h"
 #include <vector>
 #include <cstdint>
-#include <list>
 #include <optional>
 #include <map>
-#include <bitset>
+#include <set>
+#include <unordered_map>
+#include <deque>
+#include <chrono>
+#include <functional>
 #include "../process/pcb.h" // For MemoryBlock
+#include "frame_bitmap.h"
+#include "backing_store.h"
+#include "free_block_index.h"
+#include "buddy_allocator.h"
+#include "page_replacer.h"
+#include "page_table.h"
+#include "tlb.h"
+#include "vma_tree.h"
+#include "swap_area.h"
+#include "compressed_pool.h"
+#include "heap_allocator.h"
+#include "occupancy_map.h"
 
-// 表示一个内存块
-struct FreeBlock {
-    uint64_t base_address;
-    uint64_t size;
-};
+class FileSystemManager;
 
 // 分区信息
 struct Partition {
@@ -26,28 +37,186 @@ struct Partition {
     Partition(uint64_t base, uint64_t sz) : base_address(base), size(sz), is_free(true), owner_pid(-1) {}
 };
 
-// 页表项
-struct PageTableEntry {
-    bool valid;           // 页面是否有效
-    uint64_t frame_number; // 物理页框号
-    bool dirty;           // 脏位
-    bool accessed;        // 访问位
-    
-    PageTableEntry() : valid(false), frame_number(0), dirty(false), accessed(false) {}
+// 分区布局中的一类分区：count 个大小为 size 的分区
+struct PartitionSpec {
+    uint64_t size;
+    uint32_t count;
+};
+
+// 请求调页统计
+struct PageFaultStats {
+    uint64_t accesses = 0;   // 经过地址转换的访问次数
+    uint64_t faults = 0;     // 缺页次数
+    uint64_t evictions = 0;  // 被换出的页面数
+    uint64_t writebacks = 0; // 换出时写回的脏页数
+};
+
+// 连续分配的碎片统计
+struct FragmentationStats {
+    uint64_t free_bytes = 0;
+    uint64_t free_blocks = 0;
+    uint64_t largest_free_block = 0;
+    double external_fragmentation = 0.0; // 1 - 最大空闲块 / 空闲总量，0 表示空闲空间完全连续
+    uint64_t compacted_blocks = 0;       // 紧凑累计移动的块数
+    uint64_t compacted_bytes = 0;        // 紧凑累计移动的字节数
+};
+
+// 内存块被紧凑移动后的通知：[old_base, old_base + size) 的内容已移到 new_base
+using RelocationCallback = std::function<void(uint64_t old_base, uint64_t new_base, uint64_t size)>;
+
+// 交换区统计
+struct SwapStats {
+    bool on_disk = false;           // 是否挂接在文件系统上
+    uint64_t total_slots = 0;       // 0 表示内存交换区，容量不限
+    uint64_t used_slots = 0;
+    uint64_t pending_writeback = 0; // 写回队列中尚未落盘的页面
+    uint64_t swap_outs = 0;         // 换出到交换区（进入写回队列）的页面数
+    uint64_t swap_ins = 0;          // 从交换区读回的页面数
+    uint64_t queue_hits = 0;        // 其中直接从写回队列取回的页面数
+    uint64_t writebacks_completed = 0;
+    double swap_out_rate = 0.0;     // 自统计清零以来每秒换出的页面数
+    double swap_in_rate = 0.0;
+};
+
+// 压缩交换统计
+struct CompressedSwapStats {
+    bool enabled = false;
+    CompressedPoolStats pool;
+    uint64_t faults = 0;         // 从压缩池调入的缺页数
+    uint64_t fault_ns = 0;       // 这些缺页读回页面内容的累计耗时
+    uint64_t disk_faults = 0;    // 从磁盘交换区调入的缺页数（不含写回队列命中）
+    uint64_t disk_fault_ns = 0;
+};
+
+// 页框共享统计
+struct FrameSharingStats {
+    uint64_t shared_frames = 0;   // 被多个进程映射的页框
+    uint64_t private_frames = 0;  // 只被一个进程映射的已用页框
+    uint64_t shm_frames = 0;      // 共享内存段持有的页框
+    uint64_t file_frames = 0;     // 页缓存中映射的文件页
+    uint64_t shared_mappings = 0; // 指向共享页框的页表项总数
+    uint64_t cow_copies = 0;      // 写时复制产生的私有副本数
+};
+
+// 大页统计
+struct HugePageStats {
+    uint64_t huge_pages = 0;  // 当前映射的 2MB 大页
+    uint64_t allocations = 0; // 分配时直接使用大页的次数
+    uint64_t promotions = 0;  // 由 512 个普通页合并而成的大页数
+    uint64_t splits = 0;      // 拆分回普通页的大页数
+};
+
+// 相同页面合并统计
+struct PageMergingStats {
+    uint64_t pages_scanned = 0;
+    uint64_t full_scans = 0;     // 扫描游标回到第 0 个页框的次数
+    uint64_t merges = 0;         // 累计合并的页面数
+    uint64_t merged_frames = 0;  // 当前由合并产生、被多个页面共享的页框
+    uint64_t pages_sharing = 0;  // 这些页框上除第一个映射者以外的映射数，即节省的页框数
+    uint64_t bytes_saved = 0;
+};
+
+// 分散/聚集读写的一个区段：虚拟地址 [virtual_address, virtual_address + size) 与缓冲区 buffer
+struct VirtualIoVec {
+    uint64_t virtual_address;
+    void* buffer; // 写入时只读
+    size_t size;
+};
+
+// 分配策略迁移中的一个进程
+struct MigrationEntry {
+    ProcessID pid;
+    uint64_t size;
+    std::vector<MemoryBlock> old_blocks;  // 旧策略下的内存块（释放连续分配时需要）
+    std::optional<MemoryBlock> new_block; // 新策略下预先分配的内存块
+};
+
+enum class MigrationState {
+    IDLE,
+    PLANNING,    // 正在新策略下预先分配，旧分配保持有效
+    COMMITTED,   // 旧分配已释放，策略已切换
+    ROLLED_BACK  // 预分配失败或被中止，已释放预分配的部分
+};
+
+// 分配策略迁移进度
+struct MigrationStatus {
+    MigrationState state = MigrationState::IDLE;
+    MemoryAllocationStrategy from = MemoryAllocationStrategy::CONTINUOUS;
+    MemoryAllocationStrategy to = MemoryAllocationStrategy::CONTINUOUS;
+    size_t total_processes = 0;
+    size_t planned_processes = 0;
+    uint64_t planned_bytes = 0;
+    ProcessID failed_pid = -1; // 预分配失败的进程
 };
 
 // 进程页表
 struct ProcessPageTable {
     ProcessID pid;
-    std::vector<PageTableEntry> pages;
+    uint64_t page_count; // 虚拟地址空间顶端（页号），进程分配与共享内存段依次映射在此之上
+    PageTable table;
+    VmaTree vmas;        // 只有落在某个区域内的页面可以访问
+    bool has_heap;       // 首次 brk 时在地址空间顶端建立堆
+    uint64_t heap_start_page;
+    uint64_t program_break; // 堆的当前结束地址（字节）
     
-    ProcessPageTable() : pid(-1) {}  // 默认构造函数
-    ProcessPageTable(ProcessID p) : pid(p) {}
+    ProcessPageTable() : pid(-1), page_count(0), has_heap(false), heap_start_page(0), program_break(0) {}  // 默认构造函数
+    ProcessPageTable(ProcessID p, PageTableLayout layout)
+        : pid(p), page_count(0), table(layout), has_heap(false), heap_start_page(0), program_break(0) {}
+};
+
+// 被映射的文件，记录映射时解析出的数据块
+struct MappedFile {
+    FileSystemManager* fs;
+    std::string path;
+    uint64_t size;
+    std::vector<uint32_t> blocks; // 第 i 块对应文件第 i 页
+    uint32_t block_payload;       // 每块中属于文件数据的字节数
+    std::set<ProcessID> mappers;  // 地址空间中仍有该文件区域的进程
+};
+
+// 页缓存中的文件页：所有映射者共享同一页框，最后一个映射者撤销时写回并释放
+struct CachedFilePage {
+    uint64_t frame;
+    bool dirty; // 已撤销映射的页表项中记录过写入
+    std::vector<ResidentPage> mappers;
+};
+
+// 进程堆：空间不足时 brk 至少扩大 HEAP_GROW_STEP，末尾空闲超过 HEAP_TRIM_THRESHOLD 时归还
+const uint64_t HEAP_GROW_STEP = 128 * 1024;
+const uint64_t HEAP_TRIM_THRESHOLD = 256 * 1024;
+
+// 压缩交换池默认上限
+const uint64_t COMPRESSED_POOL_DEFAULT_LIMIT = 256ULL * 1024 * 1024;
+
+// 内存控制组：组内进程的内存按组计费
+const int ROOT_MEMORY_GROUP = 0; // 根组不限制，不能删除
+
+struct MemoryGroup {
+    int id;
+    std::string name;
+    uint64_t hard_limit;          // 0 表示不限制；超出时拒绝分配
+    uint64_t soft_limit;          // 0 表示不限制；超出时仍允许分配，但组内进程优先被 OOM killer 选中
+    uint64_t usage;
+    uint64_t peak;
+    uint64_t failures;            // 因硬限制被拒绝的分配次数
+    uint64_t soft_limit_breaches; // 分配使用量越过软限制的次数
+    std::set<ProcessID> members;
+
+    bool over_soft_limit() const { return soft_limit != 0 && usage > soft_limit; }
+};
+
+// 共享内存段
+struct SharedMemorySegment {
+    int id;
+    uint64_t size;                             // 字节数（按页向上取整）
+    std::vector<uint64_t> frames;              // 段独占的物理页框，不参与页面置换
+    std::map<ProcessID, uint64_t> attachments; // 进程 -> 映射到的虚拟起始地址
+    bool removed;                              // 已标记删除，最后一个进程分离后释放
 };
 
 class MemoryManager {
 public:
-    MemoryManager();
+    explicit MemoryManager(MemoryBackingMode backing_mode = MemoryBackingMode::LAZY);
     ~MemoryManager();
 
     // 初始化内存管理器
@@ -65,19 +234,63 @@ public:
     bool free(uint64_t base_address, uint64_t size);
     bool free_process_memory(ProcessID pid);
 
+    // 连续分配的放置策略
+    void set_placement_policy(PlacementPolicy policy);
+    PlacementPolicy get_placement_policy() const;
+
+    // 分区布局（按顺序从地址 0 开始连续排布）；有分区被占用或总大小超出内存时返回 false
+    bool set_partition_layout(const std::vector<PartitionSpec>& layout);
+    const std::vector<PartitionSpec>& get_partition_layout() const;
+
+    // 连续分配的在线紧凑：每步把紧接在最低空闲块之后的已分配块下移到空闲块起点，
+    // 本步移动的字节数达到 max_bytes 后停止（至少移动一个块），返回移动的字节数
+    uint64_t compact(uint64_t max_bytes);
+    bool is_compacted() const; // 空闲空间已全部位于已分配块之上
+    // 注册后，连续分配失败而空闲总量足够时先完整紧凑再重试
+    void set_relocation_callback(RelocationCallback callback);
+    FragmentationStats get_fragmentation_stats() const;
+
+    // 分配策略迁移：先在新策略下为所有进程预先分配，全部成功后一次性释放旧分配并切换策略，
+    // 任一进程失败则释放已预分配的部分，旧分配保持不变。预分配按步推进，期间新建或释放的进程
+    // 同步加入或移出计划。已有迁移在进行或目标与当前策略相同时返回 false
+    bool begin_strategy_migration(MemoryAllocationStrategy target, const std::vector<MigrationEntry>& processes);
+    // 最多为 max_processes 个进程预先分配，全部完成后提交
+    const MigrationStatus& step_strategy_migration(size_t max_processes);
+    bool abort_strategy_migration();
+    const MigrationStatus& get_migration_status() const;
+    // 提交后 new_block 为各进程在新策略下的内存块
+    const std::vector<MigrationEntry>& get_migration_entries() const;
+
     // 获取内存使用情况 (for UI)
-    const std::list<FreeBlock>& get_free_blocks() const;
-    std::vector<Partition> get_partitions() const;
+    const FreeBlockIndex& get_free_blocks() const;
+    const std::vector<Partition>& get_partitions() const;
     uint64_t get_total_memory() const;
     uint64_t get_used_memory() const;
     uint64_t get_free_memory() const;
+    // LAZY 模式下只有写入过的区间可以通过该指针直接访问
     char* get_memory_pool_ptr();
 
+    // 后备存储信息：预留的地址空间与实际提交的字节数
+    MemoryBackingMode get_backing_mode() const;
+    uint64_t get_reserved_memory() const;
+    uint64_t get_committed_memory() const;
+
     // 内存读写操作（用于文件系统等）
     std::string read_memory(uint64_t address, size_t size) const;
     void read_memory(uint64_t address, void* buffer, size_t size) const;
     void write_memory(uint64_t address, const std::string& data);
     void write_memory(uint64_t address, const void* data, size_t size);
+    // 按进程虚拟地址写入；地址无效时抛出 std::runtime_error
+    void write_memory(ProcessID pid, uint64_t virtual_address, const void* data, size_t size);
+
+    // 按进程虚拟地址读写：每页只转换一次，物理上连续的页合并为一次批量复制；
+    // 写入共享页面时先复制出私有副本。地址无效时返回 false，此前的部分可能已经复制
+    bool read_virtual(ProcessID pid, uint64_t virtual_address, void* buffer, size_t size);
+    bool write_virtual(ProcessID pid, uint64_t virtual_address, const void* data, size_t size);
+    // 分散/聚集读写，按顺序处理每个区段，返回成功复制的字节数
+    size_t readv_virtual(ProcessID pid, const std::vector<VirtualIoVec>& iov);
+    size_t writev_virtual(ProcessID pid, const std::vector<VirtualIoVec>& iov);
+    uint64_t get_virtual_copy_runs() const; // 分页模式下累计的批量复制次数
 
     // 获取进程起始地址
     uint64_t get_process_base_address(ProcessID pid) const;
@@ -85,35 +298,322 @@ public:
     // 分页管理相关
     bool allocate_pages_for_process(ProcessID pid, uint64_t size);
     bool free_pages_for_process(ProcessID pid);
-    std::optional<uint64_t> translate_virtual_to_physical(ProcessID pid, uint64_t virtual_address) const;
+    // 地址转换即一次访问：设置访问位（写访问同时设置脏位），请求调页下缺页时调入页面
+    std::optional<uint64_t> translate_virtual_to_physical(ProcessID pid, uint64_t virtual_address, bool is_write = false);
+
+    // 请求调页：开启后分页分配只建立非驻留的页表项，首次访问时触发缺页
+    void set_demand_paging(bool enabled);
+    bool is_demand_paging() const;
+    // 分页可使用的物理页框上限（0 表示不限制），达到上限后按置换策略换出页面
+    void set_physical_frame_limit(uint64_t frames);
+    uint64_t get_physical_frame_limit() const;
+    void set_page_replacement_policy(PageReplacementPolicy policy);
+    PageReplacementPolicy get_page_replacement_policy() const;
+    // OPT 使用的未来访问序列，之后的每次地址转换依次对应其中一项
+    void set_reference_trace(const std::vector<ResidentPage>& trace);
+    PageFaultStats get_page_fault_stats(ProcessID pid) const;
+    const PageFaultStats& get_total_page_fault_stats() const;
+    void reset_page_fault_stats(); // 同时清零 TLB 统计
+
+    // 大页：开启后非请求调页的分页分配中，按 2MB 对齐的虚拟区间优先使用对齐的 512 个连续页框，
+    // 一个页表项、一个 TLB 表项覆盖 2MB。大页常驻内存，不参与页面置换；fork 前拆分为普通页
+    void set_huge_pages(bool enabled);
+    bool is_huge_pages() const;
+    // 后台合并：扫描下一个进程，把页框全部私有、驻留的 2MB 对齐区间合并为大页，
+    // 最多合并 max_promotions 个，返回合并的大页数
+    size_t promote_huge_pages(size_t max_promotions);
+    HugePageStats get_huge_page_stats() const;
+
+    // 相同页面合并（仅分页模式）：后台按页框号顺序扫描私有页框，对内容做哈希，
+    // 内容相同的页面合并为一个只读的写时复制页框，写入时再复制出私有副本
+    void set_page_merging(bool enabled);
+    bool is_page_merging() const;
+    // 最多扫描 max_frames 个页框，返回本次合并的页面数
+    size_t merge_same_pages(size_t max_frames);
+    PageMergingStats get_page_merging_stats() const;
+
+    // 交换区：挂接后换出的页面写入文件系统预留的磁盘块，未挂接时保存在内存中。
+    // 仍有换出页面时不能挂接或卸下
+    bool attach_swap(FileSystemManager& fs, uint64_t size);
+    bool detach_swap();
+    // 换出的脏页先进入写回队列，由后台步进写入交换区；队列超过上限时同步写回超出的部分
+    size_t pump_swap_writeback(size_t max_pages);
+    void set_writeback_queue_limit(size_t pages);
+    size_t get_writeback_queue_limit() const;
+    SwapStats get_swap_stats() const;
+    // 压缩交换：开启后换出的页面先压缩存入内存中的压缩池，压缩率不足或池已满时才进入写回队列。
+    // 关闭后已存入的页面仍可调入；pool_limit 为 0 表示不限
+    void set_compressed_swap(bool enabled);
+    bool is_compressed_swap() const;
+    void set_compressed_pool_limit(uint64_t bytes);
+    CompressedSwapStats get_compressed_swap_stats() const;
+
+    // 写时复制 fork：子进程以只读方式共享父进程的全部页框（仅分页模式，子进程不能已有页表）
+    bool fork_address_space(ProcessID parent_pid, ProcessID child_pid);
+    FrameSharingStats get_frame_sharing_stats() const;
+    uint32_t get_frame_refcount(uint64_t frame_number) const;
+    // 反向映射（仅分页模式）：页框 -> 映射它的进程与虚拟页，O(1)；空闲页框与共享内存段的页框返回 nullopt。
+    // 被多个进程共享的页框只记录其中一个映射者，全部映射者由 get_frame_mappers 给出
+    std::optional<ResidentPage> get_frame_owner(uint64_t frame_number) const;
+    std::vector<ResidentPage> get_frame_mappers(uint64_t frame_number) const;
+
+    // 共享内存（仅分页模式）：段的页框同时映射进多个进程的页表，实现零拷贝通信
+    std::optional<int> shm_create(uint64_t size);
+    // 映射到进程虚拟地址空间末尾，返回虚拟起始地址；同一进程重复映射时返回已有地址
+    std::optional<uint64_t> shm_attach(int shmid, ProcessID pid);
+    bool shm_detach(int shmid, ProcessID pid);
+    // 标记删除；仍有进程映射时延迟到最后一个进程分离后释放
+    bool shm_remove(int shmid);
+    const std::map<int, SharedMemorySegment>& get_shared_segments() const;
+
+    // 虚拟内存区域（仅分页模式）：映射只建立区域，页框在首次访问时分配，访问权限在地址转换时检查。
+    // 未给出地址时优先使用地址空间中的空洞，否则映射在顶端；给出的地址须按页对齐且区间空闲
+    std::optional<uint64_t> mmap(ProcessID pid, uint64_t length, uint32_t prot, std::optional<uint64_t> address = std::nullopt);
+    // 撤销区间内的映射并释放页框；区间与共享内存段相交时返回 false
+    bool munmap(ProcessID pid, uint64_t address, uint64_t length);
+    // 区间内每一页都已映射时修改权限
+    bool mprotect(ProcessID pid, uint64_t address, uint64_t length, uint32_t prot);
+    // 设置堆的结束地址并返回新值，new_break 为 0 时只查询；堆不能越过其他映射或低于起点
+    std::optional<uint64_t> brk(ProcessID pid, uint64_t new_break);
+    const VmaTree* get_vmas(ProcessID pid) const;
+    // 文件映射：把文件 [offset, offset + length) 映射进进程地址空间（length 为 0 时到文件末尾，offset 按页对齐）。
+    // 页面在首次访问时读入页缓存，所有映射者共享同一页框；映射期间文件页常驻内存，
+    // 最后一个映射者撤销时脏页写回文件块
+    std::optional<uint64_t> mmap_file(ProcessID pid, FileSystemManager& fs, const std::string& path, uint32_t prot,
+                                      uint64_t offset = 0, uint64_t length = 0, std::optional<uint64_t> address = std::nullopt);
+    // 立即把页缓存中的脏页写回文件，返回写回的页数
+    size_t sync_file_pages();
+    const std::map<int, MappedFile>& get_mapped_files() const; // inode -> 文件
+
+    // 进程堆（仅分页模式）：在 brk 管理的堆区域内分配，返回虚拟地址；堆由 brk 扩大与收缩，
+    // 收缩 brk 时不能截断仍在使用的堆块
+    std::optional<uint64_t> heap_alloc(ProcessID pid, uint64_t size);
+    bool heap_free(ProcessID pid, uint64_t address); // address 不是已分配块的起点时返回 false
+    void set_heap_policy(HeapPolicy policy); // 只影响之后建立的堆
+    HeapPolicy get_heap_policy() const;
+    const HeapAllocator* get_heap(ProcessID pid) const;
+
+    // 之后新建的进程页表使用的结构
+    void set_page_table_layout(PageTableLayout layout);
+    PageTableLayout get_page_table_layout() const;
+    const PageTable* get_page_table(ProcessID pid) const;
+    // 分页模式下进程退出时可以释放的物理内存：私有页框，以及只剩该进程映射的文件页；
+    // 仍被其他进程共享的页框与共享内存段不计入
+    uint64_t get_reclaimable_memory(ProcessID pid);
+    // 释放进程的全部内存后，按当前策略能否满足 size 字节的分配：连续分配看合并后的最大空闲区间
+    // （注册了重定位回调时看空闲总量），分区看最大可用分区，伙伴系统看合并后的最大空闲块
+    bool fits_after_release(ProcessID pid, uint64_t size);
+
+    // 内存控制组：为进程分配、fork 复制地址空间、匿名 mmap 与 brk 增长时按大小记入所属组，
+    // munmap、brk 收缩与进程释放时退还；文件映射与共享内存段不计费。
+    // 未指定组的进程属于根组，fork 的子进程继承父进程的组
+    int create_memory_group(const std::string& name, uint64_t hard_limit, uint64_t soft_limit);
+    bool set_memory_group_limits(int group_id, uint64_t hard_limit, uint64_t soft_limit); // 低于当前用量时只影响之后的分配
+    bool remove_memory_group(int group_id); // 组内还有进程时返回 false
+    // 把进程（可以尚未分配内存）移入组，已有的计费随之转移；目标组的硬限制容纳不下时返回 false
+    bool move_to_memory_group(ProcessID pid, int group_id);
+    int get_memory_group_of(ProcessID pid) const;
+    uint64_t get_memory_charge(ProcessID pid) const;
+    const MemoryGroup* get_memory_group(int group_id) const;
+    const std::map<int, MemoryGroup>& get_memory_groups() const;
+    // 组内再分配 bytes 是否不超过硬限制
+    bool memory_group_fits(int group_id, uint64_t bytes) const;
+    uint64_t get_page_table_memory() const; // 所有进程页表占用的字节数
+    uint64_t get_page_walks() const; // 包括已释放的页表
+
+    // 物理内存布局图：按地址分成 buckets 段，给出各段的占用与主要所有者，开销只与段数有关
+    std::vector<OccupancyBucket> get_occupancy_map(size_t buckets) const;
+
+    // 地址转换前的 TLB（组数为 0 时关闭）；重新配置会清空所有表项
+    bool configure_tlb(size_t sets, size_t ways);
+    const Tlb& get_tlb() const;
 
     // 新增分页统计信息
     uint64_t get_total_pages() const;
     uint64_t get_used_pages() const;
     uint64_t get_free_pages() const;
 
+    // 伙伴系统统计信息
+    const BuddyAllocator& get_buddy_allocator() const;
+    uint64_t get_buddy_internal_fragmentation() const; // 块大小与请求大小之差的总和
+
 private:
-    char* memory_pool; // 模拟内存池
-    std::list<FreeBlock> free_list; // 空闲块链表 (连续分配使用)
+    MemoryBackingMode backing_mode;
+    BackingStore memory_pool; // 模拟内存池
+    FreeBlockIndex free_list; // 空闲块索引 (连续分配使用)
+    PlacementPolicy placement_policy;
     uint64_t used_memory;
     MemoryAllocationStrategy current_strategy;
 
     // 分区分配相关
     std::vector<Partition> partitions;
+    std::vector<PartitionSpec> partition_layout;
+    // 按大小分类的空闲分区（大小 -> 空闲分区下标），只保留非空的类别
+    std::map<uint64_t, std::set<size_t>> free_partitions_by_size;
+    std::unordered_map<ProcessID, std::vector<size_t>> partitions_by_pid; // 进程 -> 占用的分区下标
     void initialize_partitions();
     std::optional<MemoryBlock> allocate_partitioned(ProcessID pid, uint64_t size);
 
     // 分页分配相关
-    std::bitset<TOTAL_PAGES> page_frames; // 页框使用位图
+    FrameBitmap page_frames; // 分层页框使用位图
     std::map<ProcessID, ProcessPageTable> page_tables; // 进程页表
+    PageTableLayout page_table_layout;
+    uint64_t retired_page_walks; // 已释放页表的遍历次数
     std::optional<MemoryBlock> allocate_paged(ProcessID pid, uint64_t size);
     uint64_t allocate_free_frame();
-    void free_frame(uint64_t frame_number);
+    void free_frame(uint64_t frame_number); // 同时清除反向映射
+    // 按页框号索引的反向映射，pid 为 -1 表示没有映射者；按最高的已映射页框扩大
+    std::vector<ResidentPage> frame_owners;
+    void set_frame_owner(uint64_t frame_number, ProcessID pid, uint64_t page_number);
+
+    // 各分配策略共用的占用概要，分配、释放与移动内存块时更新
+    OccupancyMap occupancy;
+
+    // 请求调页相关
+    bool demand_paging;
+    uint64_t frame_limit;
+    PageReplacer page_replacer;
+    std::map<ProcessID, PageFaultStats> fault_stats;
+    PageFaultStats total_fault_stats;
+    ProcessID cached_stats_pid;     // 最近访问进程的统计，TLB 命中路径不必查表
+    PageFaultStats* cached_stats;
+    PageFaultStats& stats_for(ProcessID pid);
+    Tlb tlb;
+    bool copy_virtual(ProcessID pid, uint64_t virtual_address, char* buffer, size_t size, bool is_write);
+    // 非分页模式下 [address, address + size) 是否完整落在进程自己的一个内存块内
+    bool owns_physical_range(ProcessID pid, uint64_t address, uint64_t size) const;
+    uint64_t obtain_frame(); // 达到页框上限时先换出页面；失败时返回 UINT64_MAX
+    PageTableEntry* handle_page_fault(ProcessID pid, uint64_t page_number);
+    bool evict_page();
+
+    // 大页相关
+    bool huge_pages_enabled;
+    uint64_t huge_allocations;
+    uint64_t huge_promotions;
+    uint64_t huge_splits;
+    ProcessID promotion_cursor; // 上一次合并扫描的进程
+    uint64_t allocate_huge_frame(); // 对齐的 512 个页框的首个页框号，受页框上限约束；失败时返回 UINT64_MAX
+    bool promote_huge_page(ProcessPageTable& page_table, uint64_t huge_index);
+    void split_huge_page(ProcessPageTable& page_table, uint64_t huge_index);
+    void split_huge_pages(ProcessPageTable& page_table);
+
+    // 相同页面合并相关：稳定表保存已合并的页框，不稳定表保存本轮扫描中见过的候选页框，每轮扫描后清空
+    bool page_merging_enabled;
+    uint64_t merge_cursor; // 下一个扫描的页框
+    std::unordered_map<uint64_t, uint64_t> merged_frames;       // 页框 -> 内容哈希
+    std::unordered_multimap<uint64_t, uint64_t> merged_by_hash; // 内容哈希 -> 页框
+    std::unordered_map<uint64_t, uint64_t> merge_candidates;    // 内容哈希 -> 页框
+    PageMergingStats merge_stats; // 只维护累计计数
+    bool frames_equal(uint64_t a, uint64_t b);
+    // 把 pid 的 page_number 页改为只读映射 target，原页框释放
+    void merge_page_into(ProcessID pid, uint64_t page_number, uint64_t target);
+    void forget_merged_frame(uint64_t frame_number); // 页框不再被共享时移出稳定表
+
+    // 虚拟内存区域相关
+    ProcessPageTable& page_table_for(ProcessID pid); // 不存在时创建
+    std::optional<uint64_t> place_vma(ProcessPageTable& page_table, Vma vma, std::optional<uint64_t> address);
+    void release_page_range(ProcessPageTable& page_table, uint64_t first_page, uint64_t pages);
+
+    // 文件映射相关
+    std::map<int, MappedFile> mapped_files;
+    std::map<std::pair<int, uint64_t>, CachedFilePage> file_pages;           // (inode, 文件页号) -> 页缓存
+    std::unordered_map<uint64_t, std::pair<int, uint64_t>> file_frame_owner; // 页框 -> 文件页
+    PageTableEntry* fault_file_page(ProcessPageTable& page_table, const Vma& vma, uint64_t page_number);
+    void unmap_file_page(uint64_t frame, ProcessID pid, uint64_t page_number, bool dirty);
+    void write_back_file_page(const std::pair<int, uint64_t>& key, CachedFilePage& page);
+    void refresh_file_mappers(const ProcessPageTable& page_table); // 进程不再映射的文件移出 mappers
+
+    // 交换区相关：换入后交换槽保留，页面再次干净地换出时不必写回
+    SwapArea swap_area;
+    std::map<std::pair<ProcessID, uint64_t>, uint64_t> swapped_pages;          // (进程, 虚拟页号) -> 交换槽
+    std::map<std::pair<ProcessID, uint64_t>, std::string> writeback_pending;   // 尚未写入交换区的换出内容
+    std::deque<std::pair<ProcessID, uint64_t>> writeback_queue;                // 写回顺序，出队时跳过已丢弃的项
+    size_t writeback_queue_limit;
+    uint64_t swap_outs;
+    uint64_t swap_ins;
+    uint64_t swap_queue_hits;
+    uint64_t writebacks_completed;
+    std::chrono::steady_clock::time_point swap_stats_since;
+    CompressedPool compressed_pool;
+    std::map<std::pair<ProcessID, uint64_t>, uint64_t> compressed_pages;       // (进程, 虚拟页号) -> 压缩池句柄
+    bool compressed_swap_enabled;
+    uint64_t compressed_faults;
+    uint64_t compressed_fault_ns;
+    uint64_t disk_faults;
+    uint64_t disk_fault_ns;
+    void store_swapped_page(ProcessID pid, uint64_t page_number, std::string data);
+    bool load_swapped_page(ProcessID pid, uint64_t page_number, void* buffer);
+    bool has_swapped_page(ProcessID pid, uint64_t page_number) const;
+    // 丢弃 [first_page, end_page) 内的换出页面
+    void drop_swapped_pages(ProcessID pid, uint64_t first_page, uint64_t end_page = UINT64_MAX);
+
+    // 写时复制相关：只记录被多个页表项映射的页框，未出现的页框引用计数为 1
+    std::unordered_map<uint64_t, std::vector<ResidentPage>> shared_frames; // 页框 -> 所有映射者
+    uint64_t cow_copies;
+    PageTableEntry* break_copy_on_write(ProcessID pid, uint64_t page_number);
+
+    uint64_t virtual_copy_runs; // copy_virtual 的批量复制次数
+
+    // 共享内存相关
+    std::map<int, SharedMemorySegment> shared_segments;
+    std::unordered_map<uint64_t, int> shm_frame_owner; // 页框 -> 所属共享内存段
+    int next_shm_id;
+
+    // 进程堆相关：分配器管理 [heap_start_page * PAGE_SIZE, program_break)
+    std::unordered_map<ProcessID, HeapAllocator> heaps;
+    HeapPolicy heap_policy;
+
+    // 内存控制组相关
+    std::map<int, MemoryGroup> memory_groups;
+    std::unordered_map<ProcessID, int> process_groups;       // 不在表中的进程属于根组
+    std::unordered_map<ProcessID, uint64_t> process_charges;
+    int next_memory_group_id;
+    bool try_charge(ProcessID pid, uint64_t bytes); // 超出硬限制时记一次失败并返回 false
+    void charge(ProcessID pid, uint64_t bytes);
+    void uncharge(ProcessID pid, uint64_t bytes);
+    void release_memory_group(ProcessID pid); // 退还进程的全部计费并移出组
+    uint64_t charged_bytes(const VmaTree& vmas, uint64_t first_page, uint64_t pages) const; // 区间内计费区域的字节数
+    void unmap_shm_pages(SharedMemorySegment& segment, ProcessID pid, uint64_t virtual_base);
+    void release_shm_if_unused(int shmid);
+    void release_shared_mapping(uint64_t frame, ProcessID pid, uint64_t page_number);
+
+    // 策略迁移相关：[0, migration_cursor) 内的进程已预先分配
+    MigrationStatus migration;
+    std::vector<MigrationEntry> migration_entries;
+    size_t migration_cursor;
+    std::optional<MemoryBlock> allocate_with(MemoryAllocationStrategy strategy, ProcessID pid, uint64_t size);
+    void release_with(MemoryAllocationStrategy strategy, ProcessID pid, const std::vector<MemoryBlock>& blocks);
+    void track_migrating_process(ProcessID pid, uint64_t size, const std::vector<MemoryBlock>& blocks);
+    void forget_migrating_process(ProcessID pid);
 
     // 连续分配相关
-    std::optional<MemoryBlock> allocate_continuous(uint64_t size);
+    struct ContinuousBlock {
+        uint64_t size;
+        ProcessID owner;
+    };
+    std::map<uint64_t, ContinuousBlock> continuous_blocks; // 已分配块：起始地址 -> 块
+    RelocationCallback relocation_callback;
+    uint64_t compacted_blocks;
+    uint64_t compacted_bytes;
+    void move_pool_bytes(uint64_t destination, uint64_t source, uint64_t size);
+    std::optional<MemoryBlock> allocate_continuous(ProcessID pid, uint64_t size);
     bool free_continuous_memory(uint64_t base_address, uint64_t size);
     
     // 分区分配辅助方法
     bool free_partitioned_memory(ProcessID pid);
+
+    // 伙伴系统分配相关
+    struct BuddyBlock {
+        uint64_t base_address;
+        uint64_t block_size;
+        uint64_t requested_size;
+    };
+    BuddyAllocator buddy;
+    std::map<ProcessID, std::vector<BuddyBlock>> buddy_blocks; // 进程 -> 持有的伙伴块
+    std::unordered_map<uint64_t, ProcessID> buddy_owner;       // 块地址 -> 进程
+    uint64_t buddy_allocated_bytes;
+    uint64_t buddy_requested_bytes;
+    std::optional<MemoryBlock> allocate_buddy(ProcessID pid, uint64_t size);
+    bool free_buddy_block(uint64_t base_address);
+    bool free_buddy_memory(ProcessID pid);
 }; 
\ No newline at end of file
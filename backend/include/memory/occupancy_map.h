@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// 内存布局图中的一段
+struct OccupancyBucket {
+    uint64_t base_address;
+    uint64_t size;
+    uint64_t used;             // 已分配的字节数
+    size_t owners;             // 不同所有者的个数
+    ProcessID top_owner;       // 占用最多的所有者，-1 表示不属于任何进程（共享内存段、页缓存）或为空
+    uint64_t top_owner_bytes;
+};
+
+// 物理内存占用概要
+// 把物理内存划分为 REGION_SIZE 大小的区域，各分配策略在分配与释放时增量更新区域内的已用字节数
+// 以及各所有者的字节数。生成布局图时每段只合并所属区域的概要，开销只与区域数有关，
+// 不需要遍历页框位图、分区表或已分配块。
+class OccupancyMap {
+public:
+    static const uint64_t REGION_SIZE = 1024 * 1024;
+
+    explicit OccupancyMap(uint64_t memory_size);
+
+    void reset();
+    // [base, base + size) 记入/移出 owner 名下，可以跨越多个区域
+    void add(uint64_t base, uint64_t size, ProcessID owner);
+    void remove(uint64_t base, uint64_t size, ProcessID owner);
+
+    // 分成 buckets 段（限制在 1 到区域数之间），各段由相邻的整区域组成
+    std::vector<OccupancyBucket> summarize(size_t buckets) const;
+
+    size_t region_count() const { return regions_.size(); }
+    uint64_t used() const { return used_; }
+
+private:
+    struct Region {
+        uint64_t used = 0;
+        std::map<ProcessID, uint64_t> owners; // 所有者 -> 字节数，只保留非零项
+    };
+
+    uint64_t memory_size_;
+    uint64_t used_;
+    std::vector<Region> regions_;
+
+    // 把区间按区域拆开后逐段调用 apply(区域, 字节数)
+    template <typename Fn>
+    void for_each_region(uint64_t base, uint64_t size, Fn apply);
+};
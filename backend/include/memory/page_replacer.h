@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 页面置换策略
+enum class PageReplacementPolicy {
+    FIFO,   // 先进先出：最早调入的页面
+    LRU,    // 最近最少使用
+    CLOCK,  // 时钟（二次机会）：依据页表项的访问位
+    LFU,    // 最不经常使用：访问次数最少，次数相同时淘汰较早调入的页面
+    OPT     // 最佳置换（离线）：依据预先给定的访问序列，淘汰最久不再使用的页面
+};
+
+// 驻留在某个页框中的虚拟页
+struct ResidentPage {
+    ProcessID pid;
+    uint64_t page_number;
+};
+
+// 页面置换器
+// 跟踪请求调页调入的所有驻留页框，同时维护各策略所需的顺序，
+// 因此可以随时切换策略；选择牺牲页的开销除 OPT 外均为 O(1) 或 O(log n)。
+class PageReplacer {
+public:
+    PageReplacer();
+
+    void set_policy(PageReplacementPolicy policy) { policy_ = policy; }
+    PageReplacementPolicy policy() const { return policy_; }
+
+    void clear();
+
+    void insert(uint64_t frame, ProcessID pid, uint64_t page_number);
+    void erase(uint64_t frame);
+    // 页框改由另一个虚拟页代表（共享页框的原映射者退出时），置换顺序不变
+    void retarget(uint64_t frame, ProcessID pid, uint64_t page_number);
+    // 记录一次对驻留页框的访问；设置了访问序列时同时推进 OPT 的序列游标
+    void touch(uint64_t frame);
+
+    // 固定的页框不会被选为牺牲页，直到 unpin_all；用于复制进行中、已转换好地址的页框
+    void pin(uint64_t frame);
+    void unpin_all();
+    // 选出牺牲页框（跳过固定的页框，全部固定时返回空）；CLOCK 通过 test_and_clear_referenced 检查并清除页表项的访问位
+    std::optional<uint64_t> select_victim(const std::function<bool(const ResidentPage&)>& test_and_clear_referenced);
+
+    // OPT 使用的未来访问序列，之后每次 touch 对应序列中的一次访问
+    void set_reference_trace(const std::vector<ResidentPage>& trace);
+    size_t trace_position() const { return trace_cursor_; }
+
+    const ResidentPage* find(uint64_t frame) const;
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        ResidentPage page;
+        std::list<uint64_t>::iterator fifo_pos;
+        std::list<uint64_t>::iterator lru_pos;
+        std::list<uint64_t>::iterator clock_pos;
+        uint64_t frequency;
+        uint64_t load_seq;
+        bool pinned;
+    };
+
+    PageReplacementPolicy policy_;
+    std::unordered_map<uint64_t, Entry> entries_; // 页框 -> 驻留信息
+    std::list<uint64_t> fifo_;  // 按调入顺序
+    std::list<uint64_t> lru_;   // 按最近访问顺序，表头最久未用
+    std::list<uint64_t> clock_; // 环形队列，新页面插在指针之前
+    std::list<uint64_t>::iterator clock_hand_;
+    std::set<std::tuple<uint64_t, uint64_t, uint64_t>> lfu_; // (访问次数, 调入序号, 页框)
+    uint64_t next_load_seq_;
+    std::vector<uint64_t> pinned_; // 可能含已移除的页框，unpin_all 时跳过
+    size_t pinned_count_;
+
+    // OPT：每个虚拟页在访问序列中出现的位置
+    std::map<std::pair<ProcessID, uint64_t>, std::vector<size_t>> trace_positions_;
+    size_t trace_cursor_;
+
+    uint64_t select_clock(const std::function<bool(const ResidentPage&)>& test_and_clear_referenced);
+    uint64_t select_opt() const;
+};
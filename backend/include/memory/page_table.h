@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+// 页表项
+struct PageTableEntry {
+    bool valid;           // 页面是否有效
+    uint64_t frame_number; // 物理页框号
+    bool dirty;           // 脏位
+    bool accessed;        // 访问位
+    bool copy_on_write;   // 与其他进程共享的只读页，首次写入时复制
+    bool huge;            // 2MB 大页，frame_number 为对齐的首个页框
+
+    PageTableEntry() : valid(false), frame_number(0), dirty(false), accessed(false), copy_on_write(false), huge(false) {}
+
+    // 虚拟页实际所在的页框（大页内按页号偏移）
+    uint64_t frame_for(uint64_t page_number) const {
+        return huge ? frame_number + page_number % HUGE_PAGE_FRAMES : frame_number;
+    }
+};
+
+// 页表结构
+enum class PageTableLayout {
+    FLAT,    // 单级线性页表，按最高映射页号稠密分配（32 位虚拟地址）
+    RADIX_2, // 两级页表（10 + 10 位，32 位虚拟地址）
+    RADIX_4  // 四级页表（9 + 9 + 9 + 9 位，48 位虚拟地址）
+};
+
+// 进程页表
+// 只保存有效（驻留）的页表项。多级页表的中间结点和叶结点在首次映射时分配，
+// 结点中的表项全部撤销后立即回收，因此页表占用的内存随驻留页数而不是最高页号增长。
+// 大页表项相当于叶结点上一级的表项，一项覆盖 512 个虚拟页，不占用叶结点。
+class PageTable {
+public:
+    explicit PageTable(PageTableLayout layout = PageTableLayout::FLAT);
+
+    PageTableLayout layout() const { return layout_; }
+    // 可映射的虚拟页数上限
+    uint64_t max_pages() const;
+
+    // 查找有效的页表项（包括覆盖该页的大页表项），不存在时返回 nullptr；每次调用计一次页表遍历
+    PageTableEntry* find(uint64_t page_number);
+    const PageTableEntry* find(uint64_t page_number) const;
+    // 建立映射（按需分配路径上的结点），访问位、脏位与写时复制标记清零
+    PageTableEntry& map(uint64_t page_number, uint64_t frame_number);
+    // 撤销映射并回收变空的结点
+    void unmap(uint64_t page_number);
+    // 大页映射，huge_index 为虚拟页号 / 512；调用方保证范围内没有普通页表项
+    PageTableEntry& map_huge(uint64_t huge_index, uint64_t first_frame);
+    void unmap_huge(uint64_t huge_index);
+    // 遍历所有有效的页表项：先遍历大页表项（以其首个虚拟页号），再按页号顺序遍历普通页表项
+    void for_each(const std::function<void(uint64_t, PageTableEntry&)>& fn);
+
+    uint64_t resident_count() const { return resident_ + huge_.size() * HUGE_PAGE_FRAMES; }
+    uint64_t huge_count() const { return huge_.size(); }
+    uint64_t memory_bytes() const; // 页表结构本身占用的字节数
+    uint64_t walks() const { return walks_; }
+    uint64_t walk_steps() const { return walk_steps_; } // 遍历访问的结点数
+
+private:
+    static constexpr int32_t NIL = -1;
+
+    struct InnerNode {
+        std::vector<int32_t> children;
+        uint32_t live;
+    };
+    struct LeafNode {
+        std::vector<PageTableEntry> entries;
+        uint32_t live;
+    };
+
+    PageTableLayout layout_;
+    std::vector<uint32_t> level_bits_; // 自根向下每级的索引位数，最后一级为叶结点
+    std::vector<PageTableEntry> flat_;
+    std::vector<InnerNode> inner_; // 下标 0 为根结点
+    std::vector<LeafNode> leaves_;
+    std::vector<int32_t> free_inner_;
+    std::vector<int32_t> free_leaves_;
+    std::map<uint64_t, PageTableEntry> huge_; // 大页号 -> 大页表项
+    uint64_t resident_; // 普通页表项数
+    mutable uint64_t walks_;
+    mutable uint64_t walk_steps_;
+
+    uint64_t index_at(uint64_t page_number, size_t level) const;
+    int32_t new_inner(size_t level);
+    int32_t new_leaf();
+    PageTableEntry* walk(uint64_t page_number) const;
+    void for_each_in(int32_t node, size_t level, uint64_t prefix, const std::function<void(uint64_t, PageTableEntry&)>& fn);
+};
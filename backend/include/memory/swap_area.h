@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "frame_bitmap.h"
+
+class FileSystemManager;
+
+// 交换区
+// 挂接到文件系统后在模拟磁盘上预留一段连续的块，每个交换槽对应一块（与页面同大小）；
+// 未挂接时退化为内存中的交换区，容量不限，供没有文件系统的场景（如单元测试）使用。
+class SwapArea {
+public:
+    SwapArea();
+
+    // 预留 slot_count 个磁盘块；已挂接或仍有槽位被占用时返回 false
+    bool attach(FileSystemManager& fs, uint64_t slot_count);
+    // 归还预留的磁盘块；仍有槽位被占用时返回 false
+    bool detach();
+    bool is_attached() const { return fs_ != nullptr; }
+
+    // 没有空闲槽位时返回 std::nullopt
+    std::optional<uint64_t> allocate_slot();
+    void free_slot(uint64_t slot);
+    // 读写整个槽位（一页）
+    void write_slot(uint64_t slot, const void* data);
+    void read_slot(uint64_t slot, void* buffer) const;
+
+    uint64_t capacity() const; // 0 表示容量不限
+    uint64_t used_slots() const;
+    bool has_free_slots(uint64_t count) const;
+
+private:
+    FileSystemManager* fs_;
+    uint32_t first_block_;
+    FrameBitmap slots_; // 挂接时每一位对应一个磁盘块
+
+    // 内存交换区
+    std::unordered_map<uint64_t, std::string> memory_slots_;
+    uint64_t next_memory_slot_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// TLB 统计
+struct TlbStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t flushes = 0;       // 按进程或整体清空的次数
+    uint64_t invalidations = 0; // 被作废的表项数
+};
+
+// 软件 TLB
+// 组相联结构，表项带进程 ID 标记，各进程的表项互不干扰，切换进程无需清空；
+// 组内按最近使用替换。表项缓存页框号与脏位，写入未置脏的页面仍需走页表。
+// 大页表项以大页号为标记，一项覆盖 2MB；普通表项未命中时再查大页表项。
+class Tlb {
+public:
+    static const size_t DEFAULT_SETS = 64;
+    static const size_t DEFAULT_WAYS = 4;
+
+    Tlb();
+
+    // 组数必须是 2 的幂，sets 为 0 表示关闭 TLB；参数无效时返回 false
+    bool configure(size_t sets, size_t ways);
+    bool enabled() const { return sets_ > 0; }
+    size_t sets() const { return sets_; }
+    size_t ways() const { return ways_; }
+
+    // 命中时返回页框号；is_write 且表项未置脏时视为未命中
+    std::optional<uint64_t> lookup(ProcessID pid, uint64_t page_number, bool is_write);
+    // huge 为 true 时 frame_number 为大页的首个页框
+    void insert(ProcessID pid, uint64_t page_number, uint64_t frame_number, bool dirty, bool huge = false);
+    // 作废该页的表项以及覆盖它的大页表项
+    void invalidate(ProcessID pid, uint64_t page_number);
+    void flush(ProcessID pid);
+    void flush_all();
+
+    const TlbStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = TlbStats(); }
+
+private:
+    struct Entry {
+        bool valid = false;
+        bool dirty = false;
+        bool huge = false;
+        ProcessID pid = -1;
+        uint64_t page_number = 0; // 大页表项为大页号
+        uint64_t frame_number = 0;
+        uint64_t last_used = 0;
+    };
+
+    size_t sets_;
+    size_t ways_;
+    std::vector<Entry> entries_; // sets_ * ways_，同一组的表项相邻
+    uint64_t clock_;
+    TlbStats stats_;
+
+    size_t set_index(ProcessID pid, uint64_t page_number) const;
+    Entry* find(ProcessID pid, uint64_t tag, bool huge);
+};
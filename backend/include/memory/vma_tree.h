@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+// 虚拟内存区域的访问权限（可按位组合）
+const uint32_t VMA_PROT_NONE = 0;
+const uint32_t VMA_PROT_READ = 1;
+const uint32_t VMA_PROT_WRITE = 2;
+const uint32_t VMA_PROT_EXEC = 4;
+
+enum class VmaKind {
+    ANONYMOUS,    // 进程创建时的分配与 mmap 的匿名映射
+    HEAP,         // brk 管理的堆
+    SHARED_MEMORY,// 共享内存段，只能通过 shm_detach 撤销
+    FILE          // 映射的文件，页面经页缓存在首次访问时读入
+};
+
+// 虚拟内存区域：[start_page, start_page + pages)
+struct Vma {
+    uint64_t start_page;
+    uint64_t pages;
+    uint32_t prot;
+    VmaKind kind;
+    int shmid; // 共享内存段 ID，其他类型为 -1
+    int file_id = -1;       // 映射的文件（inode 号）
+    uint64_t file_page = 0; // start_page 对应的文件页号
+
+    uint64_t end_page() const { return start_page + pages; }
+};
+
+// 进程的虚拟内存区域集合，按起始页号有序、互不重叠。
+// 插入或修改权限后，与相邻且属性相同的区域合并（共享内存段除外，文件映射要求文件页也连续），
+// 区域数随映射次数而不是页数增长。
+class VmaTree {
+public:
+    // 包含该页的区域，不存在时返回 nullptr
+    const Vma* find(uint64_t page_number) const;
+    // 区间内没有任何区域
+    bool is_free(uint64_t start_page, uint64_t pages) const;
+    // 区间内每一页都属于某个区域
+    bool covers(uint64_t start_page, uint64_t pages) const;
+    // 与区间相交的部分（按区间裁剪）
+    std::vector<Vma> overlapping(uint64_t start_page, uint64_t pages) const;
+    // [0, limit) 内能容纳 pages 页的最低空洞
+    std::optional<uint64_t> find_gap(uint64_t pages, uint64_t limit) const;
+
+    // 与已有区域重叠时返回 false
+    bool insert(const Vma& vma);
+    // 撤销区间，跨越边界的区域被拆分
+    void remove(uint64_t start_page, uint64_t pages);
+    // 修改区间的权限，调用方保证区间已被覆盖
+    void protect(uint64_t start_page, uint64_t pages, uint32_t prot);
+
+    uint64_t end_page() const; // 最高区域的结束页号，没有区域时为 0
+    size_t size() const { return areas_.size(); }
+    const std::map<uint64_t, Vma>& areas() const { return areas_; }
+
+private:
+    std::map<uint64_t, Vma> areas_; // 起始页号 -> 区域
+
+    // 在 page_number 处把区域一分为二（page_number 恰为边界时不变）
+    void split_at(uint64_t page_number);
+    // 与前后相邻区域合并
+    void merge_around(uint64_t start_page);
+};
@@ -30,6 +30,7 @@ public:
     uint64_t creation_time;      // 创建时间（毫秒 since epoch）
     std::string name;            // 进程名称
     ProcessID parent_pid;        // 父进程 ID（-1 表示无父进程 / 系统进程）
+    std::string image_path;      // exec 装入的可执行文件路径，其他方式创建的进程为空
     // 可以添加寄存器等上下文信息
     // ...
 
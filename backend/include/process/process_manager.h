@@ -2,6 +2,7 @@
 
 #include "pcb.h"
 #include "../memory/memory_manager.h"
+#include "../fs/fs_manager.h"
 #include <vector>
 #include <list>
 #include <map>
@@ -14,10 +15,17 @@
 class ProcessManager {
 public:
     explicit ProcessManager(MemoryManager& mem_manager);
+    ~ProcessManager();
 
-    std::optional<ProcessID> create_process(const std::string& name, uint64_t size, uint64_t cpu_time, uint32_t priority, ProcessID parent_pid = -1);
+    // memory_group 为空时，子进程继承父进程的内存控制组，其他进程属于根组
+    std::optional<ProcessID> create_process(const std::string& name, uint64_t size, uint64_t cpu_time, uint32_t priority, ProcessID parent_pid = -1,
+                                            std::optional<int> memory_group = std::nullopt);
     // 旧接口兼容
     std::optional<ProcessID> create_process(uint64_t size) { return create_process(size, 10, 5); }
+    // 从可执行文件（.pubt）创建进程，大小取自文件的 simulated_size，name 为空时取文件名。
+    // 分页模式下映像以只读方式映射、首次访问时装入，同一映像的多个实例共享页缓存中的页框；其他模式按大小一次性分配
+    std::optional<ProcessID> exec_process(FileSystemManager& fs, const std::string& path, const std::string& name, uint64_t cpu_time, uint32_t priority,
+                                          std::optional<int> memory_group = std::nullopt);
     bool terminate_process(ProcessID pid);
     
     // Scheduling
@@ -62,7 +70,25 @@ public:
     struct RelationshipInfo { ProcessID pid1; ProcessID pid2; RelationType type; };
     std::vector<RelationshipInfo> get_all_relationships() const;
 
+    // OOM killer：开启后创建进程因内存不足失败时，在终止后按当前分配策略能容纳请求的进程中
+    // 终止 badness 最高的一个并重试；没有这样的进程时直接失败，不终止任何进程
+    void set_oom_killer(bool enabled);
+    bool is_oom_killer_enabled() const;
+    // 可回收内存（页数）加上按优先级与新近程度折算的页数，越大越先被终止；没有可回收内存时为 0。
+    // 所属内存控制组超出软限制的进程再加上总内存的页数，总是先于其他进程被终止
+    uint64_t oom_badness(ProcessID pid) const;
+    struct OomKill { ProcessID pid; std::string name; uint64_t reclaimable; uint64_t badness; uint64_t requested_size; uint64_t time; };
+    const std::deque<OomKill>& get_oom_kills() const; // 最近的终止记录
+
 private:
+    // 创建 PCB 并加入就绪队列
+    std::shared_ptr<PCB> register_process(ProcessID pid, const std::string& name, const std::vector<MemoryBlock>& memory_info, uint64_t cpu_time, uint32_t priority, ProcessID parent_pid);
+    // 终止进程可以释放的内存
+    uint64_t memory_footprint(const PCB& pcb) const;
+    uint64_t badness_of(const PCB& pcb, uint64_t footprint) const;
+    // 为 requested_size 的分配终止一个进程（protected_pid 除外），没有终止后能容纳请求的进程时返回 false
+    bool oom_kill(uint64_t requested_size, ProcessID protected_pid);
+
     MemoryManager& memory_manager;
     ProcessID next_pid;
     
@@ -77,4 +103,7 @@ private:
 
     // 进程关系映射: pid -> (另一端 pid, 关系类型)
     std::multimap<ProcessID, std::pair<ProcessID, RelationType>> relations_;
+
+    bool oom_killer_enabled_ = false;
+    std::deque<OomKill> oom_kills_;
 }; 
\ No newline at end of file
@@ -29,6 +29,21 @@ std::unique_ptr<DeviceManager> device_manager;
 std::unique_ptr<InterruptManager> interrupt_manager;
 std::unique_ptr<ClockManager> clock_manager;
 
+// 交换区配置：在模拟磁盘上预留的大小，以及每个时钟周期后台写回的页数
+const uint64_t SWAP_AREA_SIZE = 1024ULL * 1024 * 1024; // 1 GB
+const size_t SWAP_WRITEBACK_PER_TICK = 16;
+// 后台策略迁移每个时钟周期预分配的进程数
+const size_t MIGRATION_PROCESSES_PER_TICK = 64;
+// 连续分配的外部碎片指数超过阈值时，每个时钟周期后台紧凑的字节数
+const double COMPACTION_FRAGMENTATION_THRESHOLD = 0.5;
+const uint64_t COMPACTION_BYTES_PER_TICK = 64ULL * 1024 * 1024;
+// 分页模式下每个时钟周期后台合并的大页数上限
+const size_t HUGE_PAGE_PROMOTIONS_PER_TICK = 4;
+// 每个时钟周期相同页面合并扫描的页框数
+const size_t PAGE_MERGE_SCAN_PER_TICK = 256;
+// 按虚拟地址读写时单次请求的字节数上限
+const size_t VIRTUAL_IO_MAX_BYTES = 16 * PAGE_SIZE;
+
 // JSON 转换函数前向声明
 json pcb_to_json(const PCB& pcb);
 
@@ -69,6 +84,231 @@ std::string sched_algo_to_string(SchedulingAlgorithm algo) {
     }
 }
 
+// 连续分配放置策略与字符串互转
+std::optional<PlacementPolicy> string_to_placement_policy(const std::string& s) {
+    if (s == "FIRST_FIT") return PlacementPolicy::FIRST_FIT;
+    if (s == "BEST_FIT") return PlacementPolicy::BEST_FIT;
+    if (s == "WORST_FIT") return PlacementPolicy::WORST_FIT;
+    if (s == "NEXT_FIT") return PlacementPolicy::NEXT_FIT;
+    return std::nullopt;
+}
+
+std::string placement_policy_to_string(PlacementPolicy policy) {
+    switch (policy) {
+        case PlacementPolicy::FIRST_FIT: return "FIRST_FIT";
+        case PlacementPolicy::BEST_FIT: return "BEST_FIT";
+        case PlacementPolicy::WORST_FIT: return "WORST_FIT";
+        case PlacementPolicy::NEXT_FIT: return "NEXT_FIT";
+        default: return "UNKNOWN";
+    }
+}
+
+// 进程堆分配策略与字符串互转
+std::optional<HeapPolicy> string_to_heap_policy(const std::string& s) {
+    if (s == "TLSF") return HeapPolicy::TLSF;
+    if (s == "FIRST_FIT") return HeapPolicy::FIRST_FIT;
+    if (s == "BEST_FIT") return HeapPolicy::BEST_FIT;
+    return std::nullopt;
+}
+
+std::string heap_policy_to_string(HeapPolicy policy) {
+    switch (policy) {
+        case HeapPolicy::TLSF: return "TLSF";
+        case HeapPolicy::FIRST_FIT: return "FIRST_FIT";
+        case HeapPolicy::BEST_FIT: return "BEST_FIT";
+        default: return "UNKNOWN";
+    }
+}
+
+std::optional<PageReplacementPolicy> string_to_replacement_policy(const std::string& s) {
+    if (s == "FIFO") return PageReplacementPolicy::FIFO;
+    if (s == "LRU") return PageReplacementPolicy::LRU;
+    if (s == "CLOCK") return PageReplacementPolicy::CLOCK;
+    if (s == "LFU") return PageReplacementPolicy::LFU;
+    if (s == "OPT") return PageReplacementPolicy::OPT;
+    return std::nullopt;
+}
+
+std::string replacement_policy_to_string(PageReplacementPolicy policy) {
+    switch (policy) {
+        case PageReplacementPolicy::FIFO: return "FIFO";
+        case PageReplacementPolicy::LRU: return "LRU";
+        case PageReplacementPolicy::CLOCK: return "CLOCK";
+        case PageReplacementPolicy::LFU: return "LFU";
+        case PageReplacementPolicy::OPT: return "OPT";
+        default: return "UNKNOWN";
+    }
+}
+
+std::optional<PageTableLayout> string_to_page_table_layout(const std::string& s) {
+    if (s == "FLAT") return PageTableLayout::FLAT;
+    if (s == "RADIX_2") return PageTableLayout::RADIX_2;
+    if (s == "RADIX_4") return PageTableLayout::RADIX_4;
+    return std::nullopt;
+}
+
+std::string page_table_layout_to_string(PageTableLayout layout) {
+    switch (layout) {
+        case PageTableLayout::FLAT: return "FLAT";
+        case PageTableLayout::RADIX_2: return "RADIX_2";
+        case PageTableLayout::RADIX_4: return "RADIX_4";
+        default: return "UNKNOWN";
+    }
+}
+
+// 访问权限以 "rwx" 的子集表示，例如 "rw"、"r"；空字符串表示不可访问
+std::optional<uint32_t> string_to_vma_prot(const std::string& s) {
+    uint32_t prot = VMA_PROT_NONE;
+    for (char c : s) {
+        if (c == 'r') prot |= VMA_PROT_READ;
+        else if (c == 'w') prot |= VMA_PROT_WRITE;
+        else if (c == 'x') prot |= VMA_PROT_EXEC;
+        else if (c != '-') return std::nullopt;
+    }
+    return prot;
+}
+
+std::string vma_prot_to_string(uint32_t prot) {
+    std::string s = "---";
+    if (prot & VMA_PROT_READ) s[0] = 'r';
+    if (prot & VMA_PROT_WRITE) s[1] = 'w';
+    if (prot & VMA_PROT_EXEC) s[2] = 'x';
+    return s;
+}
+
+std::string vma_kind_to_string(VmaKind kind) {
+    switch (kind) {
+        case VmaKind::ANONYMOUS: return "ANONYMOUS";
+        case VmaKind::HEAP: return "HEAP";
+        case VmaKind::SHARED_MEMORY: return "SHARED_MEMORY";
+        case VmaKind::FILE: return "FILE";
+        default: return "UNKNOWN";
+    }
+}
+
+std::string migration_state_to_string(MigrationState state) {
+    switch (state) {
+        case MigrationState::IDLE: return "IDLE";
+        case MigrationState::PLANNING: return "PLANNING";
+        case MigrationState::COMMITTED: return "COMMITTED";
+        case MigrationState::ROLLED_BACK: return "ROLLED_BACK";
+        default: return "UNKNOWN";
+    }
+}
+
+json migration_status_to_json(const MigrationStatus& status) {
+    json data = {
+        {"state", migration_state_to_string(status.state)},
+        {"from_strategy", static_cast<int>(status.from)},
+        {"to_strategy", static_cast<int>(status.to)},
+        {"total_processes", status.total_processes},
+        {"planned_processes", status.planned_processes},
+        {"planned_bytes", status.planned_bytes}
+    };
+    if (status.failed_pid != -1) {
+        data["failed_pid"] = status.failed_pid;
+    }
+    return data;
+}
+
+// 收集所有进程当前的内存块，作为策略迁移的计划
+std::vector<MigrationEntry> collect_migration_entries() {
+    std::vector<MigrationEntry> entries;
+    for (const auto& pcb_ptr : process_manager->get_all_processes()) {
+        uint64_t total_size = 0;
+        for (const auto& blk : pcb_ptr->memory_info) {
+            total_size += blk.size;
+        }
+        entries.push_back({pcb_ptr->pid, total_size, pcb_ptr->memory_info, std::nullopt});
+    }
+    return entries;
+}
+
+// 推进策略迁移；提交时按新策略下的内存块更新各进程的 PCB
+const MigrationStatus& step_memory_migration(size_t max_processes) {
+    bool was_planning = memory_manager->get_migration_status().state == MigrationState::PLANNING;
+    const auto& status = memory_manager->step_strategy_migration(max_processes);
+    if (!was_planning || status.state != MigrationState::COMMITTED) {
+        return status;
+    }
+    for (const auto& entry : memory_manager->get_migration_entries()) {
+        auto pcb_ptr = process_manager->get_process(entry.pid);
+        if (!pcb_ptr || !entry.new_block) {
+            continue;
+        }
+        pcb_ptr->memory_info.clear();
+        pcb_ptr->memory_info.push_back(*entry.new_block);
+        // 对于非连续分配策略，覆盖 base_address 为逻辑首地址
+        if (status.to != MemoryAllocationStrategy::CONTINUOUS) {
+            uint64_t base_addr = memory_manager->get_process_base_address(entry.pid);
+            if (base_addr != UINT64_MAX) {
+                pcb_ptr->memory_info[0].base_address = base_addr;
+            }
+        }
+    }
+    return status;
+}
+
+json fragmentation_stats_to_json(const FragmentationStats& stats) {
+    return {
+        {"free_bytes", stats.free_bytes},
+        {"free_blocks", stats.free_blocks},
+        {"largest_free_block", stats.largest_free_block},
+        {"external_fragmentation", stats.external_fragmentation},
+        {"compacted", memory_manager->is_compacted()},
+        {"compacted_blocks", stats.compacted_blocks},
+        {"compacted_bytes", stats.compacted_bytes}
+    };
+}
+
+json compressed_swap_stats_to_json(const CompressedSwapStats& stats) {
+    const CompressedPoolStats& pool = stats.pool;
+    return {
+        {"enabled", stats.enabled},
+        {"stored_pages", pool.stored_pages},
+        {"compressed_bytes", pool.compressed_bytes},
+        {"pool_bytes", pool.pool_bytes},
+        {"pool_limit", pool.limit},
+        {"compression_ratio", pool.compressed_bytes == 0 ? 0.0 : static_cast<double>(pool.stored_pages * PAGE_SIZE) / pool.compressed_bytes},
+        {"stores", pool.stores},
+        {"loads", pool.loads},
+        {"rejected_incompressible", pool.rejected_incompressible},
+        {"rejected_full", pool.rejected_full},
+        {"compress_time_us", pool.compress_ns / 1000.0},
+        {"decompress_time_us", pool.decompress_ns / 1000.0},
+        {"faults", stats.faults},
+        {"fault_latency_us", stats.faults == 0 ? 0.0 : stats.fault_ns / 1000.0 / stats.faults},
+        {"disk_faults", stats.disk_faults},
+        {"disk_fault_latency_us", stats.disk_faults == 0 ? 0.0 : stats.disk_fault_ns / 1000.0 / stats.disk_faults}
+    };
+}
+
+json swap_stats_to_json(const SwapStats& stats) {
+    return {
+        {"on_disk", stats.on_disk},
+        {"total_slots", stats.total_slots},
+        {"used_slots", stats.used_slots},
+        {"utilization", stats.total_slots == 0 ? 0.0 : static_cast<double>(stats.used_slots) / stats.total_slots},
+        {"pending_writeback", stats.pending_writeback},
+        {"swap_outs", stats.swap_outs},
+        {"swap_ins", stats.swap_ins},
+        {"queue_hits", stats.queue_hits},
+        {"writebacks_completed", stats.writebacks_completed},
+        {"swap_out_rate", stats.swap_out_rate},
+        {"swap_in_rate", stats.swap_in_rate},
+        {"compressed", compressed_swap_stats_to_json(memory_manager->get_compressed_swap_stats())}
+    };
+}
+
+json page_fault_stats_to_json(const PageFaultStats& stats) {
+    return {
+        {"accesses", stats.accesses},
+        {"faults", stats.faults},
+        {"evictions", stats.evictions},
+        {"writebacks", stats.writebacks}
+    };
+}
+
 // 函数：初始化系统状态
 void initialize_system_state() {
     std::cout << "Initializing default system state..." << std::endl;
@@ -165,6 +405,40 @@ std::string format_time_point(const std::chrono::system_clock::time_point& tp) {
     return ss.str();
 }
 
+// 辅助函数：内存内容按十六进制编码，任意字节都能放进 JSON 字符串
+std::string hex_encode(const std::string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char byte : bytes) {
+        hex.push_back(digits[byte >> 4]);
+        hex.push_back(digits[byte & 0x0f]);
+    }
+    return hex;
+}
+
+std::optional<std::string> hex_decode(const std::string& hex) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    if (hex.size() % 2 != 0) {
+        return std::nullopt;
+    }
+    std::string bytes(hex.size() / 2, '\0');
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        int high = nibble(hex[2 * i]);
+        int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return std::nullopt;
+        }
+        bytes[i] = static_cast<char>(high << 4 | low);
+    }
+    return bytes;
+}
+
 int main(int argc, char* argv[]) {
 #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
@@ -185,6 +459,11 @@ int main(int argc, char* argv[]) {
         std::cout << "Initializing FileSystemManager..." << std::endl;
         fs_manager = std::make_unique<FileSystemManager>();
         std::cout << "FileSystemManager initialized." << std::endl;
+        if (memory_manager->attach_swap(*fs_manager, SWAP_AREA_SIZE)) {
+            std::cout << "Swap area attached (" << SWAP_AREA_SIZE / (1024 * 1024) << " MB)." << std::endl;
+        } else {
+            std::cout << "Failed to attach swap area, swapped pages stay in memory." << std::endl;
+        }
 
         std::cout << "Initializing DeviceManager..." << std::endl;
         device_manager = std::make_unique<DeviceManager>();
@@ -234,15 +513,52 @@ int main(int argc, char* argv[]) {
                 uint64_t memory_size = body.at("memory_size");
                 uint64_t cpu_time = body.value("cpu_time", 10);
                 uint32_t priority = body.value("priority", 5);
+                std::optional<int> memory_group;
+                if (body.contains("memory_group")) {
+                    memory_group = body["memory_group"].get<int>();
+                }
+
+                auto pid_opt = process_manager->create_process(name, memory_size, cpu_time, priority, -1, memory_group);
+                if (pid_opt) {
+                    auto pcb = process_manager->get_process(*pid_opt);
+                    res.status = 201;
+                    res.set_content(create_success_response(pcb_to_json(*pcb), "Process created successfully.").dump(), "application/json; charset=utf-8");
+                } else {
+                    res.status = 400;
+                    res.set_content(create_error_response("Insufficient memory to create process, or the memory group does not exist or is at its hard limit.").dump(), "application/json; charset=utf-8");
+                }
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 从可执行文件创建进程
+        svr.Post("/api/v1/processes/exec", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                std::string path = body.at("path").get<std::string>();
+                std::string name = body.value("name", "");
+                uint64_t cpu_time = body.value("cpu_time", 10);
+                uint32_t priority = body.value("priority", 5);
+                std::optional<int> memory_group;
+                if (body.contains("memory_group")) {
+                    memory_group = body["memory_group"].get<int>();
+                }
 
-                auto pid_opt = process_manager->create_process(name, memory_size, cpu_time, priority);
+                if (!fs_manager->get_file_block_map(path)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Executable not found.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                auto pid_opt = process_manager->exec_process(*fs_manager, path, name, cpu_time, priority, memory_group);
                 if (pid_opt) {
                     auto pcb = process_manager->get_process(*pid_opt);
                     res.status = 201;
                     res.set_content(create_success_response(pcb_to_json(*pcb), "Process created successfully.").dump(), "application/json; charset=utf-8");
                 } else {
                     res.status = 400;
-                    res.set_content(create_error_response("Insufficient memory to create process.").dump(), "application/json; charset=utf-8");
+                    res.set_content(create_error_response("Failed to load executable. The file may be empty, memory is insufficient, or the memory group does not exist or is at its hard limit.").dump(), "application/json; charset=utf-8");
                 }
             } catch (const json::exception& e) {
                 res.status = 400;
@@ -316,6 +632,183 @@ int main(int argc, char* argv[]) {
             }
         });
 
+        // 进程虚拟内存区域（仅分页模式）
+        svr.Get(R"(/api/v1/processes/(\d+)/vmas)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            if (!process_manager->get_process(pid)) {
+                res.status = 404;
+                res.set_content(create_error_response("Process not found.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            json data = json::array();
+            if (const VmaTree* vmas = memory_manager->get_vmas(pid)) {
+                for (const auto& [start, vma] : vmas->areas()) {
+                    json area = {
+                        {"start_address", start * PAGE_SIZE},
+                        {"size", vma.pages * PAGE_SIZE},
+                        {"prot", vma_prot_to_string(vma.prot)},
+                        {"kind", vma_kind_to_string(vma.kind)}
+                    };
+                    if (vma.kind == VmaKind::SHARED_MEMORY) {
+                        area["shmid"] = vma.shmid;
+                    }
+                    if (vma.kind == VmaKind::FILE) {
+                        area["path"] = memory_manager->get_mapped_files().at(vma.file_id).path;
+                        area["file_offset"] = vma.file_page * PAGE_SIZE;
+                    }
+                    data.push_back(area);
+                }
+            }
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Post(R"(/api/v1/processes/(\d+)/mmap)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                auto prot = string_to_vma_prot(body.value("prot", "rw"));
+                if (!prot) {
+                    res.status = 400;
+                    res.set_content(create_error_response("Invalid prot. Must be a combination of 'r', 'w' and 'x'.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                if (!process_manager->get_process(pid)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Process not found.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                std::optional<uint64_t> hint;
+                if (body.contains("address")) {
+                    hint = body["address"].get<uint64_t>();
+                }
+                if (body.contains("path")) {
+                    // 文件映射：length 省略时映射到文件末尾
+                    std::string path = body["path"].get<std::string>();
+                    uint64_t offset = body.value("offset", static_cast<uint64_t>(0));
+                    uint64_t length = body.value("length", static_cast<uint64_t>(0));
+                    auto address = memory_manager->mmap_file(pid, *fs_manager, path, *prot, offset, length, hint);
+                    if (!address) {
+                        res.status = 409;
+                        res.set_content(create_error_response("Failed to map file. Requires PAGED strategy, an existing file, a page-aligned offset within the file and a free page-aligned range.").dump(), "application/json; charset=utf-8");
+                        return;
+                    }
+                    json data = {{"pid", pid}, {"address", *address}, {"path", path}, {"offset", offset}, {"prot", vma_prot_to_string(*prot)}};
+                    res.set_content(create_success_response(data, "File mapped.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                uint64_t length = body.at("length").get<uint64_t>();
+                auto address = memory_manager->mmap(pid, length, *prot, hint);
+                if (!address) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Failed to map memory. Requires PAGED strategy, a positive length and a free page-aligned range.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"pid", pid}, {"address", *address}, {"length", length}, {"prot", vma_prot_to_string(*prot)}};
+                res.set_content(create_success_response(data, "Memory mapped.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post(R"(/api/v1/processes/(\d+)/munmap)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                uint64_t address = body.at("address").get<uint64_t>();
+                uint64_t length = body.at("length").get<uint64_t>();
+                if (!memory_manager->munmap(pid, address, length)) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Failed to unmap memory. The range must be page-aligned and must not overlap a shared memory segment.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                res.set_content(create_success_response({{"pid", pid}, {"address", address}, {"length", length}}, "Memory unmapped.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post(R"(/api/v1/processes/(\d+)/mprotect)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                auto prot = string_to_vma_prot(body.at("prot").get<std::string>());
+                if (!prot) {
+                    res.status = 400;
+                    res.set_content(create_error_response("Invalid prot. Must be a combination of 'r', 'w' and 'x'.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                uint64_t address = body.at("address").get<uint64_t>();
+                uint64_t length = body.at("length").get<uint64_t>();
+                if (!memory_manager->mprotect(pid, address, length, *prot)) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Failed to change protection. Every page in the page-aligned range must be mapped.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"pid", pid}, {"address", address}, {"length", length}, {"prot", vma_prot_to_string(*prot)}};
+                res.set_content(create_success_response(data, "Protection changed.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post(R"(/api/v1/processes/(\d+)/brk)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                if (!process_manager->get_process(pid)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Process not found.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                auto program_break = memory_manager->brk(pid, body.value("break", static_cast<uint64_t>(0)));
+                if (!program_break) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Failed to move the program break. Requires PAGED strategy; the heap cannot shrink below its start or grow into another mapping.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                res.set_content(create_success_response({{"pid", pid}, {"break", *program_break}}).dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // OOM killer：配置、各进程的 badness 与最近的终止记录
+        svr.Get("/api/v1/processes/oom", [&](const httplib::Request&, httplib::Response& res) {
+            json scores = json::array();
+            for (const auto& proc : process_manager->get_all_processes()) {
+                scores.push_back({{"pid", proc->pid}, {"name", proc->name}, {"badness", process_manager->oom_badness(proc->pid)}});
+            }
+            json kills = json::array();
+            for (const auto& kill : process_manager->get_oom_kills()) {
+                kills.push_back({
+                    {"pid", kill.pid},
+                    {"name", kill.name},
+                    {"reclaimable", kill.reclaimable},
+                    {"badness", kill.badness},
+                    {"requested_size", kill.requested_size},
+                    {"time", kill.time}
+                });
+            }
+            json data = {{"enabled", process_manager->is_oom_killer_enabled()}, {"scores", scores}, {"kills", kills}};
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Put("/api/v1/processes/oom", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                process_manager->set_oom_killer(body.at("enabled").get<bool>());
+                json data = {{"enabled", process_manager->is_oom_killer_enabled()}};
+                res.set_content(create_success_response(data, "OOM killer updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
         // 创建进程关系（同步/互斥）
         svr.Post("/api/v1/processes/relationship", [&](const httplib::Request& req, httplib::Response& res) {
             try {
@@ -358,6 +851,17 @@ int main(int argc, char* argv[]) {
 
         // --- 调度器 API ---
         svr.Post("/api/v1/scheduler/tick", [&](const httplib::Request&, httplib::Response& res) {
+            // 每个时钟周期推进一次后台写回
+            memory_manager->pump_swap_writeback(SWAP_WRITEBACK_PER_TICK);
+            step_memory_migration(MIGRATION_PROCESSES_PER_TICK);
+            if (memory_manager->get_allocation_strategy() == MemoryAllocationStrategy::CONTINUOUS &&
+                memory_manager->get_fragmentation_stats().external_fragmentation > COMPACTION_FRAGMENTATION_THRESHOLD) {
+                memory_manager->compact(COMPACTION_BYTES_PER_TICK);
+            }
+            if (memory_manager->get_allocation_strategy() == MemoryAllocationStrategy::PAGED) {
+                memory_manager->promote_huge_pages(HUGE_PAGE_PROMOTIONS_PER_TICK);
+                memory_manager->merge_same_pages(PAGE_MERGE_SCAN_PER_TICK);
+            }
             auto scheduled_proc = process_manager->schedule();
             if (scheduled_proc) {
                 res.set_content(create_success_response(pcb_to_json(*scheduled_proc)).dump(), "application/json; charset=utf-8");
@@ -421,6 +925,13 @@ int main(int argc, char* argv[]) {
             json data;
             data["total_memory"] = memory_manager->get_total_memory();
             data["used_memory"] = memory_manager->get_used_memory();
+
+            // 后备存储：预留的地址空间与实际提交的物理内存
+            json backing;
+            backing["mode"] = memory_manager->get_backing_mode() == MemoryBackingMode::LAZY ? "LAZY" : "EAGER";
+            backing["reserved_bytes"] = memory_manager->get_reserved_memory();
+            backing["committed_bytes"] = memory_manager->get_committed_memory();
+            data["backing"] = backing;
             
             // 根据当前分配策略返回不同的内存信息
             auto strategy = memory_manager->get_allocation_strategy();
@@ -432,6 +943,8 @@ int main(int argc, char* argv[]) {
                     free_blocks.push_back({{"base_address", block.base_address}, {"size", block.size}});
                 }
                 data["free_blocks"] = free_blocks;
+                data["placement_policy"] = placement_policy_to_string(memory_manager->get_placement_policy());
+                data["fragmentation"] = fragmentation_stats_to_json(memory_manager->get_fragmentation_stats());
             } else if (strategy == MemoryAllocationStrategy::PARTITIONED) {
                 json partitions = json::array();
                 for (const auto& partition : memory_manager->get_partitions()) {
@@ -443,15 +956,78 @@ int main(int argc, char* argv[]) {
                     partitions.push_back(p);
                 }
                 data["partitions"] = partitions;
+            } else if (strategy == MemoryAllocationStrategy::BUDDY) {
+                // 伙伴系统，返回各阶空闲块数量
+                const auto& buddy = memory_manager->get_buddy_allocator();
+                json orders = json::array();
+                for (uint32_t order = 0; order <= buddy.max_order(); ++order) {
+                    orders.push_back({
+                        {"order", order},
+                        {"block_size", buddy.min_block() << order},
+                        {"free_blocks", buddy.free_block_count(order)}
+                    });
+                }
+                json buddy_info;
+                buddy_info["free_areas"] = orders;
+                buddy_info["largest_free_block"] = buddy.largest_free_block();
+                buddy_info["internal_fragmentation"] = memory_manager->get_buddy_internal_fragmentation();
+                data["buddy"] = buddy_info;
             } else {
                 // 分页策略，返回页框使用情况
                 json paging;
                 paging["total_pages"] = memory_manager->get_total_pages();
                 paging["used_pages"]  = memory_manager->get_used_pages();
                 paging["free_pages"]  = memory_manager->get_free_pages();
+                paging["demand_paging"] = memory_manager->is_demand_paging();
+                paging["frame_limit"] = memory_manager->get_physical_frame_limit();
+                paging["replacement_policy"] = replacement_policy_to_string(memory_manager->get_page_replacement_policy());
+                paging["faults"] = page_fault_stats_to_json(memory_manager->get_total_page_fault_stats());
+                paging["page_table_layout"] = page_table_layout_to_string(memory_manager->get_page_table_layout());
+                paging["page_table_bytes"] = memory_manager->get_page_table_memory();
+                paging["page_walks"] = memory_manager->get_page_walks();
+                auto sharing = memory_manager->get_frame_sharing_stats();
+                paging["sharing"] = {
+                    {"shared_frames", sharing.shared_frames},
+                    {"private_frames", sharing.private_frames},
+                    {"shm_frames", sharing.shm_frames},
+                    {"file_frames", sharing.file_frames},
+                    {"shared_mappings", sharing.shared_mappings},
+                    {"cow_copies", sharing.cow_copies}
+                };
+                const auto& tlb = memory_manager->get_tlb();
+                const auto& tlb_stats = tlb.stats();
+                uint64_t lookups = tlb_stats.hits + tlb_stats.misses;
+                paging["tlb"] = {
+                    {"sets", tlb.sets()},
+                    {"ways", tlb.ways()},
+                    {"hits", tlb_stats.hits},
+                    {"misses", tlb_stats.misses},
+                    {"flushes", tlb_stats.flushes},
+                    {"invalidations", tlb_stats.invalidations},
+                    {"hit_rate", lookups == 0 ? 0.0 : static_cast<double>(tlb_stats.hits) / lookups}
+                };
+                auto huge = memory_manager->get_huge_page_stats();
+                paging["huge_pages"] = {
+                    {"enabled", memory_manager->is_huge_pages()},
+                    {"mapped", huge.huge_pages},
+                    {"allocations", huge.allocations},
+                    {"promotions", huge.promotions},
+                    {"splits", huge.splits}
+                };
+                auto merging = memory_manager->get_page_merging_stats();
+                paging["page_merging"] = {
+                    {"enabled", memory_manager->is_page_merging()},
+                    {"pages_scanned", merging.pages_scanned},
+                    {"full_scans", merging.full_scans},
+                    {"merges", merging.merges},
+                    {"merged_frames", merging.merged_frames},
+                    {"pages_sharing", merging.pages_sharing},
+                    {"bytes_saved", merging.bytes_saved}
+                };
 
                 data["paging"] = paging;
             }
+            data["swap"] = swap_stats_to_json(memory_manager->get_swap_stats());
             
             res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
         });
@@ -466,9 +1042,9 @@ int main(int argc, char* argv[]) {
                 }
 
                 int strategy_int = body["strategy"];
-                if (strategy_int < 0 || strategy_int > 2) {
+                if (strategy_int < 0 || strategy_int > 3) {
                     res.status = 400;
-                    res.set_content(create_error_response("Invalid strategy value. Must be 0(CONTINUOUS), 1(PARTITIONED), or 2(PAGED).").dump(), "application/json; charset=utf-8");
+                    res.set_content(create_error_response("Invalid strategy value. Must be 0(CONTINUOUS), 1(PARTITIONED), 2(PAGED), or 3(BUDDY).").dump(), "application/json; charset=utf-8");
                     return;
                 }
 
@@ -486,50 +1062,18 @@ int main(int argc, char* argv[]) {
                     return;
                 }
 
-                // Step 1: 收集现有进程的内存需求并释放旧内存
-                struct ProcInfo { ProcessID pid; uint64_t size; };
-                std::vector<ProcInfo> proc_infos;
-                for (const auto& pcb_ptr : process_manager->get_all_processes()) {
-                    uint64_t total_size = 0;
-                    for (const auto& blk : pcb_ptr->memory_info) {
-                        total_size += blk.size;
-                    }
-                    proc_infos.push_back({pcb_ptr->pid, total_size});
-
-                    // 根据旧策略释放内存
-                    if (old_strategy == MemoryAllocationStrategy::CONTINUOUS) {
-                        for (const auto& blk : pcb_ptr->memory_info) {
-                            memory_manager->free(blk.base_address, blk.size);
-                        }
-                    } else {
-                        memory_manager->free_process_memory(pcb_ptr->pid);
-                    }
+                // 先在新策略下为所有进程预先分配，全部成功后才释放旧内存并切换策略
+                if (!memory_manager->begin_strategy_migration(requested_strategy, collect_migration_entries())) {
+                    res.status = 409;
+                    res.set_content(create_error_response("A memory strategy migration is already in progress.").dump(), "application/json; charset=utf-8");
+                    return;
                 }
-
-                // Step 2: 切换策略
-                memory_manager->set_allocation_strategy(requested_strategy);
-
-                // Step 3: 为每个进程重新分配内存并更新 PCB
-                for (auto& info : proc_infos) {
-                    auto blk_opt = memory_manager->allocate_for_process(info.pid, info.size);
-                    if (!blk_opt) {
-                        res.status = 500;
-                        res.set_content(create_error_response("Failed to re-allocate memory for process " + std::to_string(info.pid)).dump(), "application/json; charset=utf-8");
-                        return;
-                    }
-
-                    auto pcb_ptr = process_manager->get_process(info.pid);
-                    if (pcb_ptr) {
-                        pcb_ptr->memory_info.clear();
-                        pcb_ptr->memory_info.push_back(*blk_opt);
-                        // 对于非连续分配策略，覆盖 base_address 为逻辑首地址
-                        if (requested_strategy != MemoryAllocationStrategy::CONTINUOUS) {
-                            uint64_t base_addr = memory_manager->get_process_base_address(info.pid);
-                            if (base_addr != UINT64_MAX) {
-                                pcb_ptr->memory_info[0].base_address = base_addr;
-                            }
-                        }
-                    }
+                const auto& migration = step_memory_migration(SIZE_MAX);
+                if (migration.state != MigrationState::COMMITTED) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Failed to allocate memory for process " + std::to_string(migration.failed_pid) +
+                                                          " under the new strategy; the previous allocation is kept.").dump(), "application/json; charset=utf-8");
+                    return;
                 }
 
                 json data = {
@@ -543,6 +1087,641 @@ int main(int argc, char* argv[]) {
             }
         });
 
+        // 分步迁移分配策略：开始后由调度时钟或 step 接口推进，期间其他请求照常处理
+        svr.Get("/api/v1/memory/migration", [&](const httplib::Request&, httplib::Response& res) {
+            res.set_content(create_success_response(migration_status_to_json(memory_manager->get_migration_status())).dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Post("/api/v1/memory/migration", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                int strategy_int = body.at("strategy").get<int>();
+                if (strategy_int < 0 || strategy_int > 3) {
+                    res.status = 400;
+                    res.set_content(create_error_response("Invalid strategy value. Must be 0(CONTINUOUS), 1(PARTITIONED), 2(PAGED), or 3(BUDDY).").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                if (!memory_manager->begin_strategy_migration(static_cast<MemoryAllocationStrategy>(strategy_int), collect_migration_entries())) {
+                    res.status = 409;
+                    res.set_content(create_error_response("A migration is already in progress or the strategy is unchanged.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                res.set_content(create_success_response(migration_status_to_json(memory_manager->get_migration_status()), "Memory strategy migration started.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post("/api/v1/memory/migration/step", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                size_t max_processes = MIGRATION_PROCESSES_PER_TICK;
+                if (!req.body.empty()) {
+                    max_processes = json::parse(req.body).value("max_processes", max_processes);
+                }
+                const auto& status = step_memory_migration(max_processes);
+                res.set_content(create_success_response(migration_status_to_json(status)).dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Delete("/api/v1/memory/migration", [&](const httplib::Request&, httplib::Response& res) {
+            if (!memory_manager->abort_strategy_migration()) {
+                res.status = 409;
+                res.set_content(create_error_response("No memory strategy migration in progress.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            res.set_content(create_success_response(migration_status_to_json(memory_manager->get_migration_status()), "Memory strategy migration rolled back.").dump(), "application/json; charset=utf-8");
+        });
+
+        // 连续分配的紧凑：移动 max_bytes 字节（至少一个块）后返回，可反复调用直至完成
+        svr.Post("/api/v1/memory/compact", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                uint64_t max_bytes = UINT64_MAX;
+                if (!req.body.empty()) {
+                    max_bytes = json::parse(req.body).value("max_bytes", max_bytes);
+                }
+                if (memory_manager->get_allocation_strategy() != MemoryAllocationStrategy::CONTINUOUS) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Compaction is only available for CONTINUOUS allocation.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                uint64_t moved = memory_manager->compact(max_bytes);
+                json data = fragmentation_stats_to_json(memory_manager->get_fragmentation_stats());
+                data["moved_bytes"] = moved;
+                res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 设置连续分配的放置策略
+        svr.Put("/api/v1/memory/placement", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                std::string policy_str = body.at("policy");
+                auto policy_opt = string_to_placement_policy(policy_str);
+                if (!policy_opt) {
+                    res.status = 400;
+                    res.set_content(create_error_response("Invalid placement policy. Must be FIRST_FIT, BEST_FIT, WORST_FIT or NEXT_FIT.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                auto old_policy = memory_manager->get_placement_policy();
+                memory_manager->set_placement_policy(*policy_opt);
+                json data = {
+                    {"old_policy", placement_policy_to_string(old_policy)},
+                    {"new_policy", policy_str}
+                };
+                res.set_content(create_success_response(data, "Placement policy updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 设置之后新建的进程堆使用的分配策略
+        svr.Put("/api/v1/memory/heap", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                std::string policy_str = body.at("policy");
+                auto policy_opt = string_to_heap_policy(policy_str);
+                if (!policy_opt) {
+                    res.status = 400;
+                    res.set_content(create_error_response("Invalid heap policy. Must be TLSF, FIRST_FIT or BEST_FIT.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                auto old_policy = memory_manager->get_heap_policy();
+                memory_manager->set_heap_policy(*policy_opt);
+                json data = {
+                    {"old_policy", heap_policy_to_string(old_policy)},
+                    {"new_policy", policy_str}
+                };
+                res.set_content(create_success_response(data, "Heap policy updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 配置请求调页
+        svr.Put("/api/v1/memory/paging", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                std::optional<PageReplacementPolicy> policy_opt;
+                if (body.contains("replacement_policy")) {
+                    policy_opt = string_to_replacement_policy(body["replacement_policy"].get<std::string>());
+                    if (!policy_opt) {
+                        res.status = 400;
+                        res.set_content(create_error_response("Invalid replacement policy. Must be FIFO, LRU, CLOCK, LFU or OPT.").dump(), "application/json; charset=utf-8");
+                        return;
+                    }
+                }
+                std::optional<PageTableLayout> layout_opt;
+                if (body.contains("page_table_layout")) {
+                    layout_opt = string_to_page_table_layout(body["page_table_layout"].get<std::string>());
+                    if (!layout_opt) {
+                        res.status = 400;
+                        res.set_content(create_error_response("Invalid page table layout. Must be FLAT, RADIX_2 or RADIX_4.").dump(), "application/json; charset=utf-8");
+                        return;
+                    }
+                }
+                if (body.contains("tlb")) {
+                    const auto& tlb = body["tlb"];
+                    if (!memory_manager->configure_tlb(tlb.at("sets").get<size_t>(), tlb.at("ways").get<size_t>())) {
+                        res.status = 400;
+                        res.set_content(create_error_response("Invalid TLB geometry. 'sets' must be 0 or a power of two and 'ways' must be positive.").dump(), "application/json; charset=utf-8");
+                        return;
+                    }
+                }
+                if (layout_opt) {
+                    memory_manager->set_page_table_layout(*layout_opt);
+                }
+                if (body.contains("demand_paging")) {
+                    memory_manager->set_demand_paging(body["demand_paging"].get<bool>());
+                }
+                if (body.contains("frame_limit")) {
+                    memory_manager->set_physical_frame_limit(body["frame_limit"].get<uint64_t>());
+                }
+                if (body.contains("huge_pages")) {
+                    memory_manager->set_huge_pages(body["huge_pages"].get<bool>());
+                }
+                if (body.contains("page_merging")) {
+                    memory_manager->set_page_merging(body["page_merging"].get<bool>());
+                }
+                if (policy_opt) {
+                    memory_manager->set_page_replacement_policy(*policy_opt);
+                }
+                if (body.contains("reference_trace")) {
+                    // OPT 的访问序列：[{"pid": 1, "address": 4096}, ...]
+                    std::vector<ResidentPage> trace;
+                    for (const auto& item : body["reference_trace"]) {
+                        trace.push_back({item.at("pid").get<ProcessID>(), item.at("address").get<uint64_t>() / PAGE_SIZE});
+                    }
+                    memory_manager->set_reference_trace(trace);
+                }
+                if (body.value("reset_stats", false)) {
+                    memory_manager->reset_page_fault_stats();
+                }
+                json data = {
+                    {"demand_paging", memory_manager->is_demand_paging()},
+                    {"frame_limit", memory_manager->get_physical_frame_limit()},
+                    {"huge_pages", memory_manager->is_huge_pages()},
+                    {"page_merging", memory_manager->is_page_merging()},
+                    {"replacement_policy", replacement_policy_to_string(memory_manager->get_page_replacement_policy())},
+                    {"page_table_layout", page_table_layout_to_string(memory_manager->get_page_table_layout())},
+                    {"tlb", {{"sets", memory_manager->get_tlb().sets()}, {"ways", memory_manager->get_tlb().ways()}}}
+                };
+                res.set_content(create_success_response(data, "Paging configuration updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 交换区：写回队列上限、立即写回与压缩交换
+        svr.Put("/api/v1/memory/swap", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                if (body.contains("compressed")) {
+                    memory_manager->set_compressed_swap(body["compressed"].get<bool>());
+                }
+                if (body.contains("compressed_pool_limit")) {
+                    memory_manager->set_compressed_pool_limit(body["compressed_pool_limit"].get<uint64_t>());
+                }
+                if (body.contains("queue_limit")) {
+                    memory_manager->set_writeback_queue_limit(body["queue_limit"].get<size_t>());
+                }
+                size_t written = 0;
+                if (body.contains("writeback_pages")) {
+                    written = memory_manager->pump_swap_writeback(body["writeback_pages"].get<size_t>());
+                }
+                json data = swap_stats_to_json(memory_manager->get_swap_stats());
+                data["queue_limit"] = memory_manager->get_writeback_queue_limit();
+                data["written"] = written;
+                res.set_content(create_success_response(data, "Swap configuration updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 按访问序列访问进程的虚拟地址（分页模式下逐次地址转换，可能触发缺页）
+        svr.Post("/api/v1/memory/access", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                ProcessID pid = body.at("pid").get<ProcessID>();
+                bool is_write = body.value("is_write", false);
+                auto before = memory_manager->get_page_fault_stats(pid);
+                json physical = json::array();
+                for (const auto& address : body.at("addresses")) {
+                    auto pa = memory_manager->translate_virtual_to_physical(pid, address.get<uint64_t>(), is_write);
+                    if (!pa) {
+                        res.status = 400;
+                        res.set_content(create_error_response("Invalid virtual address " + address.dump() + " for process " + std::to_string(pid) + ".").dump(), "application/json; charset=utf-8");
+                        return;
+                    }
+                    physical.push_back(*pa);
+                }
+                auto after = memory_manager->get_page_fault_stats(pid);
+                json data;
+                data["physical_addresses"] = physical;
+                data["faults"] = after.faults - before.faults;
+                data["process_stats"] = page_fault_stats_to_json(after);
+                res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 按进程虚拟地址读写（分页模式下经过地址转换）
+        svr.Get("/api/v1/memory/virtual", [&](const httplib::Request& req, httplib::Response& res) {
+            if (!req.has_param("pid") || !req.has_param("address") || !req.has_param("size")) {
+                res.status = 400;
+                res.set_content(create_error_response("Missing 'pid', 'address' or 'size' query parameter.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            ProcessID pid;
+            uint64_t address;
+            uint64_t size;
+            try {
+                pid = std::stoi(req.get_param_value("pid"));
+                address = std::stoull(req.get_param_value("address"));
+                size = std::stoull(req.get_param_value("size"));
+            } catch (const std::exception&) {
+                res.status = 400;
+                res.set_content(create_error_response("'pid', 'address' and 'size' must be non-negative integers.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            if (size == 0 || size > VIRTUAL_IO_MAX_BYTES) {
+                res.status = 400;
+                res.set_content(create_error_response("'size' must be between 1 and " + std::to_string(VIRTUAL_IO_MAX_BYTES) + ".").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            std::string buffer(size, '\0');
+            if (!memory_manager->read_virtual(pid, address, &buffer[0], size)) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid virtual address range for process " + std::to_string(pid) + ".").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            json data = {{"pid", pid}, {"address", address}, {"data", hex_encode(buffer)}};
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Put("/api/v1/memory/virtual", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                ProcessID pid = body.at("pid").get<ProcessID>();
+                uint64_t address = body.at("address").get<uint64_t>();
+                auto content = hex_decode(body.at("data").get<std::string>());
+                if (!content || content->empty() || content->size() > VIRTUAL_IO_MAX_BYTES) {
+                    res.status = 400;
+                    res.set_content(create_error_response("'data' must be a hex string of 1 to " + std::to_string(VIRTUAL_IO_MAX_BYTES) + " bytes.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                if (!memory_manager->write_virtual(pid, address, content->data(), content->size())) {
+                    res.status = 400;
+                    res.set_content(create_error_response("Invalid virtual address range for process " + std::to_string(pid) + ".").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"pid", pid}, {"address", address}, {"bytes_written", content->size()}};
+                res.set_content(create_success_response(data, "Memory written.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 物理内存布局图：按段给出占用与主要所有者
+        svr.Get("/api/v1/memory/map", [&](const httplib::Request& req, httplib::Response& res) {
+            size_t buckets = 64;
+            if (req.has_param("buckets")) {
+                try {
+                    buckets = std::stoul(req.get_param_value("buckets"));
+                } catch (const std::exception&) {
+                    res.status = 400;
+                    res.set_content(create_error_response("'buckets' must be a positive integer.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+            }
+            if (buckets == 0) {
+                res.status = 400;
+                res.set_content(create_error_response("'buckets' must be a positive integer.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            json items = json::array();
+            for (const auto& bucket : memory_manager->get_occupancy_map(buckets)) {
+                items.push_back({
+                    {"base_address", bucket.base_address},
+                    {"size", bucket.size},
+                    {"used", bucket.used},
+                    {"owners", bucket.owners},
+                    {"top_owner", bucket.top_owner},
+                    {"top_owner_bytes", bucket.top_owner_bytes}
+                });
+            }
+            json data = {
+                {"allocation_strategy", static_cast<int>(memory_manager->get_allocation_strategy())},
+                {"total_memory", memory_manager->get_total_memory()},
+                {"used_memory", memory_manager->get_used_memory()},
+                {"buckets", items}
+            };
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        // 反向映射：页框的映射者
+        svr.Get(R"(/api/v1/memory/frames/(\d+))", [&](const httplib::Request& req, httplib::Response& res) {
+            uint64_t frame = std::stoull(req.matches[1].str());
+            if (frame >= TOTAL_PAGES) {
+                res.status = 404;
+                res.set_content(create_error_response("Frame number out of range.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            json mappers = json::array();
+            for (const ResidentPage& page : memory_manager->get_frame_mappers(frame)) {
+                mappers.push_back({{"pid", page.pid}, {"virtual_address", page.page_number * PAGE_SIZE}});
+            }
+            json data = {
+                {"frame", frame},
+                {"physical_address", frame * PAGE_SIZE},
+                {"refcount", memory_manager->get_frame_refcount(frame)},
+                {"owner", nullptr},
+                {"mappers", mappers}
+            };
+            if (auto owner = memory_manager->get_frame_owner(frame)) {
+                data["owner"] = {{"pid", owner->pid}, {"virtual_address", owner->page_number * PAGE_SIZE}};
+            }
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        // --- 共享内存 ---
+        svr.Get("/api/v1/memory/shm", [&](const httplib::Request&, httplib::Response& res) {
+            json data = json::array();
+            for (const auto& [id, segment] : memory_manager->get_shared_segments()) {
+                json attachments = json::array();
+                for (const auto& [pid, address] : segment.attachments) {
+                    attachments.push_back({{"pid", pid}, {"virtual_address", address}});
+                }
+                data.push_back({
+                    {"shmid", id},
+                    {"size", segment.size},
+                    {"removed", segment.removed},
+                    {"attachments", attachments}
+                });
+            }
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Post("/api/v1/memory/shm", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                auto shmid = memory_manager->shm_create(body.at("size").get<uint64_t>());
+                if (!shmid) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Failed to create shared memory segment. Requires PAGED strategy, a positive size and enough free frames.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"shmid", *shmid}, {"size", memory_manager->get_shared_segments().at(*shmid).size}};
+                res.set_content(create_success_response(data, "Shared memory segment created.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post(R"(/api/v1/memory/shm/(\d+)/attach)", [&](const httplib::Request& req, httplib::Response& res) {
+            int shmid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                ProcessID pid = body.at("pid").get<ProcessID>();
+                auto address = memory_manager->shm_attach(shmid, pid);
+                if (!address) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Shared memory segment not found, removed, or cannot be mapped.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"shmid", shmid}, {"pid", pid}, {"virtual_address", *address}};
+                res.set_content(create_success_response(data, "Shared memory segment attached.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post(R"(/api/v1/memory/shm/(\d+)/detach)", [&](const httplib::Request& req, httplib::Response& res) {
+            int shmid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                ProcessID pid = body.at("pid").get<ProcessID>();
+                if (!memory_manager->shm_detach(shmid, pid)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Process is not attached to this shared memory segment.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                res.set_content(create_success_response({{"shmid", shmid}, {"pid", pid}}, "Shared memory segment detached.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Delete(R"(/api/v1/memory/shm/(\d+))", [&](const httplib::Request& req, httplib::Response& res) {
+            int shmid = std::stoi(req.matches[1].str());
+            if (!memory_manager->shm_remove(shmid)) {
+                res.status = 404;
+                res.set_content(create_error_response("Shared memory segment not found.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            res.set_content(create_success_response({{"shmid", shmid}}, "Shared memory segment marked for removal.").dump(), "application/json; charset=utf-8");
+        });
+
+        // 内存控制组
+        svr.Get("/api/v1/memory/groups", [&](const httplib::Request&, httplib::Response& res) {
+            json data = json::array();
+            for (const auto& [id, group] : memory_manager->get_memory_groups()) {
+                data.push_back({
+                    {"id", id},
+                    {"name", group.name},
+                    {"hard_limit", group.hard_limit},
+                    {"soft_limit", group.soft_limit},
+                    {"usage", group.usage},
+                    {"peak", group.peak},
+                    {"failures", group.failures},
+                    {"soft_limit_breaches", group.soft_limit_breaches},
+                    {"over_soft_limit", group.over_soft_limit()},
+                    {"members", group.members}
+                });
+            }
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Post("/api/v1/memory/groups", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                std::string name = body.at("name").get<std::string>();
+                uint64_t hard_limit = body.value("hard_limit", static_cast<uint64_t>(0));
+                uint64_t soft_limit = body.value("soft_limit", static_cast<uint64_t>(0));
+                int id = memory_manager->create_memory_group(name, hard_limit, soft_limit);
+                json data = {{"id", id}, {"name", name}, {"hard_limit", hard_limit}, {"soft_limit", soft_limit}};
+                res.status = 201;
+                res.set_content(create_success_response(data, "Memory group created.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Put(R"(/api/v1/memory/groups/(\d+))", [&](const httplib::Request& req, httplib::Response& res) {
+            int id = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                const MemoryGroup* group = memory_manager->get_memory_group(id);
+                if (group == nullptr || id == ROOT_MEMORY_GROUP) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Memory group not found, or it is the root group.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                uint64_t hard_limit = body.value("hard_limit", group->hard_limit);
+                uint64_t soft_limit = body.value("soft_limit", group->soft_limit);
+                memory_manager->set_memory_group_limits(id, hard_limit, soft_limit);
+                json data = {{"id", id}, {"hard_limit", hard_limit}, {"soft_limit", soft_limit}};
+                res.set_content(create_success_response(data, "Memory group updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Delete(R"(/api/v1/memory/groups/(\d+))", [&](const httplib::Request& req, httplib::Response& res) {
+            int id = std::stoi(req.matches[1].str());
+            if (!memory_manager->remove_memory_group(id)) {
+                res.status = 409;
+                res.set_content(create_error_response("Memory group not found, is the root group, or still has processes.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            res.set_content(create_success_response({{"id", id}}, "Memory group removed.").dump(), "application/json; charset=utf-8");
+        });
+
+        svr.Put(R"(/api/v1/processes/(\d+)/memory_group)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                int group_id = body.at("group_id").get<int>();
+                if (!process_manager->get_process(pid)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Process not found.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                if (!memory_manager->move_to_memory_group(pid, group_id)) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Memory group not found, or its hard limit cannot hold the process.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"pid", pid}, {"group_id", group_id}, {"charge", memory_manager->get_memory_charge(pid)}};
+                res.set_content(create_success_response(data, "Process moved to memory group.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        // 进程堆
+        svr.Post(R"(/api/v1/processes/(\d+)/heap/alloc)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                uint64_t size = body.at("size").get<uint64_t>();
+                if (!process_manager->get_process(pid)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("Process not found.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                auto address = memory_manager->heap_alloc(pid, size);
+                if (!address) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Heap allocation failed. Paged allocation is required and the heap must be able to grow.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data = {{"pid", pid}, {"address", *address}, {"size", size}};
+                res.status = 201;
+                res.set_content(create_success_response(data, "Heap block allocated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Post(R"(/api/v1/processes/(\d+)/heap/free)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            try {
+                auto body = json::parse(req.body);
+                uint64_t address = body.at("address").get<uint64_t>();
+                if (!memory_manager->heap_free(pid, address)) {
+                    res.status = 404;
+                    res.set_content(create_error_response("No heap block starts at this address.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                res.set_content(create_success_response({{"pid", pid}, {"address", address}}, "Heap block freed.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
+        svr.Get(R"(/api/v1/processes/(\d+)/heap)", [&](const httplib::Request& req, httplib::Response& res) {
+            ProcessID pid = std::stoi(req.matches[1].str());
+            const HeapAllocator* heap = memory_manager->get_heap(pid);
+            if (heap == nullptr) {
+                res.status = 404;
+                res.set_content(create_error_response("Process has no heap.").dump(), "application/json; charset=utf-8");
+                return;
+            }
+            HeapStats stats = heap->stats();
+            uint64_t free_bytes = stats.capacity - stats.allocated;
+            json data = {
+                {"pid", pid},
+                {"policy", heap_policy_to_string(heap->policy())},
+                {"program_break", *memory_manager->brk(pid, 0)},
+                {"capacity", stats.capacity},
+                {"allocated", stats.allocated},
+                {"requested", stats.requested},
+                {"live_blocks", stats.live_blocks},
+                {"free_blocks", stats.free_blocks},
+                {"largest_free", stats.largest_free},
+                // 外部碎片：空闲空间中不在最大空闲块里的比例
+                {"fragmentation", free_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(stats.largest_free) / free_bytes},
+                {"allocations", stats.allocations},
+                {"frees", stats.frees},
+                {"failures", stats.failures}
+            };
+            res.set_content(create_success_response(data).dump(), "application/json; charset=utf-8");
+        });
+
+        // 配置分区布局
+        svr.Put("/api/v1/memory/partitions", [&](const httplib::Request& req, httplib::Response& res) {
+            try {
+                auto body = json::parse(req.body);
+                std::vector<PartitionSpec> layout;
+                for (const auto& item : body.at("layout")) {
+                    layout.push_back({item.at("size").get<uint64_t>(), item.at("count").get<uint32_t>()});
+                }
+                if (!memory_manager->set_partition_layout(layout)) {
+                    res.status = 409;
+                    res.set_content(create_error_response("Partitions are in use, or the layout is invalid or exceeds total memory.").dump(), "application/json; charset=utf-8");
+                    return;
+                }
+                json data;
+                data["partition_count"] = memory_manager->get_partitions().size();
+                res.set_content(create_success_response(data, "Partition layout updated.").dump(), "application/json; charset=utf-8");
+            } catch (const json::exception& e) {
+                res.status = 400;
+                res.set_content(create_error_response("Invalid request body: " + std::string(e.what())).dump(), "application/json; charset=utf-8");
+            }
+        });
+
         // --- 文件系统管理 API ---
         svr.Get("/api/v1/filesystem/status", [&](const httplib::Request&, httplib::Response& res) {
             auto status = fs_manager->get_filesystem_status();
@@ -1084,6 +2263,8 @@ json pcb_to_json(const PCB& pcb) {
     j["pid"] = pcb.pid;
     j["name"] = pcb.name;
     j["parent_pid"] = pcb.parent_pid;
+    j["image_path"] = pcb.image_path;
+    j["memory_group"] = memory_manager->get_memory_group_of(pcb.pid);
     j["state"] = to_string_for_json(pcb.state);
     j["program_counter"] = pcb.program_counter;
     j["cpu_time"] = pcb.cpu_time;
@@ -726,6 +726,66 @@ FileAddresses FileSystemManager::get_file_addresses(const std::string& path) {
     return addresses;
 }
 
+std::optional<FileBlockMap> FileSystemManager::get_file_block_map(const std::string& path) {
+    auto inode_idx_opt = find_inode_by_path(path);
+    if (!inode_idx_opt || inode_table[*inode_idx_opt].type != InodeType::FILE) {
+        return std::nullopt;
+    }
+    const auto& inode = inode_table[*inode_idx_opt];
+    FileBlockMap map{*inode_idx_opt, inode.simulated_size, {}, BLOCK_SIZE};
+    uint32_t block_count = static_cast<uint32_t>((inode.simulated_size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    map.blocks.reserve(block_count);
+
+    std::visit([&](auto&& arg) {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, ContiguousAllocation>) {
+            for (uint32_t i = 0; i < arg.block_count; ++i) {
+                map.blocks.push_back(arg.start_block + i);
+            }
+        } else if constexpr (std::is_same_v<T, LinkedAllocation>) {
+            map.block_payload = BLOCK_SIZE - sizeof(uint32_t);
+            uint32_t current_block = arg.start_block;
+            for (uint32_t i = 0; i < block_count; ++i) {
+                map.blocks.push_back(current_block);
+                if (current_block == arg.end_block) {
+                    break;
+                }
+                read_disk((uint64_t)current_block * BLOCK_SIZE + BLOCK_SIZE - sizeof(uint32_t), &current_block, sizeof(uint32_t));
+            }
+        } else if constexpr (std::is_same_v<T, IndexedAllocation>) {
+            map.blocks.resize(block_count);
+            read_disk((uint64_t)arg.index_block * BLOCK_SIZE, map.blocks.data(), block_count * sizeof(uint32_t));
+        }
+    }, inode.allocation_info);
+    return map;
+}
+
+std::optional<ContiguousAllocation> FileSystemManager::reserve_blocks(uint32_t block_count) {
+    if (block_count == 0) {
+        return std::nullopt;
+    }
+    return allocate_contiguous_blocks(block_count);
+}
+
+void FileSystemManager::release_blocks(const ContiguousAllocation& blocks) {
+    for (uint32_t i = 0; i < blocks.block_count; ++i) {
+        discard_block(blocks.start_block + i);
+        free_block(blocks.start_block + i);
+    }
+}
+
+void FileSystemManager::read_block(uint32_t block_num, void* buffer) {
+    read_disk(static_cast<uint64_t>(block_num) * BLOCK_SIZE, buffer, BLOCK_SIZE);
+}
+
+void FileSystemManager::write_block(uint32_t block_num, const void* data) {
+    write_disk(static_cast<uint64_t>(block_num) * BLOCK_SIZE, data, BLOCK_SIZE);
+}
+
+void FileSystemManager::discard_block(uint32_t block_num) {
+    block_storage.erase(block_num);
+}
+
 void FileSystemManager::read_disk(uint64_t offset, void* buffer, size_t size) {
     if (offset + size > DISK_SIZE_BYTES) {
         throw std::runtime_error("Disk read out of bounds.");
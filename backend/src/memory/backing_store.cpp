@@ -0,0 +1,173 @@
+#include "memory/backing_store.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+BackingStore::BackingStore()
+    : base_(nullptr), size_(0), mode_(MemoryBackingMode::LAZY), committed_(0) {}
+
+BackingStore::~BackingStore() {
+    release();
+}
+
+void BackingStore::reserve(uint64_t size, MemoryBackingMode mode) {
+    release();
+
+    uint64_t granules = (size + COMMIT_GRANULE - 1) / COMMIT_GRANULE;
+    if (mode == MemoryBackingMode::EAGER) {
+        base_ = new (std::nothrow) char[size];
+    } else {
+#ifdef _WIN32
+        base_ = static_cast<char*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS));
+#else
+        // 匿名私有映射在首次写入时才由内核分配物理页，NORESERVE 避免按整池计入提交额度
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        base_ = (p == MAP_FAILED) ? nullptr : static_cast<char*>(p);
+#endif
+    }
+    if (base_ == nullptr) {
+        throw std::runtime_error("Failed to reserve memory for the main memory pool.");
+    }
+
+    size_ = size;
+    mode_ = mode;
+    committed_ = FrameBitmap(granules);
+    if (mode == MemoryBackingMode::EAGER) {
+        for (uint64_t g = 0; g < granules; ++g) {
+            committed_.set(g);
+        }
+    }
+}
+
+void BackingStore::release() {
+    if (base_ == nullptr) {
+        return;
+    }
+    if (mode_ == MemoryBackingMode::EAGER) {
+        delete[] base_;
+    } else {
+#ifdef _WIN32
+        VirtualFree(base_, 0, MEM_RELEASE);
+#else
+        munmap(base_, size_);
+#endif
+    }
+    base_ = nullptr;
+    size_ = 0;
+    committed_ = FrameBitmap(0);
+}
+
+void BackingStore::read(uint64_t address, void* buffer, size_t size) const {
+    char* out = static_cast<char*>(buffer);
+    if (mode_ == MemoryBackingMode::EAGER) {
+        std::memcpy(out, base_ + address, size);
+        return;
+    }
+
+    uint64_t end = address + size;
+    uint64_t cur = address;
+    while (cur < end) {
+        uint64_t granule_end = std::min(end, (cur / COMMIT_GRANULE + 1) * COMMIT_GRANULE);
+        if (committed_.test(cur / COMMIT_GRANULE)) {
+            std::memcpy(out + (cur - address), base_ + cur, granule_end - cur);
+        } else {
+            // 从未写入的区域读出 0，且不触发提交
+            std::memset(out + (cur - address), 0, granule_end - cur);
+        }
+        cur = granule_end;
+    }
+}
+
+void BackingStore::write(uint64_t address, const void* data, size_t size) {
+    commit(address, size);
+    std::memcpy(base_ + address, data, size);
+}
+
+void BackingStore::commit(uint64_t address, uint64_t size) {
+    if (size == 0 || mode_ == MemoryBackingMode::EAGER) {
+        return;
+    }
+    uint64_t first = address / COMMIT_GRANULE;
+    uint64_t last = (address + size - 1) / COMMIT_GRANULE;
+
+    // 合并连续的未提交粒度，减少系统调用次数
+    uint64_t g = first;
+    while (g <= last) {
+        if (committed_.test(g)) {
+            ++g;
+            continue;
+        }
+        uint64_t run_start = g;
+        while (g <= last && !committed_.test(g)) {
+            ++g;
+        }
+        if (!platform_commit(run_start, g - run_start)) {
+            throw std::runtime_error("Failed to commit simulated memory.");
+        }
+        for (uint64_t i = run_start; i < g; ++i) {
+            committed_.set(i);
+        }
+    }
+}
+
+void BackingStore::decommit(uint64_t address, uint64_t size) {
+    if (size == 0 || mode_ == MemoryBackingMode::EAGER) {
+        return;
+    }
+    // 只归还完整落在区间内的粒度，部分覆盖的粒度可能还有其他数据
+    uint64_t first = (address + COMMIT_GRANULE - 1) / COMMIT_GRANULE;
+    uint64_t end = (address + size) / COMMIT_GRANULE;
+
+    uint64_t g = first;
+    while (g < end) {
+        if (!committed_.test(g)) {
+            ++g;
+            continue;
+        }
+        uint64_t run_start = g;
+        while (g < end && committed_.test(g)) {
+            committed_.clear(g);
+            ++g;
+        }
+        platform_decommit(run_start, g - run_start);
+    }
+}
+
+bool BackingStore::is_committed(uint64_t address) const {
+    return committed_.test(address / COMMIT_GRANULE);
+}
+
+uint64_t BackingStore::committed_bytes() const {
+    return std::min(size_, committed_.used_count() * COMMIT_GRANULE);
+}
+
+bool BackingStore::platform_commit(uint64_t first_granule, uint64_t count) {
+#ifdef _WIN32
+    uint64_t offset = first_granule * COMMIT_GRANULE;
+    uint64_t length = std::min(count * COMMIT_GRANULE, size_ - offset);
+    return VirtualAlloc(base_ + offset, length, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    // 映射本身可读写，物理页在首次写入时由内核按需分配
+    (void)first_granule;
+    (void)count;
+    return true;
+#endif
+}
+
+void BackingStore::platform_decommit(uint64_t first_granule, uint64_t count) {
+    uint64_t offset = first_granule * COMMIT_GRANULE;
+    uint64_t length = std::min(count * COMMIT_GRANULE, size_ - offset);
+#ifdef _WIN32
+    VirtualFree(base_ + offset, length, MEM_DECOMMIT);
+#else
+    madvise(base_ + offset, length, MADV_DONTNEED);
+#endif
+}
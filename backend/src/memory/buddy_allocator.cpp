@@ -0,0 +1,96 @@
+#include "memory/buddy_allocator.h"
+
+BuddyAllocator::BuddyAllocator(uint64_t total_size, uint64_t min_block)
+    : min_block_(min_block), max_order_(0) {
+    while (order_size(max_order_ + 1) <= total_size) {
+        ++max_order_;
+    }
+    free_areas_.resize(max_order_ + 1);
+    reset();
+}
+
+void BuddyAllocator::reset() {
+    for (auto& area : free_areas_) {
+        area.clear();
+    }
+    allocated_.clear();
+    free_areas_[max_order_].insert(0);
+}
+
+uint32_t BuddyAllocator::order_for(uint64_t size) const {
+    uint32_t order = 0;
+    while (order < max_order_ && order_size(order) < size) {
+        ++order;
+    }
+    return order;
+}
+
+uint64_t BuddyAllocator::rounded_size(uint64_t size) const {
+    return order_size(order_for(size));
+}
+
+std::optional<uint64_t> BuddyAllocator::allocate(uint64_t size) {
+    if (size == 0 || size > order_size(max_order_)) {
+        return std::nullopt;
+    }
+    uint32_t order = order_for(size);
+
+    // 找到不小于目标阶的最小非空空闲链表
+    uint32_t current = order;
+    while (current <= max_order_ && free_areas_[current].empty()) {
+        ++current;
+    }
+    if (current > max_order_) {
+        return std::nullopt;
+    }
+
+    uint64_t address = *free_areas_[current].begin();
+    free_areas_[current].erase(free_areas_[current].begin());
+
+    // 逐阶拆分，高地址的一半放回低一阶的空闲链表
+    while (current > order) {
+        --current;
+        free_areas_[current].insert(address + order_size(current));
+    }
+
+    allocated_[address] = order;
+    return address;
+}
+
+uint64_t BuddyAllocator::free(uint64_t address) {
+    auto it = allocated_.find(address);
+    if (it == allocated_.end()) {
+        return 0;
+    }
+    uint32_t order = it->second;
+    uint64_t freed = order_size(order);
+    allocated_.erase(it);
+
+    // 伙伴也空闲时合并为高一阶的块
+    while (order < max_order_) {
+        uint64_t buddy = address ^ order_size(order);
+        auto buddy_it = free_areas_[order].find(buddy);
+        if (buddy_it == free_areas_[order].end()) {
+            break;
+        }
+        free_areas_[order].erase(buddy_it);
+        address = address < buddy ? address : buddy;
+        ++order;
+    }
+    free_areas_[order].insert(address);
+    return freed;
+}
+
+uint64_t BuddyAllocator::block_size(uint64_t address) const {
+    auto it = allocated_.find(address);
+    return it == allocated_.end() ? 0 : order_size(it->second);
+}
+
+uint64_t BuddyAllocator::largest_free_block() const {
+    for (uint32_t order = max_order_ + 1; order-- > 0;) {
+        if (!free_areas_[order].empty()) {
+            return order_size(order);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include "memory/compressed_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const size_t MIN_MATCH = 4;
+const uint32_t HASH_LOG = 12;
+const size_t MAX_OFFSET = 0xFFFF;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hash32(uint32_t value) {
+    return (value * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// 令牌中的长度字段为 15 时，剩余部分按每字节最多 255 续写
+bool put_length(uint8_t*& op, const uint8_t* end, size_t length) {
+    while (length >= 255) {
+        if (op >= end) {
+            return false;
+        }
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= end) {
+        return false;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return true;
+}
+
+bool get_length(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count());
+}
+
+} // namespace
+
+CompressedPool::CompressedPool(uint64_t limit)
+    : limit_(limit), pool_bytes_(0), classes_(MAX_STORED_SIZE / CLASS_SIZE) {}
+
+std::optional<uint64_t> CompressedPool::store(const void* page) {
+    auto started = std::chrono::steady_clock::now();
+    uint8_t buffer[MAX_STORED_SIZE];
+    size_t length = compress(static_cast<const uint8_t*>(page), PAGE_SIZE, buffer, sizeof(buffer));
+    counters_.compress_ns += elapsed_ns(started);
+    if (length == 0) {
+        ++counters_.rejected_incompressible;
+        return std::nullopt;
+    }
+
+    size_t index = (length + CLASS_SIZE - 1) / CLASS_SIZE - 1;
+    size_t slot_size = (index + 1) * CLASS_SIZE;
+    SizeClass& size_class = classes_[index];
+    uint32_t slot;
+    if (!size_class.free_slots.empty()) {
+        slot = size_class.free_slots.back();
+        size_class.free_slots.pop_back();
+    } else {
+        if (limit_ != 0 && pool_bytes_ + slot_size > limit_) {
+            ++counters_.rejected_full;
+            return std::nullopt;
+        }
+        slot = static_cast<uint32_t>(size_class.lengths.size());
+        size_class.arena.resize(size_class.arena.size() + slot_size);
+        size_class.lengths.push_back(0);
+        pool_bytes_ += slot_size;
+    }
+    std::memcpy(&size_class.arena[slot * slot_size], buffer, length);
+    size_class.lengths[slot] = static_cast<uint16_t>(length);
+    ++counters_.stored_pages;
+    counters_.compressed_bytes += length;
+    ++counters_.stores;
+    return (static_cast<uint64_t>(index) << 32) | slot;
+}
+
+bool CompressedPool::load(uint64_t handle, void* buffer) {
+    size_t index = handle >> 32;
+    uint32_t slot = static_cast<uint32_t>(handle);
+    if (index >= classes_.size() || slot >= classes_[index].lengths.size() || classes_[index].lengths[slot] == 0) {
+        return false;
+    }
+    auto started = std::chrono::steady_clock::now();
+    const SizeClass& size_class = classes_[index];
+    bool ok = decompress(&size_class.arena[slot * (index + 1) * CLASS_SIZE], size_class.lengths[slot],
+                         static_cast<uint8_t*>(buffer), PAGE_SIZE);
+    counters_.decompress_ns += elapsed_ns(started);
+    ++counters_.loads;
+    return ok;
+}
+
+void CompressedPool::release(uint64_t handle) {
+    size_t index = handle >> 32;
+    uint32_t slot = static_cast<uint32_t>(handle);
+    if (index >= classes_.size() || slot >= classes_[index].lengths.size() || classes_[index].lengths[slot] == 0) {
+        return;
+    }
+    SizeClass& size_class = classes_[index];
+    --counters_.stored_pages;
+    counters_.compressed_bytes -= size_class.lengths[slot];
+    size_class.lengths[slot] = 0;
+    size_class.free_slots.push_back(slot);
+}
+
+void CompressedPool::clear() {
+    for (auto& size_class : classes_) {
+        size_class = SizeClass();
+    }
+    pool_bytes_ = 0;
+    counters_.stored_pages = 0;
+    counters_.compressed_bytes = 0;
+}
+
+CompressedPoolStats CompressedPool::stats() const {
+    CompressedPoolStats result = counters_;
+    result.pool_bytes = pool_bytes_;
+    result.limit = limit_;
+    return result;
+}
+
+void CompressedPool::reset_stats() {
+    CompressedPoolStats cleared;
+    cleared.stored_pages = counters_.stored_pages;
+    cleared.compressed_bytes = counters_.compressed_bytes;
+    counters_ = cleared;
+}
+
+// 编码格式与 LZ4 块格式相同：每个序列为 令牌(高 4 位字面量长度、低 4 位匹配长度 - 4)、
+// 字面量、2 字节小端偏移、扩展匹配长度；最后一个序列只有字面量
+size_t CompressedPool::compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+    int32_t table[1 << HASH_LOG];
+    std::fill(std::begin(table), std::end(table), -1);
+    uint8_t* op = dst;
+    const uint8_t* const op_end = dst + capacity;
+    size_t anchor = 0;
+
+    auto emit = [&](size_t literal_end, size_t offset, size_t match) {
+        size_t literals = literal_end - anchor;
+        if (op >= op_end) {
+            return false;
+        }
+        uint8_t* token = op++;
+        *token = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+        if (literals >= 15 && !put_length(op, op_end, literals - 15)) {
+            return false;
+        }
+        if (static_cast<size_t>(op_end - op) < literals) {
+            return false;
+        }
+        std::memcpy(op, src + anchor, literals);
+        op += literals;
+        if (match == 0) {
+            return true;
+        }
+        if (op_end - op < 2) {
+            return false;
+        }
+        *op++ = static_cast<uint8_t>(offset);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        size_t extra = match - MIN_MATCH;
+        *token |= static_cast<uint8_t>(std::min<size_t>(extra, 15));
+        return extra < 15 || put_length(op, op_end, extra - 15);
+    };
+
+    size_t i = 0;
+    while (i + MIN_MATCH <= size) {
+        uint32_t sequence = read32(src + i);
+        uint32_t hash = hash32(sequence);
+        int32_t candidate = table[hash];
+        table[hash] = static_cast<int32_t>(i);
+        if (candidate < 0 || i - candidate > MAX_OFFSET || read32(src + candidate) != sequence) {
+            ++i;
+            continue;
+        }
+        size_t match = MIN_MATCH;
+        while (i + match < size && src[candidate + match] == src[i + match]) {
+            ++match;
+        }
+        if (!emit(i, i - candidate, match)) {
+            return 0;
+        }
+        i += match;
+        anchor = i;
+    }
+    if (anchor < size && !emit(size, 0, 0)) {
+        return 0;
+    }
+    return static_cast<size_t>(op - dst);
+}
+
+bool CompressedPool::decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t expected) {
+    const uint8_t* ip = src;
+    const uint8_t* const ip_end = src + size;
+    uint8_t* op = dst;
+    uint8_t* const op_end = dst + expected;
+    while (ip < ip_end) {
+        uint8_t token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !get_length(ip, ip_end, literals)) {
+            return false;
+        }
+        if (static_cast<size_t>(ip_end - ip) < literals || static_cast<size_t>(op_end - op) < literals) {
+            return false;
+        }
+        std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == ip_end) {
+            break;
+        }
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t match = token & 15;
+        if (match == 15 && !get_length(ip, ip_end, match)) {
+            return false;
+        }
+        match += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) || static_cast<size_t>(op_end - op) < match) {
+            return false;
+        }
+        // 偏移小于匹配长度时源与目标重叠，必须逐字节复制
+        const uint8_t* from = op - offset;
+        for (size_t k = 0; k < match; ++k) {
+            op[k] = from[k];
+        }
+        op += match;
+    }
+    return op == op_end;
+}
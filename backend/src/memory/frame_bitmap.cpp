@@ -0,0 +1,155 @@
+#include "memory/frame_bitmap.h"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+const uint64_t FULL_WORD = ~0ULL;
+
+// 返回最低位 0 的位置（调用方保证 word 不全为 1）
+inline unsigned first_zero_bit(uint64_t word) {
+    uint64_t inverted = ~word;
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, inverted);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(inverted));
+#endif
+}
+
+} // namespace
+
+FrameBitmap::FrameBitmap(uint64_t frame_count) : frame_count_(frame_count), used_count_(0) {
+    uint64_t bits = frame_count_;
+    do {
+        uint64_t words = (bits + 63) / 64;
+        levels_.emplace_back(words, 0);
+        bits = words;
+    } while (bits > 1);
+    reset();
+}
+
+void FrameBitmap::reset() {
+    used_count_ = 0;
+    uint64_t bits = frame_count_;
+    for (auto& level : levels_) {
+        std::fill(level.begin(), level.end(), 0);
+        // 超出范围的尾部位视为已占用，保证永远不会被返回
+        uint64_t tail = bits % 64;
+        if (tail != 0) {
+            level.back() = FULL_WORD << tail;
+        }
+        bits = level.size();
+    }
+}
+
+bool FrameBitmap::test(uint64_t frame) const {
+    if (frame >= frame_count_) {
+        return false;
+    }
+    return (levels_[0][frame / 64] >> (frame % 64)) & 1ULL;
+}
+
+bool FrameBitmap::set(uint64_t frame) {
+    if (frame >= frame_count_ || test(frame)) {
+        return false;
+    }
+    uint64_t& word = levels_[0][frame / 64];
+    word |= 1ULL << (frame % 64);
+    ++used_count_;
+    if (word == FULL_WORD) {
+        mark_full(1, frame / 64);
+    }
+    return true;
+}
+
+bool FrameBitmap::clear(uint64_t frame) {
+    if (frame >= frame_count_ || !test(frame)) {
+        return false;
+    }
+    uint64_t& word = levels_[0][frame / 64];
+    bool was_full = (word == FULL_WORD);
+    word &= ~(1ULL << (frame % 64));
+    --used_count_;
+    if (was_full) {
+        mark_not_full(1, frame / 64);
+    }
+    return true;
+}
+
+uint64_t FrameBitmap::find_first_free() const {
+    if (used_count_ == frame_count_) {
+        return UINT64_MAX;
+    }
+    // 自顶向下，每层根据首个 0 位定位下一层的字
+    uint64_t index = 0;
+    for (size_t level = levels_.size(); level-- > 0;) {
+        uint64_t word = levels_[level][index];
+        if (word == FULL_WORD) {
+            return UINT64_MAX;
+        }
+        index = index * 64 + first_zero_bit(word);
+    }
+    return index < frame_count_ ? index : UINT64_MAX;
+}
+
+uint64_t FrameBitmap::allocate() {
+    uint64_t frame = find_first_free();
+    if (frame != UINT64_MAX) {
+        set(frame);
+    }
+    return frame;
+}
+
+uint64_t FrameBitmap::allocate_aligned_run(uint64_t count) {
+    uint64_t words = count / 64;
+    if (words == 0 || count % 64 != 0 || free_count() < count) {
+        return UINT64_MAX;
+    }
+    // 对齐的连续页框对应第 0 层连续的全 0 字，整字置满即可
+    std::vector<uint64_t>& bits = levels_[0];
+    for (uint64_t first = 0; (first + words) * 64 <= frame_count_; first += words) {
+        uint64_t w = 0;
+        while (w < words && bits[first + w] == 0) {
+            ++w;
+        }
+        if (w < words) {
+            continue;
+        }
+        for (w = 0; w < words; ++w) {
+            bits[first + w] = FULL_WORD;
+            mark_full(1, first + w);
+        }
+        used_count_ += count;
+        return first * 64;
+    }
+    return UINT64_MAX;
+}
+
+void FrameBitmap::mark_full(size_t level, uint64_t index) {
+    // index 为下一层中变满的字的下标
+    for (; level < levels_.size(); ++level) {
+        uint64_t& word = levels_[level][index / 64];
+        word |= 1ULL << (index % 64);
+        if (word != FULL_WORD) {
+            return;
+        }
+        index /= 64;
+    }
+}
+
+void FrameBitmap::mark_not_full(size_t level, uint64_t index) {
+    for (; level < levels_.size(); ++level) {
+        uint64_t& word = levels_[level][index / 64];
+        bool was_full = (word == FULL_WORD);
+        word &= ~(1ULL << (index % 64));
+        if (!was_full) {
+            return;
+        }
+        index /= 64;
+    }
+}
@@ -0,0 +1,319 @@
+#include "memory/free_block_index.h"
+#include <algorithm>
+
+// --- const_iterator ---
+
+FreeBlockIndex::const_iterator::const_iterator(const FreeBlockIndex* owner, int32_t root)
+    : owner_(owner), current_{0, 0} {
+    descend_left(root);
+    load();
+}
+
+void FreeBlockIndex::const_iterator::descend_left(int32_t node) {
+    while (node != NIL) {
+        stack_.push_back(node);
+        node = owner_->nodes_[node].left;
+    }
+}
+
+void FreeBlockIndex::const_iterator::load() {
+    if (!stack_.empty()) {
+        const Node& n = owner_->nodes_[stack_.back()];
+        current_ = FreeBlock{n.base, n.size};
+    }
+}
+
+FreeBlockIndex::const_iterator& FreeBlockIndex::const_iterator::operator++() {
+    int32_t node = stack_.back();
+    stack_.pop_back();
+    descend_left(owner_->nodes_[node].right);
+    load();
+    return *this;
+}
+
+// --- FreeBlockIndex ---
+
+FreeBlockIndex::FreeBlockIndex()
+    : root_(NIL), count_(0), total_free_(0), rng_state_(2463534242u), next_fit_cursor_(0) {}
+
+void FreeBlockIndex::reset(uint64_t base, uint64_t size) {
+    nodes_.clear();
+    free_nodes_.clear();
+    by_size_.clear();
+    root_ = NIL;
+    count_ = 0;
+    total_free_ = 0;
+    next_fit_cursor_ = base;
+    if (size > 0) {
+        insert(base, size);
+        total_free_ = size;
+    }
+}
+
+FreeBlock FreeBlockIndex::front() const {
+    int32_t node = root_;
+    if (node == NIL) {
+        return FreeBlock{0, 0};
+    }
+    while (nodes_[node].left != NIL) {
+        node = nodes_[node].left;
+    }
+    return FreeBlock{nodes_[node].base, nodes_[node].size};
+}
+
+uint64_t FreeBlockIndex::largest_block() const {
+    return root_ == NIL ? 0 : nodes_[root_].max_size;
+}
+
+std::optional<uint64_t> FreeBlockIndex::allocate(uint64_t size, PlacementPolicy policy) {
+    if (size == 0 || largest_block() < size) {
+        return std::nullopt;
+    }
+
+    uint64_t block_base = 0;
+    uint64_t block_size = 0;
+    switch (policy) {
+        case PlacementPolicy::FIRST_FIT:
+        case PlacementPolicy::NEXT_FIT: {
+            int32_t node = NIL;
+            if (policy == PlacementPolicy::NEXT_FIT) {
+                node = first_fit(size, next_fit_cursor_);
+            }
+            if (node == NIL) {
+                node = first_fit(size, 0); // 首次适应，或循环首次适应绕回开头
+            }
+            block_base = nodes_[node].base;
+            block_size = nodes_[node].size;
+            break;
+        }
+        case PlacementPolicy::BEST_FIT: {
+            auto it = by_size_.lower_bound({size, 0});
+            block_size = it->first;
+            block_base = it->second;
+            break;
+        }
+        case PlacementPolicy::WORST_FIT: {
+            auto it = std::prev(by_size_.end());
+            block_size = it->first;
+            block_base = it->second;
+            break;
+        }
+    }
+
+    // 从块的低地址端切出所需空间
+    erase(block_base);
+    if (block_size > size) {
+        insert(block_base + size, block_size - size);
+    }
+    total_free_ -= size;
+    next_fit_cursor_ = block_base + size;
+    return block_base;
+}
+
+bool FreeBlockIndex::claim(uint64_t base, uint64_t size) {
+    if (size == 0) {
+        return false;
+    }
+    int32_t node = predecessor(base + 1);
+    if (node == NIL || nodes_[node].base + nodes_[node].size < base + size) {
+        return false;
+    }
+    uint64_t block_base = nodes_[node].base;
+    uint64_t block_end = block_base + nodes_[node].size;
+    erase(block_base);
+    if (block_base < base) {
+        insert(block_base, base - block_base);
+    }
+    if (base + size < block_end) {
+        insert(base + size, block_end - base - size);
+    }
+    total_free_ -= size;
+    return true;
+}
+
+bool FreeBlockIndex::release(uint64_t base, uint64_t size) {
+    if (size == 0) {
+        return false;
+    }
+
+    int32_t prev = predecessor(base);
+    int32_t next = successor(base);
+    // 拒绝与现有空闲块重叠的释放（重复释放等）
+    if (prev != NIL && nodes_[prev].base + nodes_[prev].size > base) {
+        return false;
+    }
+    if (next != NIL && base + size > nodes_[next].base) {
+        return false;
+    }
+
+    bool merge_prev = (prev != NIL && nodes_[prev].base + nodes_[prev].size == base);
+    bool merge_next = (next != NIL && base + size == nodes_[next].base);
+
+    if (merge_prev) {
+        uint64_t prev_base = nodes_[prev].base;
+        uint64_t merged = nodes_[prev].size + size;
+        if (merge_next) {
+            merged += nodes_[next].size;
+            erase(nodes_[next].base);
+        }
+        resize(prev_base, merged);
+    } else if (merge_next) {
+        uint64_t merged = size + nodes_[next].size;
+        erase(nodes_[next].base);
+        insert(base, merged);
+    } else {
+        insert(base, size);
+    }
+    total_free_ += size;
+    return true;
+}
+
+int32_t FreeBlockIndex::new_node(uint64_t base, uint64_t size) {
+    // xorshift32 生成树堆优先级
+    rng_state_ ^= rng_state_ << 13;
+    rng_state_ ^= rng_state_ >> 17;
+    rng_state_ ^= rng_state_ << 5;
+    Node node{base, size, size, rng_state_, NIL, NIL};
+
+    if (!free_nodes_.empty()) {
+        int32_t idx = free_nodes_.back();
+        free_nodes_.pop_back();
+        nodes_[idx] = node;
+        return idx;
+    }
+    nodes_.push_back(node);
+    return static_cast<int32_t>(nodes_.size() - 1);
+}
+
+void FreeBlockIndex::pull(int32_t node) {
+    Node& n = nodes_[node];
+    n.max_size = n.size;
+    if (n.left != NIL) n.max_size = std::max(n.max_size, nodes_[n.left].max_size);
+    if (n.right != NIL) n.max_size = std::max(n.max_size, nodes_[n.right].max_size);
+}
+
+void FreeBlockIndex::split(int32_t node, uint64_t key, int32_t& left, int32_t& right) {
+    // left: base < key, right: base >= key
+    if (node == NIL) {
+        left = right = NIL;
+        return;
+    }
+    if (nodes_[node].base < key) {
+        split(nodes_[node].right, key, nodes_[node].right, right);
+        left = node;
+    } else {
+        split(nodes_[node].left, key, left, nodes_[node].left);
+        right = node;
+    }
+    pull(node);
+}
+
+int32_t FreeBlockIndex::merge(int32_t left, int32_t right) {
+    if (left == NIL) return right;
+    if (right == NIL) return left;
+    if (nodes_[left].priority > nodes_[right].priority) {
+        nodes_[left].right = merge(nodes_[left].right, right);
+        pull(left);
+        return left;
+    }
+    nodes_[right].left = merge(left, nodes_[right].left);
+    pull(right);
+    return right;
+}
+
+void FreeBlockIndex::insert(uint64_t base, uint64_t size) {
+    int32_t left, right;
+    split(root_, base, left, right);
+    root_ = merge(merge(left, new_node(base, size)), right);
+    by_size_.insert({size, base});
+    ++count_;
+}
+
+void FreeBlockIndex::erase(uint64_t base) {
+    int32_t left, mid, right;
+    split(root_, base, left, right);
+    split(right, base + 1, mid, right);
+    if (mid != NIL) {
+        by_size_.erase({nodes_[mid].size, base});
+        free_nodes_.push_back(mid);
+        --count_;
+    }
+    root_ = merge(left, right);
+}
+
+void FreeBlockIndex::resize(uint64_t base, uint64_t new_size) {
+    resize_in(root_, base, new_size);
+}
+
+bool FreeBlockIndex::resize_in(int32_t node, uint64_t base, uint64_t new_size) {
+    if (node == NIL) {
+        return false;
+    }
+    Node& n = nodes_[node];
+    bool found;
+    if (base == n.base) {
+        by_size_.erase({n.size, base});
+        by_size_.insert({new_size, base});
+        n.size = new_size;
+        found = true;
+    } else {
+        found = resize_in(base < n.base ? n.left : n.right, base, new_size);
+    }
+    if (found) {
+        pull(node); // 沿路径自底向上更新子树最大值
+    }
+    return found;
+}
+
+int32_t FreeBlockIndex::predecessor(uint64_t address) const {
+    int32_t node = root_;
+    int32_t best = NIL;
+    while (node != NIL) {
+        if (nodes_[node].base < address) {
+            best = node;
+            node = nodes_[node].right;
+        } else {
+            node = nodes_[node].left;
+        }
+    }
+    return best;
+}
+
+int32_t FreeBlockIndex::successor(uint64_t address) const {
+    int32_t node = root_;
+    int32_t best = NIL;
+    while (node != NIL) {
+        if (nodes_[node].base >= address) {
+            best = node;
+            node = nodes_[node].left;
+        } else {
+            node = nodes_[node].right;
+        }
+    }
+    return best;
+}
+
+int32_t FreeBlockIndex::first_fit(uint64_t size, uint64_t min_base) const {
+    return first_fit_in(root_, size, min_base);
+}
+
+int32_t FreeBlockIndex::first_fit_in(int32_t node, uint64_t size, uint64_t min_base) const {
+    // 在 base >= min_base 的块中找地址最低且大小足够的块；
+    // 子树最大值不足时整棵子树被剪枝
+    while (node != NIL && nodes_[node].max_size >= size) {
+        const Node& n = nodes_[node];
+        if (n.base < min_base) {
+            node = n.right;
+            continue;
+        }
+        int32_t in_left = first_fit_in(n.left, size, min_base);
+        if (in_left != NIL) {
+            return in_left;
+        }
+        if (n.size >= size) {
+            return node;
+        }
+        node = n.right;
+    }
+    return NIL;
+}
@@ -0,0 +1,298 @@
+#include "memory/heap_allocator.h"
+#include <algorithm>
+
+HeapAllocator::HeapAllocator(HeapPolicy policy)
+    : policy_(policy), capacity_(0), fl_bitmap_(0), last_block_(NIL), tlsf_free_count_(0) {
+    std::fill(std::begin(sl_bitmap_), std::end(sl_bitmap_), 0u);
+    for (auto& row : heads_) {
+        std::fill(std::begin(row), std::end(row), NIL);
+    }
+}
+
+std::optional<uint64_t> HeapAllocator::allocate(uint64_t size) {
+    if (size == 0 || size > (1ULL << 62)) {
+        return std::nullopt;
+    }
+    uint64_t aligned = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    std::optional<uint64_t> offset;
+    if (policy_ == HeapPolicy::TLSF) {
+        offset = tlsf_allocate(aligned, size);
+    } else {
+        offset = index_.allocate(aligned, policy_ == HeapPolicy::FIRST_FIT ? PlacementPolicy::FIRST_FIT : PlacementPolicy::BEST_FIT);
+        if (offset) {
+            index_used_[*offset] = Allocation{aligned, size};
+        }
+    }
+    if (!offset) {
+        ++counters_.failures;
+        return std::nullopt;
+    }
+    counters_.allocated += aligned;
+    counters_.requested += size;
+    ++counters_.live_blocks;
+    ++counters_.allocations;
+    return offset;
+}
+
+bool HeapAllocator::free(uint64_t offset) {
+    uint64_t size = block_size(offset);
+    if (size == 0) {
+        return false;
+    }
+    uint64_t requested;
+    if (policy_ == HeapPolicy::TLSF) {
+        requested = blocks_[tlsf_used_.at(offset)].requested;
+        tlsf_free(offset);
+    } else {
+        requested = index_used_.at(offset).requested;
+        index_used_.erase(offset);
+        index_.release(offset, size);
+    }
+    counters_.allocated -= size;
+    counters_.requested -= requested;
+    --counters_.live_blocks;
+    ++counters_.frees;
+    return true;
+}
+
+uint64_t HeapAllocator::block_size(uint64_t offset) const {
+    if (policy_ == HeapPolicy::TLSF) {
+        auto it = tlsf_used_.find(offset);
+        return it == tlsf_used_.end() ? 0 : blocks_[it->second].size;
+    }
+    auto it = index_used_.find(offset);
+    return it == index_used_.end() ? 0 : it->second.size;
+}
+
+void HeapAllocator::grow(uint64_t new_capacity) {
+    if (new_capacity <= capacity_) {
+        return;
+    }
+    uint64_t added = new_capacity - capacity_;
+    if (policy_ != HeapPolicy::TLSF) {
+        index_.release(capacity_, added);
+    } else if (last_block_ != NIL && blocks_[last_block_].free) {
+        remove_free(last_block_);
+        blocks_[last_block_].size += added;
+        insert_free(last_block_);
+    } else {
+        int32_t block = new_block(capacity_, added);
+        blocks_[block].prev_phys = last_block_;
+        if (last_block_ != NIL) {
+            blocks_[last_block_].next_phys = block;
+        }
+        last_block_ = block;
+        insert_free(block);
+    }
+    capacity_ = new_capacity;
+}
+
+uint64_t HeapAllocator::trailing_free() const {
+    if (policy_ == HeapPolicy::TLSF) {
+        return last_block_ != NIL && blocks_[last_block_].free ? blocks_[last_block_].size : 0;
+    }
+    if (index_used_.empty()) {
+        return capacity_;
+    }
+    const auto& last = *index_used_.rbegin();
+    return capacity_ - (last.first + last.second.size);
+}
+
+bool HeapAllocator::shrink(uint64_t new_capacity) {
+    if (new_capacity >= capacity_) {
+        return new_capacity == capacity_;
+    }
+    uint64_t removed = capacity_ - new_capacity;
+    if (trailing_free() < removed) {
+        return false;
+    }
+    if (policy_ != HeapPolicy::TLSF) {
+        index_.claim(new_capacity, removed);
+    } else {
+        int32_t last = last_block_;
+        remove_free(last);
+        blocks_[last].size -= removed;
+        if (blocks_[last].size > 0) {
+            insert_free(last);
+        } else {
+            last_block_ = blocks_[last].prev_phys;
+            if (last_block_ != NIL) {
+                blocks_[last_block_].next_phys = NIL;
+            }
+            spare_blocks_.push_back(last);
+        }
+    }
+    capacity_ = new_capacity;
+    return true;
+}
+
+HeapStats HeapAllocator::stats() const {
+    HeapStats result = counters_;
+    result.capacity = capacity_;
+    if (policy_ != HeapPolicy::TLSF) {
+        result.free_blocks = index_.size();
+        result.largest_free = index_.largest_block();
+        return result;
+    }
+    result.free_blocks = tlsf_free_count_;
+    if (fl_bitmap_ != 0) {
+        // 最大的块位于最高的非空链表中，链表内的块大小不同，需要遍历
+        uint32_t fl = 63 - static_cast<uint32_t>(__builtin_clzll(fl_bitmap_));
+        uint32_t sl = 31 - static_cast<uint32_t>(__builtin_clz(sl_bitmap_[fl]));
+        for (int32_t block = heads_[fl][sl]; block != NIL; block = blocks_[block].next_free) {
+            result.largest_free = std::max(result.largest_free, blocks_[block].size);
+        }
+    }
+    return result;
+}
+
+// --- TLSF ---
+
+void HeapAllocator::mapping(uint64_t size, uint32_t& fl, uint32_t& sl) {
+    if (size < (1ULL << FL_SHIFT)) {
+        fl = 0;
+        sl = static_cast<uint32_t>(size / ((1ULL << FL_SHIFT) / SL_COUNT));
+        return;
+    }
+    uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+    sl = static_cast<uint32_t>(size >> (msb - SL_LOG2)) ^ SL_COUNT;
+    fl = msb - FL_SHIFT + 1;
+}
+
+int32_t HeapAllocator::new_block(uint64_t offset, uint64_t size) {
+    TlsfBlock block{offset, size, 0, true, NIL, NIL, NIL, NIL};
+    if (!spare_blocks_.empty()) {
+        int32_t idx = spare_blocks_.back();
+        spare_blocks_.pop_back();
+        blocks_[idx] = block;
+        return idx;
+    }
+    blocks_.push_back(block);
+    return static_cast<int32_t>(blocks_.size() - 1);
+}
+
+void HeapAllocator::insert_free(int32_t block) {
+    uint32_t fl, sl;
+    mapping(blocks_[block].size, fl, sl);
+    TlsfBlock& b = blocks_[block];
+    b.free = true;
+    b.prev_free = NIL;
+    b.next_free = heads_[fl][sl];
+    if (b.next_free != NIL) {
+        blocks_[b.next_free].prev_free = block;
+    }
+    heads_[fl][sl] = block;
+    fl_bitmap_ |= 1ULL << fl;
+    sl_bitmap_[fl] |= 1u << sl;
+    ++tlsf_free_count_;
+}
+
+void HeapAllocator::remove_free(int32_t block) {
+    uint32_t fl, sl;
+    mapping(blocks_[block].size, fl, sl);
+    TlsfBlock& b = blocks_[block];
+    if (b.prev_free != NIL) {
+        blocks_[b.prev_free].next_free = b.next_free;
+    } else {
+        heads_[fl][sl] = b.next_free;
+    }
+    if (b.next_free != NIL) {
+        blocks_[b.next_free].prev_free = b.prev_free;
+    }
+    if (heads_[fl][sl] == NIL) {
+        sl_bitmap_[fl] &= ~(1u << sl);
+        if (sl_bitmap_[fl] == 0) {
+            fl_bitmap_ &= ~(1ULL << fl);
+        }
+    }
+    b.free = false;
+    --tlsf_free_count_;
+}
+
+int32_t HeapAllocator::find_suitable(uint64_t size) {
+    // 向上取整到下一个二级区间的起点，该链表以及更高链表中的任何块都足够大
+    if (size >= (1ULL << FL_SHIFT)) {
+        uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+        size += (1ULL << (msb - SL_LOG2)) - 1;
+    }
+    uint32_t fl, sl;
+    mapping(size, fl, sl);
+    if (fl >= FL_COUNT) {
+        return NIL;
+    }
+    uint32_t sl_map = sl_bitmap_[fl] & (~0u << sl);
+    if (sl_map == 0) {
+        uint64_t fl_map = fl + 1 < 64 ? fl_bitmap_ & (~0ULL << (fl + 1)) : 0;
+        if (fl_map == 0) {
+            return NIL;
+        }
+        fl = static_cast<uint32_t>(__builtin_ctzll(fl_map));
+        sl_map = sl_bitmap_[fl];
+    }
+    sl = static_cast<uint32_t>(__builtin_ctz(sl_map));
+    return heads_[fl][sl];
+}
+
+void HeapAllocator::absorb_into_prev(int32_t block) {
+    int32_t prev = blocks_[block].prev_phys;
+    int32_t next = blocks_[block].next_phys;
+    blocks_[prev].size += blocks_[block].size;
+    blocks_[prev].next_phys = next;
+    if (next != NIL) {
+        blocks_[next].prev_phys = prev;
+    }
+    if (last_block_ == block) {
+        last_block_ = prev;
+    }
+    spare_blocks_.push_back(block);
+}
+
+std::optional<uint64_t> HeapAllocator::tlsf_allocate(uint64_t size, uint64_t requested) {
+    int32_t block = find_suitable(size);
+    if (block == NIL) {
+        return std::nullopt;
+    }
+    remove_free(block);
+    if (blocks_[block].size - size >= ALIGNMENT) {
+        // 多余的部分作为新的空闲块
+        int32_t rest = new_block(blocks_[block].offset + size, blocks_[block].size - size);
+        blocks_[rest].prev_phys = block;
+        blocks_[rest].next_phys = blocks_[block].next_phys;
+        if (blocks_[rest].next_phys != NIL) {
+            blocks_[blocks_[rest].next_phys].prev_phys = rest;
+        }
+        blocks_[block].next_phys = rest;
+        blocks_[block].size = size;
+        if (last_block_ == block) {
+            last_block_ = rest;
+        }
+        insert_free(rest);
+    }
+    blocks_[block].requested = requested;
+    tlsf_used_[blocks_[block].offset] = block;
+    return blocks_[block].offset;
+}
+
+bool HeapAllocator::tlsf_free(uint64_t offset) {
+    auto it = tlsf_used_.find(offset);
+    if (it == tlsf_used_.end()) {
+        return false;
+    }
+    int32_t block = it->second;
+    tlsf_used_.erase(it);
+    blocks_[block].requested = 0;
+
+    int32_t next = blocks_[block].next_phys;
+    if (next != NIL && blocks_[next].free) {
+        remove_free(next);
+        absorb_into_prev(next);
+    }
+    int32_t prev = blocks_[block].prev_phys;
+    if (prev != NIL && blocks_[prev].free) {
+        remove_free(prev);
+        absorb_into_prev(block);
+        block = prev;
+    }
+    insert_free(block);
+    return true;
+}
@@ -1,33 +1,93 @@
 #include "memory/memory_manager.h"
+#include "fs/fs_manager.h"
 #include <iostream>
 #include <cstring>
 #include <algorithm>
 
-MemoryManager::MemoryManager() : memory_pool(nullptr), used_memory(0), current_strategy(MemoryAllocationStrategy::CONTINUOUS) {
+MemoryManager::MemoryManager(MemoryBackingMode backing_mode)
+    : backing_mode(backing_mode), placement_policy(PlacementPolicy::FIRST_FIT), used_memory(0), current_strategy(MemoryAllocationStrategy::CONTINUOUS), page_frames(TOTAL_PAGES), page_table_layout(PageTableLayout::FLAT), retired_page_walks(0),
+      occupancy(MEMORY_SIZE),
+      demand_paging(false), frame_limit(0), cached_stats_pid(-1), cached_stats(nullptr),
+      huge_pages_enabled(false), huge_allocations(0), huge_promotions(0), huge_splits(0), promotion_cursor(-1),
+      page_merging_enabled(false), merge_cursor(0),
+      writeback_queue_limit(64), swap_outs(0), swap_ins(0), swap_queue_hits(0), writebacks_completed(0),
+      compressed_pool(COMPRESSED_POOL_DEFAULT_LIMIT), compressed_swap_enabled(false), compressed_faults(0), compressed_fault_ns(0), disk_faults(0), disk_fault_ns(0),
+      cow_copies(0), virtual_copy_runs(0), next_shm_id(1), heap_policy(HeapPolicy::TLSF), migration_cursor(0), compacted_blocks(0), compacted_bytes(0),
+      buddy(MEMORY_SIZE, PAGE_SIZE), buddy_allocated_bytes(0), buddy_requested_bytes(0) {
+    memory_groups.emplace(ROOT_MEMORY_GROUP, MemoryGroup{ROOT_MEMORY_GROUP, "root", 0, 0, 0, 0, 0, 0, {}});
+    next_memory_group_id = ROOT_MEMORY_GROUP + 1;
     initialize();
 }
 
-MemoryManager::~MemoryManager() {
-    delete[] memory_pool;
-}
+MemoryManager::~MemoryManager() = default;
 
 void MemoryManager::initialize() {
-    // 实际分配内存
-    memory_pool = new (std::nothrow) char[MEMORY_SIZE];
-    if (memory_pool == nullptr) {
-        throw std::runtime_error("Failed to allocate memory for the main memory pool.");
-    }
+    // 预留内存池（重复初始化时会先释放旧的内存池）
+    memory_pool.reserve(MEMORY_SIZE, backing_mode);
 
     // 初始化连续分配的空闲列表
-    free_list.clear();
-    free_list.push_back({0, MEMORY_SIZE});
+    free_list.reset(0, MEMORY_SIZE);
+    continuous_blocks.clear();
+    occupancy.reset();
+    compacted_blocks = 0;
+    compacted_bytes = 0;
     
     // 初始化分区
     initialize_partitions();
     
     // 初始化分页管理
     page_frames.reset(); // 所有页框初始为空闲
+    frame_owners.clear();
     page_tables.clear();
+    retired_page_walks = 0;
+    page_replacer.clear();
+    for (const auto& entry : swapped_pages) {
+        swap_area.free_slot(entry.second);
+    }
+    swapped_pages.clear();
+    writeback_pending.clear();
+    writeback_queue.clear();
+    compressed_pages.clear();
+    compressed_pool.clear();
+    shared_frames.clear();
+    cow_copies = 0;
+    huge_allocations = 0;
+    huge_promotions = 0;
+    huge_splits = 0;
+    promotion_cursor = -1;
+    merge_cursor = 0;
+    merged_frames.clear();
+    merged_by_hash.clear();
+    merge_candidates.clear();
+    merge_stats = PageMergingStats();
+    shared_segments.clear();
+    shm_frame_owner.clear();
+    next_shm_id = 1;
+    mapped_files.clear();
+    file_pages.clear();
+    file_frame_owner.clear();
+    heaps.clear();
+    tlb.flush_all();
+    reset_page_fault_stats();
+
+    migration = MigrationStatus();
+    migration_entries.clear();
+
+    // 保留控制组及其限制，清空计费
+    process_groups.clear();
+    process_charges.clear();
+    for (auto& entry : memory_groups) {
+        entry.second.usage = 0;
+        entry.second.members.clear();
+    }
+    migration_cursor = 0;
+
+    // 初始化伙伴系统
+    buddy.reset();
+    buddy_blocks.clear();
+    buddy_owner.clear();
+    buddy_allocated_bytes = 0;
+    buddy_requested_bytes = 0;
     
     used_memory = 0;
     std::cout << "Memory manager initialized with " << MEMORY_SIZE / (1024*1024) << " MB of memory." << std::endl;
@@ -42,52 +102,82 @@ MemoryAllocationStrategy MemoryManager::get_allocation_strategy() const {
     return current_strategy;
 }
 
+void MemoryManager::set_placement_policy(PlacementPolicy policy) {
+    placement_policy = policy;
+}
+
+PlacementPolicy MemoryManager::get_placement_policy() const {
+    return placement_policy;
+}
+
+// 默认分区布局（固定分区算法），覆盖 0 - 3.18GB，剩余空间留给连续分配
+static const std::vector<PartitionSpec> DEFAULT_PARTITION_LAYOUT = {
+    {256 * 1024, 16},                 // 小分区: 256KB * 16 = 4MB
+    {1024 * 1024, 64},                // 中分区: 1MB * 64 = 64MB
+    {4 * 1024 * 1024, 16},            // 大分区: 4MB * 16 = 64MB
+    {32 * 1024 * 1024, 32},           // 超大分区: 32MB * 32 = 1024MB
+    {64ULL * 1024 * 1024, 16},        // 巨型分区: 64MB * 16 = 1024MB
+    {128ULL * 1024 * 1024, 8}         // 超巨型分区: 128MB * 8 = 1024MB
+};
+
 void MemoryManager::initialize_partitions() {
-    partitions.clear();
-    
-    // 创建不同大小的分区（固定分区算法）
-    // 小分区: 256KB * 16 = 4MB
-    for (int i = 0; i < 16; ++i) {
-        partitions.emplace_back(i * 256 * 1024, 256 * 1024);
-    }
-    
-    // 中分区: 1MB * 64 = 64MB  
-    for (int i = 0; i < 64; ++i) {
-        uint64_t base = 4 * 1024 * 1024 + i * 1024 * 1024;
-        partitions.emplace_back(base, 1024 * 1024);
+    if (partition_layout.empty()) {
+        partition_layout = DEFAULT_PARTITION_LAYOUT;
     }
-    
-    // 大分区: 4MB * 16 = 64MB
-    for (int i = 0; i < 16; ++i) {
-        uint64_t base = 68 * 1024 * 1024 + i * 4 * 1024 * 1024;
-        partitions.emplace_back(base, 4 * 1024 * 1024);
-    }
-    
-    // 超大分区: 32MB * 32 = 1024MB
-    for (int i = 0; i < 32; ++i) {
-        uint64_t base = 132 * 1024 * 1024 + i * 32 * 1024 * 1024;
-        partitions.emplace_back(base, 32 * 1024 * 1024);
+
+    partitions.clear();
+    free_partitions_by_size.clear();
+    partitions_by_pid.clear();
+
+    uint64_t base = 0;
+    for (const auto& spec : partition_layout) {
+        for (uint32_t i = 0; i < spec.count; ++i) {
+            free_partitions_by_size[spec.size].insert(partitions.size());
+            partitions.emplace_back(base, spec.size);
+            base += spec.size;
+        }
     }
     
-    // 巨型分区: 64MB * 16 = 1024MB (覆盖 1.156GB - 2.18GB 区间)
-    for (int i = 0; i < 16; ++i) {
-        uint64_t base = 1156ULL * 1024 * 1024 + static_cast<uint64_t>(i) * 64ULL * 1024 * 1024;
-        partitions.emplace_back(base, 64ULL * 1024 * 1024);
+    std::cout << "Initialized " << partitions.size() << " memory partitions." << std::endl;
+}
+
+bool MemoryManager::set_partition_layout(const std::vector<PartitionSpec>& layout) {
+    if (!partitions_by_pid.empty()) {
+        return false; // 仍有分区被占用
     }
-    
-    // 超巨型分区: 128MB * 8 = 1024MB (覆盖 2.18GB - 3.18GB)
-    for (int i = 0; i < 8; ++i) {
-        uint64_t base = 2180ULL * 1024 * 1024 + static_cast<uint64_t>(i) * 128ULL * 1024 * 1024;
-        partitions.emplace_back(base, 128ULL * 1024 * 1024);
+    uint64_t total = 0;
+    for (const auto& spec : layout) {
+        if (spec.size == 0 || spec.count == 0) {
+            return false;
+        }
+        total += spec.size * spec.count;
+        if (total > MEMORY_SIZE) {
+            return false;
+        }
     }
-    
-    // 预留剩余空间为连续分配使用
-    
-    std::cout << "Initialized " << partitions.size() << " memory partitions." << std::endl;
+    partition_layout = layout.empty() ? DEFAULT_PARTITION_LAYOUT : layout;
+    initialize_partitions();
+    return true;
+}
+
+const std::vector<PartitionSpec>& MemoryManager::get_partition_layout() const {
+    return partition_layout;
 }
 
 char* MemoryManager::get_memory_pool_ptr() {
-    return memory_pool;
+    return memory_pool.data();
+}
+
+MemoryBackingMode MemoryManager::get_backing_mode() const {
+    return memory_pool.mode();
+}
+
+uint64_t MemoryManager::get_reserved_memory() const {
+    return memory_pool.reserved_bytes();
+}
+
+uint64_t MemoryManager::get_committed_memory() const {
+    return memory_pool.committed_bytes();
 }
 
 std::optional<MemoryBlock> MemoryManager::allocate(uint64_t size) {
@@ -98,110 +188,428 @@ std::optional<MemoryBlock> MemoryManager::allocate_for_process(ProcessID pid, ui
     if (size == 0) {
         return std::nullopt;
     }
+    if (pid >= 0 && !try_charge(pid, size)) {
+        return std::nullopt; // 超出所属组的硬限制
+    }
 
-    switch (current_strategy) {
+    auto block = allocate_with(current_strategy, pid, size);
+    if (pid >= 0) {
+        // 先按请求大小计费，分配成功后按实际块大小修正
+        if (!block) {
+            uncharge(pid, size);
+        } else if (block->size > size) {
+            charge(pid, block->size - size);
+        } else {
+            uncharge(pid, size - block->size);
+        }
+    }
+    if (block && pid >= 0) {
+        track_migrating_process(pid, size, {*block});
+    }
+    return block;
+}
+
+std::optional<MemoryBlock> MemoryManager::allocate_with(MemoryAllocationStrategy strategy, ProcessID pid, uint64_t size) {
+    switch (strategy) {
         case MemoryAllocationStrategy::CONTINUOUS:
-            return allocate_continuous(size);
+            return allocate_continuous(pid, size);
             
         case MemoryAllocationStrategy::PARTITIONED:
             return allocate_partitioned(pid, size);
             
         case MemoryAllocationStrategy::PAGED:
             return allocate_paged(pid, size);
+
+        case MemoryAllocationStrategy::BUDDY:
+            return allocate_buddy(pid, size);
             
         default:
             return std::nullopt;
     }
 }
 
-std::optional<MemoryBlock> MemoryManager::allocate_continuous(uint64_t size) {
-    for (auto it = free_list.begin(); it != free_list.end(); ++it) {
-        if (it->size >= size) {
-            uint64_t base_address = it->base_address;
-            it->base_address += size;
-            it->size -= size;
-            if (it->size == 0) {
-                free_list.erase(it);
+void MemoryManager::release_with(MemoryAllocationStrategy strategy, ProcessID pid, const std::vector<MemoryBlock>& blocks) {
+    switch (strategy) {
+        case MemoryAllocationStrategy::CONTINUOUS:
+            for (const auto& block : blocks) {
+                free_continuous_memory(block.base_address, block.size);
             }
-            used_memory += size;
-            return MemoryBlock{base_address, size};
+            break;
+
+        case MemoryAllocationStrategy::PARTITIONED:
+            free_partitioned_memory(pid);
+            break;
+
+        case MemoryAllocationStrategy::PAGED:
+            free_pages_for_process(pid);
+            break;
+
+        case MemoryAllocationStrategy::BUDDY:
+            free_buddy_memory(pid);
+            break;
+    }
+}
+
+bool MemoryManager::begin_strategy_migration(MemoryAllocationStrategy target, const std::vector<MigrationEntry>& processes) {
+    if (migration.state == MigrationState::PLANNING || target == current_strategy) {
+        return false;
+    }
+    migration = MigrationStatus();
+    migration.state = MigrationState::PLANNING;
+    migration.from = current_strategy;
+    migration.to = target;
+    migration_entries.clear();
+    migration_cursor = 0;
+    for (const auto& entry : processes) {
+        track_migrating_process(entry.pid, entry.size, entry.old_blocks);
+    }
+    return true;
+}
+
+const MigrationStatus& MemoryManager::step_strategy_migration(size_t max_processes) {
+    if (migration.state != MigrationState::PLANNING) {
+        return migration;
+    }
+    // 两种策略的管理结构相互独立，预分配期间新旧分配同时存在
+    for (size_t n = 0; n < max_processes && migration_cursor < migration_entries.size(); ++n) {
+        MigrationEntry& entry = migration_entries[migration_cursor];
+        entry.new_block = allocate_with(migration.to, entry.pid, entry.size);
+        if (!entry.new_block) {
+            migration.failed_pid = entry.pid;
+            abort_strategy_migration();
+            return migration;
         }
+        migration.planned_bytes += entry.new_block->size;
+        ++migration.planned_processes;
+        ++migration_cursor;
+    }
+    if (migration_cursor < migration_entries.size()) {
+        return migration;
     }
-    return std::nullopt;
+
+    for (const auto& entry : migration_entries) {
+        release_with(migration.from, entry.pid, entry.old_blocks);
+    }
+    current_strategy = migration.to;
+    migration.state = MigrationState::COMMITTED;
+    std::cout << "Memory allocation strategy migrated to: " << static_cast<int>(current_strategy) << std::endl;
+    return migration;
 }
 
-std::optional<MemoryBlock> MemoryManager::allocate_partitioned(ProcessID pid, uint64_t size) {
-    // 找到合适大小的最小分区
-    Partition* best_partition = nullptr;
-    for (auto& partition : partitions) {
-        if (partition.is_free && partition.size >= size) {
-            if (best_partition == nullptr || partition.size < best_partition->size) {
-                best_partition = &partition;
-            }
+bool MemoryManager::abort_strategy_migration() {
+    if (migration.state != MigrationState::PLANNING) {
+        return false;
+    }
+    for (size_t i = 0; i < migration_cursor; ++i) {
+        const MigrationEntry& entry = migration_entries[i];
+        release_with(migration.to, entry.pid, {*entry.new_block});
+    }
+    for (auto& entry : migration_entries) {
+        entry.new_block.reset();
+    }
+    migration_cursor = 0;
+    migration.planned_processes = 0;
+    migration.planned_bytes = 0;
+    migration.state = MigrationState::ROLLED_BACK;
+    return true;
+}
+
+const MigrationStatus& MemoryManager::get_migration_status() const {
+    return migration;
+}
+
+const std::vector<MigrationEntry>& MemoryManager::get_migration_entries() const {
+    return migration_entries;
+}
+
+void MemoryManager::track_migrating_process(ProcessID pid, uint64_t size, const std::vector<MemoryBlock>& blocks) {
+    if (migration.state != MigrationState::PLANNING) {
+        return;
+    }
+    migration_entries.push_back({pid, size, blocks, std::nullopt});
+    ++migration.total_processes;
+}
+
+void MemoryManager::forget_migrating_process(ProcessID pid) {
+    if (migration.state != MigrationState::PLANNING) {
+        return;
+    }
+    for (size_t i = 0; i < migration_entries.size(); ++i) {
+        if (migration_entries[i].pid != pid) {
+            continue;
+        }
+        if (i < migration_cursor) {
+            // 已预分配的部分随进程一起释放
+            release_with(migration.to, pid, {*migration_entries[i].new_block});
+            migration.planned_bytes -= migration_entries[i].new_block->size;
+            --migration.planned_processes;
+            --migration_cursor;
         }
+        migration_entries.erase(migration_entries.begin() + i);
+        --migration.total_processes;
+        return;
     }
-    
-    if (best_partition != nullptr) {
-        best_partition->is_free = false;
-        best_partition->owner_pid = pid;
-        used_memory += best_partition->size;
-        return MemoryBlock{best_partition->base_address, best_partition->size};
+}
+
+std::optional<MemoryBlock> MemoryManager::allocate_continuous(ProcessID pid, uint64_t size) {
+    auto base_address = free_list.allocate(size, placement_policy);
+    if (!base_address && relocation_callback && free_list.total_free() >= size) {
+        // 空闲总量足够但没有足够大的空闲块，紧凑后空闲空间合并为一块
+        compact(UINT64_MAX);
+        base_address = free_list.allocate(size, placement_policy);
     }
-    
-    return std::nullopt;
+    if (!base_address) {
+        return std::nullopt;
+    }
+    continuous_blocks[*base_address] = ContinuousBlock{size, pid};
+    occupancy.add(*base_address, size, pid);
+    used_memory += size;
+    return MemoryBlock{*base_address, size};
+}
+
+uint64_t MemoryManager::compact(uint64_t max_bytes) {
+    if (migration.state == MigrationState::PLANNING) {
+        return 0; // 迁移计划记录了各进程的内存块地址
+    }
+    uint64_t moved = 0;
+    while (moved < max_bytes && !free_list.empty()) {
+        FreeBlock hole = free_list.front();
+        auto block = continuous_blocks.lower_bound(hole.base_address);
+        if (block == continuous_blocks.end() || block->first != hole.base_address + hole.size) {
+            break; // 最低的空闲块之上没有已分配块
+        }
+        uint64_t old_base = block->first;
+        uint64_t size = block->second.size;
+        ProcessID owner = block->second.owner;
+        uint64_t new_base = hole.base_address;
+
+        // 旧位置与下方的空闲块合并，再从合并后的空闲块低端切出新位置
+        free_list.release(old_base, size);
+        free_list.claim(new_base, size);
+        move_pool_bytes(new_base, old_base, size);
+        memory_pool.decommit(new_base + size, old_base - new_base);
+        continuous_blocks.erase(block);
+        continuous_blocks[new_base] = ContinuousBlock{size, owner};
+        occupancy.remove(old_base, size, owner);
+        occupancy.add(new_base, size, owner);
+        if (relocation_callback) {
+            relocation_callback(old_base, new_base, size);
+        }
+        ++compacted_blocks;
+        compacted_bytes += size;
+        moved += size;
+    }
+    return moved;
+}
+
+void MemoryManager::move_pool_bytes(uint64_t destination, uint64_t source, uint64_t size) {
+    // 目标在源之下，按地址递增逐段复制，重叠时也不会覆盖尚未复制的内容；
+    // 每段不跨越源的提交粒度，未提交的段读取为 0，目标也未提交时不必写入
+    const uint64_t granule = BackingStore::COMMIT_GRANULE;
+    std::vector<char> buffer(granule);
+    uint64_t offset = 0;
+    while (offset < size) {
+        uint64_t src = source + offset;
+        uint64_t chunk = std::min(size - offset, granule - src % granule);
+        uint64_t dst = destination + offset;
+        if (memory_pool.is_committed(src)) {
+            memory_pool.read(src, buffer.data(), chunk);
+            memory_pool.write(dst, buffer.data(), chunk);
+        } else if (memory_pool.is_committed(dst) || memory_pool.is_committed(dst + chunk - 1)) {
+            std::fill(buffer.begin(), buffer.begin() + chunk, '\0');
+            memory_pool.write(dst, buffer.data(), chunk);
+        }
+        offset += chunk;
+    }
+}
+
+bool MemoryManager::is_compacted() const {
+    return free_list.empty() || continuous_blocks.lower_bound(free_list.front().base_address) == continuous_blocks.end();
+}
+
+void MemoryManager::set_relocation_callback(RelocationCallback callback) {
+    relocation_callback = std::move(callback);
+}
+
+FragmentationStats MemoryManager::get_fragmentation_stats() const {
+    FragmentationStats stats;
+    stats.free_bytes = free_list.total_free();
+    stats.free_blocks = free_list.size();
+    stats.largest_free_block = free_list.largest_block();
+    if (stats.free_bytes > 0) {
+        stats.external_fragmentation = 1.0 - static_cast<double>(stats.largest_free_block) / stats.free_bytes;
+    }
+    stats.compacted_blocks = compacted_blocks;
+    stats.compacted_bytes = compacted_bytes;
+    return stats;
+}
+
+std::optional<MemoryBlock> MemoryManager::allocate_partitioned(ProcessID pid, uint64_t size) {
+    // 找到能容纳请求的最小大小类别，取其中下标最小的空闲分区
+    auto size_class = free_partitions_by_size.lower_bound(size);
+    if (size_class == free_partitions_by_size.end()) {
+        return std::nullopt;
+    }
+
+    size_t index = *size_class->second.begin();
+    size_class->second.erase(size_class->second.begin());
+    if (size_class->second.empty()) {
+        free_partitions_by_size.erase(size_class);
+    }
+
+    Partition& partition = partitions[index];
+    partition.is_free = false;
+    partition.owner_pid = pid;
+    partitions_by_pid[pid].push_back(index);
+    occupancy.add(partition.base_address, partition.size, pid);
+    used_memory += partition.size;
+    return MemoryBlock{partition.base_address, partition.size};
 }
 
 std::optional<MemoryBlock> MemoryManager::allocate_paged(ProcessID pid, uint64_t size) {
     uint64_t pages_needed = (size + PAGE_SIZE - 1) / PAGE_SIZE; // 向上取整
+    // 挂接交换区后驻留页面也参与置换，页框不足时换出其他页面腾出空间
+    bool swappable = swap_area.is_attached();
     
-    if (pages_needed > (TOTAL_PAGES - page_frames.count())) {
+    if (!demand_paging && !swappable && pages_needed > page_frames.free_count()) {
         return std::nullopt; // 没有足够的页框
     }
+    // 新分配的页面本身也可以换出，只要有一个页框可用即可超额分配
+    if (!demand_paging && swappable) {
+        uint64_t limit = frame_limit == 0 ? TOTAL_PAGES : frame_limit;
+        uint64_t available = page_frames.used_count() < limit ? limit - page_frames.used_count() : 0;
+        if (available + page_replacer.size() == 0) {
+            return std::nullopt; // 没有空闲页框，也没有可换出的页面
+        }
+    }
     
     // 为进程创建页表（如果不存在）
-    if (page_tables.find(pid) == page_tables.end()) {
-        page_tables.emplace(pid, ProcessPageTable(pid));
+    auto it = page_tables.find(pid);
+    if (it == page_tables.end()) {
+        it = page_tables.emplace(pid, ProcessPageTable(pid, page_table_layout)).first;
     }
     
-    auto& page_table = page_tables[pid];
-    uint64_t virtual_base = page_table.pages.size() * PAGE_SIZE;
+    auto& page_table = it->second;
+    if (page_table.page_count + pages_needed > page_table.table.max_pages()) {
+        return std::nullopt; // 超出页表可映射的虚拟地址空间
+    }
+    uint64_t first_page = page_table.page_count;
+    uint64_t virtual_base = first_page * PAGE_SIZE;
+
+    if (demand_paging) {
+        // 只扩大虚拟地址空间，页框在首次访问时分配
+        page_table.vmas.insert(Vma{first_page, pages_needed, VMA_PROT_READ | VMA_PROT_WRITE, VmaKind::ANONYMOUS, -1});
+        page_table.page_count += pages_needed;
+        return MemoryBlock{virtual_base, pages_needed * PAGE_SIZE};
+    }
     
     // 分配所需的页框
     for (uint64_t i = 0; i < pages_needed; ++i) {
-        uint64_t frame = allocate_free_frame();
+        uint64_t page_number = first_page + i;
+        if (huge_pages_enabled && page_number % HUGE_PAGE_FRAMES == 0 && pages_needed - i >= HUGE_PAGE_FRAMES) {
+            // 对齐的 2MB 虚拟区间整体映射到一个大页；没有对齐的连续页框时退回普通页
+            uint64_t first_frame = allocate_huge_frame();
+            if (first_frame != UINT64_MAX) {
+                page_table.table.map_huge(page_number / HUGE_PAGE_FRAMES, first_frame);
+                for (uint64_t k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+                    set_frame_owner(first_frame + k, pid, page_number + k);
+                }
+                used_memory += HUGE_PAGE_SIZE;
+                ++huge_allocations;
+                i += HUGE_PAGE_FRAMES - 1;
+                continue;
+            }
+        }
+        uint64_t frame = swappable ? obtain_frame() : allocate_free_frame();
         if (frame == UINT64_MAX) {
-            // 分配失败，需要回滚已分配的页框
+            // 分配失败，需要回滚已分配的页框（其中一部分可能已被换出）
             for (uint64_t j = 0; j < i; ++j) {
-                free_frame(page_table.pages[page_table.pages.size() - 1 - j].frame_number);
-                page_table.pages.pop_back();
+                PageTableEntry* pte = page_table.table.find(first_page + j);
+                if (pte == nullptr) {
+                    continue;
+                }
+                if (pte->huge) {
+                    for (uint64_t k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+                        free_frame(pte->frame_number + k);
+                    }
+                    page_table.table.unmap_huge((first_page + j) / HUGE_PAGE_FRAMES);
+                    used_memory -= HUGE_PAGE_SIZE;
+                    j += HUGE_PAGE_FRAMES - 1;
+                    continue;
+                }
+                page_replacer.erase(pte->frame_number);
+                free_frame(pte->frame_number);
+                page_table.table.unmap(first_page + j);
+                used_memory -= PAGE_SIZE;
             }
+            drop_swapped_pages(pid, first_page);
             return std::nullopt;
         }
-        
-        PageTableEntry pte;
-        pte.valid = true;
-        pte.frame_number = frame;
-        page_table.pages.push_back(pte);
+        if (swappable) {
+            // 干净页面换出时直接丢弃、再次调入时为全 0，页框中残留的旧内容必须先清除
+            if (memory_pool.is_committed(frame * PAGE_SIZE)) {
+                static const std::string zero_page(PAGE_SIZE, '\0');
+                memory_pool.write(frame * PAGE_SIZE, zero_page.data(), PAGE_SIZE);
+            }
+            page_replacer.insert(frame, pid, page_number);
+        }
+        page_table.table.map(page_number, frame);
+        set_frame_owner(frame, pid, page_number);
+        used_memory += PAGE_SIZE;
     }
     
-    used_memory += pages_needed * PAGE_SIZE;
+    page_table.vmas.insert(Vma{first_page, pages_needed, VMA_PROT_READ | VMA_PROT_WRITE, VmaKind::ANONYMOUS, -1});
+    page_table.page_count += pages_needed;
     return MemoryBlock{virtual_base, pages_needed * PAGE_SIZE};
 }
 
+std::optional<MemoryBlock> MemoryManager::allocate_buddy(ProcessID pid, uint64_t size) {
+    auto base_address = buddy.allocate(size);
+    if (!base_address) {
+        return std::nullopt;
+    }
+    uint64_t block_size = buddy.block_size(*base_address);
+    buddy_blocks[pid].push_back({*base_address, block_size, size});
+    buddy_owner[*base_address] = pid;
+    buddy_allocated_bytes += block_size;
+    buddy_requested_bytes += size;
+    occupancy.add(*base_address, block_size, pid);
+    used_memory += block_size;
+    return MemoryBlock{*base_address, block_size};
+}
+
 uint64_t MemoryManager::allocate_free_frame() {
-    for (uint64_t i = 0; i < TOTAL_PAGES; ++i) {
-        if (!page_frames[i]) {
-            page_frames[i] = true;
-            return i;
-        }
+    uint64_t frame = page_frames.allocate(); // 没有空闲页框时返回 UINT64_MAX
+    if (frame != UINT64_MAX) {
+        occupancy.add(frame * PAGE_SIZE, PAGE_SIZE, -1); // 映射进进程时再记到进程名下
     }
-    return UINT64_MAX; // 没有空闲页框
+    return frame;
 }
 
 void MemoryManager::free_frame(uint64_t frame_number) {
-    if (frame_number < TOTAL_PAGES) {
-        page_frames[frame_number] = false;
+    if (!page_frames.clear(frame_number)) {
+        return;
+    }
+    ProcessID owner = -1;
+    if (frame_number < frame_owners.size()) {
+        owner = frame_owners[frame_number].pid;
+        frame_owners[frame_number].pid = -1;
+    }
+    occupancy.remove(frame_number * PAGE_SIZE, PAGE_SIZE, owner);
+}
+
+void MemoryManager::set_frame_owner(uint64_t frame_number, ProcessID pid, uint64_t page_number) {
+    if (frame_number >= frame_owners.size()) {
+        // 页框从低地址开始分配，按倍数扩大，只映射少量页框时不占用完整的数组
+        uint64_t size = std::min<uint64_t>(TOTAL_PAGES, std::max<uint64_t>(frame_number + 1, frame_owners.size() * 2));
+        frame_owners.resize(size, ResidentPage{-1, 0});
+    }
+    ProcessID previous = frame_owners[frame_number].pid;
+    if (previous != pid) {
+        occupancy.remove(frame_number * PAGE_SIZE, PAGE_SIZE, previous);
+        occupancy.add(frame_number * PAGE_SIZE, PAGE_SIZE, pid);
     }
+    frame_owners[frame_number] = ResidentPage{pid, page_number};
 }
 
 bool MemoryManager::free(uint64_t base_address, uint64_t size) {
@@ -209,68 +617,117 @@ bool MemoryManager::free(uint64_t base_address, uint64_t size) {
         return free_continuous_memory(base_address, size);
     }
     
+    if (current_strategy == MemoryAllocationStrategy::BUDDY) {
+        return free_buddy_block(base_address);
+    }
+    
     // 对于分区和分页方式，需要更复杂的释放逻辑
     return false;
 }
 
 bool MemoryManager::free_continuous_memory(uint64_t base_address, uint64_t size) {
-    if (size == 0) {
+    if (size == 0 || base_address + size > MEMORY_SIZE) {
         return false;
     }
-    
-    used_memory -= size;
-
-    // Add the new free block
-    free_list.push_back({base_address, size});
-    
-    // Sort to bring adjacent blocks together
-    free_list.sort([](const FreeBlock& a, const FreeBlock& b) {
-        return a.base_address < b.base_address;
-    });
-
-    // Merge adjacent blocks
-    auto it = free_list.begin();
-    while (it != free_list.end()) {
-        auto next_it = std::next(it);
-        if (next_it == free_list.end()) {
-            break; 
-        }
 
-        if (it->base_address + it->size == next_it->base_address) {
-            it->size += next_it->size;
-            free_list.erase(next_it);
-        } else {
-            ++it;
+    // 插入地址索引并与相邻空闲块合并
+    if (!free_list.release(base_address, size)) {
+        return false;
+    }
+    auto block = continuous_blocks.find(base_address);
+    ProcessID owner = -1;
+    if (block != continuous_blocks.end()) {
+        owner = block->second.owner;
+        if (block->second.size > size) {
+            continuous_blocks[base_address + size] = ContinuousBlock{block->second.size - size, owner}; // 只释放了块的前一部分
         }
+        continuous_blocks.erase(block);
     }
-
+    occupancy.remove(base_address, size, owner);
+    used_memory -= size;
+    memory_pool.decommit(base_address, size);
     return true;
 }
 
 bool MemoryManager::free_process_memory(ProcessID pid) {
+    forget_migrating_process(pid);
+    release_memory_group(pid);
     switch (current_strategy) {
         case MemoryAllocationStrategy::PARTITIONED:
             return free_partitioned_memory(pid);
             
         case MemoryAllocationStrategy::PAGED:
             return free_pages_for_process(pid);
+
+        case MemoryAllocationStrategy::BUDDY:
+            return free_buddy_memory(pid);
             
         default:
             return false; // 连续分配需要明确的地址和大小
     }
 }
 
-bool MemoryManager::free_partitioned_memory(ProcessID pid) {
-    bool freed_any = false;
-    for (auto& partition : partitions) {
-        if (!partition.is_free && partition.owner_pid == pid) {
-            partition.is_free = true;
-            partition.owner_pid = -1;
-            used_memory -= partition.size;
-            freed_any = true;
+bool MemoryManager::free_buddy_block(uint64_t base_address) {
+    auto owner_it = buddy_owner.find(base_address);
+    if (owner_it == buddy_owner.end()) {
+        return false;
+    }
+    auto pid_it = buddy_blocks.find(owner_it->second);
+    buddy_owner.erase(owner_it);
+
+    auto& blocks = pid_it->second;
+    for (auto blk = blocks.begin(); blk != blocks.end(); ++blk) {
+        if (blk->base_address == base_address) {
+            buddy.free(base_address);
+            buddy_allocated_bytes -= blk->block_size;
+            buddy_requested_bytes -= blk->requested_size;
+            occupancy.remove(base_address, blk->block_size, pid_it->first);
+            used_memory -= blk->block_size;
+            memory_pool.decommit(base_address, blk->block_size);
+            blocks.erase(blk);
+            break;
         }
     }
-    return freed_any;
+    if (blocks.empty()) {
+        buddy_blocks.erase(pid_it);
+    }
+    return true;
+}
+
+bool MemoryManager::free_buddy_memory(ProcessID pid) {
+    auto it = buddy_blocks.find(pid);
+    if (it == buddy_blocks.end()) {
+        return false;
+    }
+    for (const auto& blk : it->second) {
+        buddy.free(blk.base_address);
+        buddy_owner.erase(blk.base_address);
+        buddy_allocated_bytes -= blk.block_size;
+        buddy_requested_bytes -= blk.requested_size;
+        occupancy.remove(blk.base_address, blk.block_size, pid);
+        used_memory -= blk.block_size;
+        memory_pool.decommit(blk.base_address, blk.block_size);
+    }
+    buddy_blocks.erase(it);
+    return true;
+}
+
+bool MemoryManager::free_partitioned_memory(ProcessID pid) {
+    auto it = partitions_by_pid.find(pid);
+    if (it == partitions_by_pid.end()) {
+        return false;
+    }
+    for (size_t index : it->second) {
+        Partition& partition = partitions[index];
+        partition.is_free = true;
+        partition.owner_pid = -1;
+        occupancy.remove(partition.base_address, partition.size, pid);
+        used_memory -= partition.size;
+        memory_pool.decommit(partition.base_address, partition.size);
+        free_partitions_by_size[partition.size].insert(index);
+    }
+    partitions_by_pid.erase(it);
+    return true;
 }
 
 bool MemoryManager::free_pages_for_process(ProcessID pid) {
@@ -282,14 +739,48 @@ bool MemoryManager::free_pages_for_process(ProcessID pid) {
     auto& page_table = it->second;
     uint64_t freed_memory = 0;
     
-    for (const auto& pte : page_table.pages) {
-        if (pte.valid) {
-            free_frame(pte.frame_number);
-            freed_memory += PAGE_SIZE;
+    std::vector<int> attached_segments;
+    page_table.table.for_each([&](uint64_t page_number, PageTableEntry& pte) {
+        if (pte.huge) {
+            for (uint64_t k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+                free_frame(pte.frame_number + k);
+            }
+            freed_memory += HUGE_PAGE_SIZE;
+            return;
         }
-    }
+        auto shm = shm_frame_owner.find(pte.frame_number);
+        if (shm != shm_frame_owner.end()) {
+            attached_segments.push_back(shm->second); // 共享内存页框归段所有
+            return;
+        }
+        if (file_frame_owner.count(pte.frame_number)) {
+            unmap_file_page(pte.frame_number, pid, page_number, pte.dirty); // 文件页归页缓存所有
+            return;
+        }
+        if (shared_frames.count(pte.frame_number)) {
+            release_shared_mapping(pte.frame_number, pid, page_number); // 其他进程仍在使用
+            return;
+        }
+        page_replacer.erase(pte.frame_number);
+        free_frame(pte.frame_number);
+        freed_memory += PAGE_SIZE;
+    });
     
+    retired_page_walks += page_table.table.walks();
     page_tables.erase(it);
+    heaps.erase(pid);
+    for (int shmid : attached_segments) {
+        auto segment = shared_segments.find(shmid);
+        if (segment != shared_segments.end() && segment->second.attachments.erase(pid)) {
+            release_shm_if_unused(shmid);
+        }
+    }
+    for (auto file = mapped_files.begin(); file != mapped_files.end();) {
+        file->second.mappers.erase(pid);
+        file = file->second.mappers.empty() ? mapped_files.erase(file) : std::next(file);
+    }
+    tlb.flush(pid);
+    drop_swapped_pages(pid, 0);
     used_memory -= freed_memory;
     return true;
 }
@@ -297,24 +788,33 @@ bool MemoryManager::free_pages_for_process(ProcessID pid) {
 uint64_t MemoryManager::get_process_base_address(ProcessID pid) const {
     switch (current_strategy) {
         case MemoryAllocationStrategy::PARTITIONED: {
-            for (const auto& partition : partitions) {
-                if (!partition.is_free && partition.owner_pid == pid) {
-                    return partition.base_address;
-                }
+            auto it = partitions_by_pid.find(pid);
+            if (it != partitions_by_pid.end() && !it->second.empty()) {
+                return partitions[it->second.front()].base_address;
             }
             break;
         }
         
         case MemoryAllocationStrategy::PAGED: {
             auto it = page_tables.find(pid);
-            if (it != page_tables.end() && !it->second.pages.empty()) {
-                // 返回首个物理页框的物理地址，方便前端显示
-                const auto& first_pte = it->second.pages.front();
-                return first_pte.frame_number * PAGE_SIZE;
+            if (it != page_tables.end()) {
+                // 返回首个物理页框的物理地址，方便前端显示（请求调页下首页可能尚未调入）
+                const PageTableEntry* first_pte = it->second.table.find(0);
+                if (first_pte != nullptr) {
+                    return first_pte->frame_number * PAGE_SIZE;
+                }
             }
             break;
         }
         
+        case MemoryAllocationStrategy::BUDDY: {
+            auto it = buddy_blocks.find(pid);
+            if (it != buddy_blocks.end() && !it->second.empty()) {
+                return it->second.front().base_address;
+            }
+            break;
+        }
+
         case MemoryAllocationStrategy::CONTINUOUS:
             // 连续分配需要从进程信息中获取，这里返回0作为默认值
             return 0;
@@ -323,85 +823,1886 @@ uint64_t MemoryManager::get_process_base_address(ProcessID pid) const {
     return UINT64_MAX; // 未找到
 }
 
-std::optional<uint64_t> MemoryManager::translate_virtual_to_physical(ProcessID pid, uint64_t virtual_address) const {
+std::optional<uint64_t> MemoryManager::translate_virtual_to_physical(ProcessID pid, uint64_t virtual_address, bool is_write) {
     if (current_strategy != MemoryAllocationStrategy::PAGED) {
         return virtual_address; // 非分页模式，虚拟地址即物理地址
     }
     
-    auto it = page_tables.find(pid);
-    if (it == page_tables.end()) {
-        return std::nullopt;
-    }
-    
     uint64_t page_number = virtual_address / PAGE_SIZE;
     uint64_t offset = virtual_address % PAGE_SIZE;
+
+    // TLB 命中时不查页表
+    if (auto frame = tlb.lookup(pid, page_number, is_write)) {
+        ++stats_for(pid).accesses;
+        ++total_fault_stats.accesses;
+        page_replacer.touch(*frame);
+        return *frame * PAGE_SIZE + offset;
+    }
     
-    const auto& page_table = it->second;
-    if (page_number >= page_table.pages.size() || !page_table.pages[page_number].valid) {
+    auto it = page_tables.find(pid);
+    if (it == page_tables.end()) {
         return std::nullopt;
     }
     
-    uint64_t frame_number = page_table.pages[page_number].frame_number;
-    return frame_number * PAGE_SIZE + offset;
-}
-
-const std::list<FreeBlock>& MemoryManager::get_free_blocks() const {
-    return free_list;
-}
-
-std::vector<Partition> MemoryManager::get_partitions() const {
-    return partitions;
-}
+    auto& page_table = it->second;
+    const Vma* vma = page_table.vmas.find(page_number);
+    if (vma == nullptr || (vma->prot & (is_write ? VMA_PROT_WRITE : VMA_PROT_READ)) == 0) {
+        return std::nullopt; // 未映射或权限不足
+    }
+    bool writable = (vma->prot & VMA_PROT_WRITE) != 0;
 
-uint64_t MemoryManager::get_total_memory() const {
-    return MEMORY_SIZE;
-}
+    ++stats_for(pid).accesses;
+    ++total_fault_stats.accesses;
+    PageTableEntry* pte = page_table.table.find(page_number);
+    if (pte == nullptr) {
+        pte = vma->kind == VmaKind::FILE ? fault_file_page(page_table, *vma, page_number) : handle_page_fault(pid, page_number);
+        if (pte == nullptr) {
+            return std::nullopt; // 没有可用页框，也没有可换出的页面
+        }
+    }
 
-uint64_t MemoryManager::get_used_memory() const {
-    return used_memory;
-}
+    if (is_write && pte->copy_on_write) {
+        pte = break_copy_on_write(pid, page_number);
+        if (pte == nullptr) {
+            return std::nullopt;
+        }
+    }
 
-uint64_t MemoryManager::get_free_memory() const {
-    return MEMORY_SIZE - used_memory;
+    pte->accessed = true;
+    if (is_write) {
+        pte->dirty = true;
+    }
+    uint64_t frame = pte->frame_for(page_number);
+    page_replacer.touch(frame);
+    // 共享页面与只读区域以只读方式缓存，写访问必然经过页表
+    tlb.insert(pid, page_number, pte->frame_number, pte->dirty && !pte->copy_on_write && writable, pte->huge);
+    return frame * PAGE_SIZE + offset;
 }
 
-std::string MemoryManager::read_memory(uint64_t address, size_t size) const {
-    if (address + size > MEMORY_SIZE || memory_pool == nullptr) {
-        throw std::runtime_error("Invalid memory access");
+uint64_t MemoryManager::obtain_frame() {
+    uint64_t limit = frame_limit == 0 ? TOTAL_PAGES : frame_limit;
+    while (true) {
+        if (page_frames.used_count() < limit) {
+            uint64_t frame = allocate_free_frame();
+            if (frame != UINT64_MAX) {
+                return frame;
+            }
+        }
+        if (!evict_page()) {
+            return UINT64_MAX;
+        }
     }
-    return std::string(memory_pool + address, size);
 }
 
-void MemoryManager::write_memory(uint64_t address, const std::string& data) {
-    if (address + data.size() > MEMORY_SIZE || memory_pool == nullptr) {
-        throw std::runtime_error("Invalid memory access");
+PageTableEntry* MemoryManager::handle_page_fault(ProcessID pid, uint64_t page_number) {
+    uint64_t frame = obtain_frame();
+    if (frame == UINT64_MAX) {
+        return nullptr;
     }
-    std::copy(data.begin(), data.end(), memory_pool + address);
-}
 
-void MemoryManager::read_memory(uint64_t address, void* buffer, size_t size) const {
-    if (address + size > MEMORY_SIZE || memory_pool == nullptr) {
-        throw std::runtime_error("Invalid memory access in read");
+    // 换出过的页面从写回队列或交换区读回，否则以全 0 页面调入
+    uint64_t address = frame * PAGE_SIZE;
+    char buffer[PAGE_SIZE];
+    bool queued = writeback_pending.count({pid, page_number}) > 0;
+    bool compressed = compressed_pages.count({pid, page_number}) > 0;
+    auto started = std::chrono::steady_clock::now();
+    if (load_swapped_page(pid, page_number, buffer)) {
+        uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+        memory_pool.write(address, buffer, PAGE_SIZE);
+        ++swap_ins;
+        if (queued) {
+            ++swap_queue_hits;
+        } else if (compressed) {
+            ++compressed_faults;
+            compressed_fault_ns += elapsed;
+        } else {
+            ++disk_faults;
+            disk_fault_ns += elapsed;
+        }
+    } else if (memory_pool.is_committed(address)) {
+        static const std::string zero_page(PAGE_SIZE, '\0');
+        memory_pool.write(address, zero_page.data(), PAGE_SIZE);
     }
-    std::memcpy(buffer, memory_pool + address, size);
+
+    PageTableEntry& pte = page_tables[pid].table.map(page_number, frame);
+    page_replacer.insert(frame, pid, page_number);
+    set_frame_owner(frame, pid, page_number);
+    used_memory += PAGE_SIZE;
+    ++stats_for(pid).faults;
+    ++total_fault_stats.faults;
+    return &pte;
 }
 
-void MemoryManager::write_memory(uint64_t address, const void* data, size_t size) {
-    if (address + size > MEMORY_SIZE || memory_pool == nullptr) {
-        throw std::runtime_error("Invalid memory access in write");
+bool MemoryManager::evict_page() {
+    auto victim = page_replacer.select_victim([this](const ResidentPage& page) {
+        PageTableEntry* pte = page_tables[page.pid].table.find(page.page_number);
+        bool referenced = pte->accessed;
+        if (referenced) {
+            // 清除访问位后作废 TLB 表项，下一次访问才能重新置位
+            pte->accessed = false;
+            tlb.invalidate(page.pid, page.page_number);
+        }
+        return referenced;
+    });
+    if (!victim) {
+        return false;
     }
-    std::memcpy(memory_pool + address, data, size);
-}
 
-// === 新增分页统计信息接口实现 ===
-uint64_t MemoryManager::get_total_pages() const {
-    return TOTAL_PAGES;
-}
+    // 共享页框要从所有映射者的页表中撤销，各自保存一份换出内容
+    std::vector<ResidentPage> mappers = get_frame_mappers(*victim);
+
+    bool write_back = mappers.size() > 1;
+    for (const auto& page : mappers) {
+        write_back = write_back || page_tables[page.pid].table.find(page.page_number)->dirty;
+    }
+    if (write_back) {
+        // 交换区容纳不下（包括写回队列中待落盘的页面）时无法换出
+        uint64_t new_slots = 0;
+        for (const auto& page : mappers) {
+            if (!has_swapped_page(page.pid, page.page_number)) {
+                ++new_slots;
+            }
+        }
+        if (!swap_area.has_free_slots(writeback_pending.size() + new_slots)) {
+            return false;
+        }
+    }
+    forget_merged_frame(*victim);
+    shared_frames.erase(*victim);
+    std::string data;
+    if (write_back) {
+        // 脏页写回交换区；干净页面的交换区副本（或全 0 内容）仍然有效
+        data.assign(PAGE_SIZE, '\0');
+        memory_pool.read(*victim * PAGE_SIZE, &data[0], PAGE_SIZE);
+        ++stats_for(mappers.front().pid).writebacks;
+        ++total_fault_stats.writebacks;
+    }
+    for (const auto& page : mappers) {
+        if (write_back) {
+            store_swapped_page(page.pid, page.page_number, data);
+            ++swap_outs;
+        }
+        page_tables[page.pid].table.unmap(page.page_number);
+        tlb.invalidate(page.pid, page.page_number);
+    }
+    page_replacer.erase(*victim);
+    free_frame(*victim);
+    used_memory -= PAGE_SIZE;
+    ++stats_for(mappers.front().pid).evictions;
+    ++total_fault_stats.evictions;
+    return true;
+}
+
+bool MemoryManager::fork_address_space(ProcessID parent_pid, ProcessID child_pid) {
+    if (current_strategy != MemoryAllocationStrategy::PAGED || parent_pid == child_pid) {
+        return false;
+    }
+    auto parent_it = page_tables.find(parent_pid);
+    if (parent_it == page_tables.end() || page_tables.count(child_pid)) {
+        return false;
+    }
+    // 子进程继承父进程的组（已单独指定时除外），并按父进程的计费记入
+    bool inherit_group = !process_groups.count(child_pid);
+    if (inherit_group) {
+        process_groups[child_pid] = get_memory_group_of(parent_pid);
+    }
+    if (!try_charge(child_pid, get_memory_charge(parent_pid))) {
+        if (inherit_group) {
+            process_groups.erase(child_pid);
+        }
+        return false;
+    }
+
+    auto& parent = parent_it->second;
+    split_huge_pages(parent); // 写时复制以普通页为单位
+    auto& child = page_tables.emplace(child_pid, ProcessPageTable(child_pid, parent.table.layout())).first->second;
+    child.page_count = parent.page_count;
+    child.vmas = parent.vmas;
+    child.has_heap = parent.has_heap;
+    child.heap_start_page = parent.heap_start_page;
+    child.program_break = parent.program_break;
+    auto parent_heap = heaps.find(parent_pid);
+    if (parent_heap != heaps.end()) {
+        heaps.emplace(child_pid, parent_heap->second);
+    }
+    parent.table.for_each([&](uint64_t page_number, PageTableEntry& pte) {
+        if (shm_frame_owner.count(pte.frame_number)) {
+            child.table.map(page_number, pte.frame_number); // 共享内存继续共享，不做写时复制
+            return;
+        }
+        auto file_page = file_frame_owner.find(pte.frame_number);
+        if (file_page != file_frame_owner.end()) {
+            child.table.map(page_number, pte.frame_number); // 文件页同样直接共享页缓存
+            file_pages.at(file_page->second).mappers.push_back({child_pid, page_number});
+            return;
+        }
+        pte.copy_on_write = true;
+        PageTableEntry& child_pte = child.table.map(page_number, pte.frame_number);
+        child_pte.copy_on_write = true;
+        child_pte.dirty = true; // 子进程在交换区中没有该页的副本，父进程退出后换出必须写回
+        auto& mappers = shared_frames[pte.frame_number];
+        if (mappers.empty()) {
+            mappers.push_back({parent_pid, page_number});
+        }
+        mappers.push_back({child_pid, page_number});
+    });
+    for (auto& entry : mapped_files) {
+        if (entry.second.mappers.count(parent_pid)) {
+            entry.second.mappers.insert(child_pid);
+        }
+    }
+    for (auto& entry : shared_segments) {
+        auto attached = entry.second.attachments.find(parent_pid);
+        if (attached != entry.second.attachments.end()) {
+            entry.second.attachments[child_pid] = attached->second;
+        }
+    }
+    // 复制交换区内容（包括写回队列中的页面）
+    std::set<uint64_t> swapped;
+    for (auto it = swapped_pages.lower_bound({parent_pid, 0}); it != swapped_pages.end() && it->first.first == parent_pid; ++it) {
+        swapped.insert(it->first.second);
+    }
+    for (auto it = writeback_pending.lower_bound({parent_pid, 0}); it != writeback_pending.end() && it->first.first == parent_pid; ++it) {
+        swapped.insert(it->first.second);
+    }
+    for (uint64_t page_number : swapped) {
+        std::string data(PAGE_SIZE, '\0');
+        load_swapped_page(parent_pid, page_number, &data[0]);
+        store_swapped_page(child_pid, page_number, std::move(data));
+    }
+    // 父进程的页面变为只读，TLB 中可写的表项必须作废
+    tlb.flush(parent_pid);
+    track_migrating_process(child_pid, child.page_count * PAGE_SIZE, {});
+    return true;
+}
+
+PageTableEntry* MemoryManager::break_copy_on_write(ProcessID pid, uint64_t page_number) {
+    PageTable& table = page_tables[pid].table;
+    PageTableEntry* pte = table.find(page_number);
+    uint64_t old_frame = pte->frame_number;
+    if (!shared_frames.count(old_frame)) {
+        pte->copy_on_write = false; // 其他映射者都已退出，直接取得所有权
+        return pte;
+    }
+
+    // 先保存内容并撤销共享映射，分配新页框时换出的可能正是原页框
+    std::string data(PAGE_SIZE, '\0');
+    memory_pool.read(old_frame * PAGE_SIZE, &data[0], PAGE_SIZE);
+    bool tracked = page_replacer.find(old_frame) != nullptr;
+    release_shared_mapping(old_frame, pid, page_number);
+    table.unmap(page_number);
+    tlb.invalidate(pid, page_number);
+
+    uint64_t frame = obtain_frame();
+    if (frame == UINT64_MAX) {
+        store_swapped_page(pid, page_number, std::move(data)); // 内容保留在交换区，页面变为非驻留
+        return nullptr;
+    }
+    memory_pool.write(frame * PAGE_SIZE, data.data(), PAGE_SIZE);
+    pte = &table.map(page_number, frame);
+    set_frame_owner(frame, pid, page_number);
+    if (tracked) {
+        page_replacer.insert(frame, pid, page_number);
+    }
+    used_memory += PAGE_SIZE;
+    ++cow_copies;
+    return pte;
+}
+
+void MemoryManager::release_shared_mapping(uint64_t frame, ProcessID pid, uint64_t page_number) {
+    auto it = shared_frames.find(frame);
+    if (it == shared_frames.end()) {
+        return;
+    }
+    auto& mappers = it->second;
+    mappers.erase(std::remove_if(mappers.begin(), mappers.end(), [&](const ResidentPage& page) {
+        return page.pid == pid && page.page_number == page_number;
+    }), mappers.end());
+
+    // 置换器中以退出的映射者代表该页框时，改由剩余的映射者代表
+    const ResidentPage* owner = page_replacer.find(frame);
+    if (owner != nullptr && owner->pid == pid && owner->page_number == page_number) {
+        page_replacer.retarget(frame, mappers.front().pid, mappers.front().page_number);
+    }
+    set_frame_owner(frame, mappers.front().pid, mappers.front().page_number);
+    if (mappers.size() == 1) {
+        forget_merged_frame(frame);
+        shared_frames.erase(it); // 只剩一个映射者，写入时直接取得所有权
+    }
+}
+
+std::optional<int> MemoryManager::shm_create(uint64_t size) {
+    if (current_strategy != MemoryAllocationStrategy::PAGED || size == 0) {
+        return std::nullopt;
+    }
+    uint64_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    SharedMemorySegment segment{next_shm_id, pages * PAGE_SIZE, {}, {}, false};
+    for (uint64_t i = 0; i < pages; ++i) {
+        uint64_t frame = obtain_frame();
+        if (frame == UINT64_MAX) {
+            for (uint64_t allocated : segment.frames) {
+                free_frame(allocated);
+            }
+            return std::nullopt;
+        }
+        // 页框可能曾被其他进程使用过，清零后交给新段
+        if (memory_pool.is_committed(frame * PAGE_SIZE)) {
+            static const std::string zero_page(PAGE_SIZE, '\0');
+            memory_pool.write(frame * PAGE_SIZE, zero_page.data(), PAGE_SIZE);
+        }
+        segment.frames.push_back(frame);
+    }
+    for (uint64_t frame : segment.frames) {
+        shm_frame_owner[frame] = segment.id;
+    }
+    used_memory += segment.size;
+    shared_segments.emplace(segment.id, std::move(segment));
+    return next_shm_id++;
+}
+
+std::optional<uint64_t> MemoryManager::shm_attach(int shmid, ProcessID pid) {
+    auto it = shared_segments.find(shmid);
+    if (current_strategy != MemoryAllocationStrategy::PAGED || it == shared_segments.end() || it->second.removed) {
+        return std::nullopt;
+    }
+    SharedMemorySegment& segment = it->second;
+    auto attached = segment.attachments.find(pid);
+    if (attached != segment.attachments.end()) {
+        return attached->second;
+    }
+
+    auto table_it = page_tables.find(pid);
+    if (table_it == page_tables.end()) {
+        table_it = page_tables.emplace(pid, ProcessPageTable(pid, page_table_layout)).first;
+    }
+    ProcessPageTable& page_table = table_it->second;
+    if (page_table.page_count + segment.frames.size() > page_table.table.max_pages()) {
+        return std::nullopt;
+    }
+    uint64_t first_page = page_table.page_count;
+    for (size_t i = 0; i < segment.frames.size(); ++i) {
+        page_table.table.map(first_page + i, segment.frames[i]);
+    }
+    page_table.vmas.insert(Vma{first_page, segment.frames.size(), VMA_PROT_READ | VMA_PROT_WRITE, VmaKind::SHARED_MEMORY, shmid});
+    page_table.page_count += segment.frames.size();
+    segment.attachments[pid] = first_page * PAGE_SIZE;
+    return first_page * PAGE_SIZE;
+}
+
+bool MemoryManager::shm_detach(int shmid, ProcessID pid) {
+    auto it = shared_segments.find(shmid);
+    if (it == shared_segments.end()) {
+        return false;
+    }
+    auto attached = it->second.attachments.find(pid);
+    if (attached == it->second.attachments.end()) {
+        return false;
+    }
+    unmap_shm_pages(it->second, pid, attached->second);
+    it->second.attachments.erase(attached);
+    release_shm_if_unused(shmid);
+    return true;
+}
+
+bool MemoryManager::shm_remove(int shmid) {
+    auto it = shared_segments.find(shmid);
+    if (it == shared_segments.end() || it->second.removed) {
+        return false;
+    }
+    it->second.removed = true;
+    release_shm_if_unused(shmid);
+    return true;
+}
+
+const std::map<int, SharedMemorySegment>& MemoryManager::get_shared_segments() const {
+    return shared_segments;
+}
+
+void MemoryManager::unmap_shm_pages(SharedMemorySegment& segment, ProcessID pid, uint64_t virtual_base) {
+    ProcessPageTable& page_table = page_tables[pid];
+    uint64_t first_page = virtual_base / PAGE_SIZE;
+    uint64_t pages = segment.frames.size();
+    for (uint64_t i = 0; i < pages; ++i) {
+        page_table.table.unmap(first_page + i);
+        tlb.invalidate(pid, first_page + i);
+    }
+    // 位于地址空间末尾时直接收缩，否则留下不可访问的空洞
+    page_table.vmas.remove(first_page, pages);
+    page_table.page_count = page_table.vmas.end_page();
+}
+
+void MemoryManager::release_shm_if_unused(int shmid) {
+    auto it = shared_segments.find(shmid);
+    if (it == shared_segments.end() || !it->second.removed || !it->second.attachments.empty()) {
+        return;
+    }
+    for (uint64_t frame : it->second.frames) {
+        shm_frame_owner.erase(frame);
+        free_frame(frame);
+    }
+    used_memory -= it->second.size;
+    shared_segments.erase(it);
+}
+
+FrameSharingStats MemoryManager::get_frame_sharing_stats() const {
+    FrameSharingStats stats;
+    stats.shared_frames = shared_frames.size();
+    for (const auto& entry : shared_frames) {
+        stats.shared_mappings += entry.second.size();
+    }
+    stats.shm_frames = shm_frame_owner.size();
+    stats.file_frames = file_frame_owner.size();
+    stats.private_frames = page_frames.used_count() - stats.shared_frames - stats.shm_frames - stats.file_frames;
+    stats.cow_copies = cow_copies;
+    return stats;
+}
+
+uint32_t MemoryManager::get_frame_refcount(uint64_t frame_number) const {
+    auto it = shared_frames.find(frame_number);
+    if (it != shared_frames.end()) {
+        return static_cast<uint32_t>(it->second.size());
+    }
+    auto file_page = file_frame_owner.find(frame_number);
+    if (file_page != file_frame_owner.end()) {
+        return static_cast<uint32_t>(file_pages.at(file_page->second).mappers.size());
+    }
+    return page_frames.test(frame_number) ? 1 : 0;
+}
+
+std::optional<ResidentPage> MemoryManager::get_frame_owner(uint64_t frame_number) const {
+    if (frame_number >= frame_owners.size() || frame_owners[frame_number].pid < 0) {
+        return std::nullopt;
+    }
+    return frame_owners[frame_number];
+}
+
+std::vector<ResidentPage> MemoryManager::get_frame_mappers(uint64_t frame_number) const {
+    auto shared = shared_frames.find(frame_number);
+    if (shared != shared_frames.end()) {
+        return shared->second;
+    }
+    auto file_page = file_frame_owner.find(frame_number);
+    if (file_page != file_frame_owner.end()) {
+        return file_pages.at(file_page->second).mappers;
+    }
+    std::vector<ResidentPage> mappers;
+    auto shm = shm_frame_owner.find(frame_number);
+    if (shm != shm_frame_owner.end()) {
+        // 共享内存段的页框由段持有，映射者为各进程映射的位置
+        const SharedMemorySegment& segment = shared_segments.at(shm->second);
+        uint64_t index = std::find(segment.frames.begin(), segment.frames.end(), frame_number) - segment.frames.begin();
+        for (const auto& attachment : segment.attachments) {
+            mappers.push_back({attachment.first, attachment.second / PAGE_SIZE + index});
+        }
+        return mappers;
+    }
+    if (auto owner = get_frame_owner(frame_number)) {
+        mappers.push_back(*owner);
+    }
+    return mappers;
+}
+
+void MemoryManager::set_demand_paging(bool enabled) {
+    demand_paging = enabled;
+}
+
+bool MemoryManager::is_demand_paging() const {
+    return demand_paging;
+}
+
+void MemoryManager::set_huge_pages(bool enabled) {
+    huge_pages_enabled = enabled; // 已映射的大页保持不变
+}
+
+bool MemoryManager::is_huge_pages() const {
+    return huge_pages_enabled;
+}
+
+uint64_t MemoryManager::allocate_huge_frame() {
+    uint64_t limit = frame_limit == 0 ? TOTAL_PAGES : frame_limit;
+    if (page_frames.used_count() + HUGE_PAGE_FRAMES > limit) {
+        return UINT64_MAX;
+    }
+    uint64_t first_frame = page_frames.allocate_aligned_run(HUGE_PAGE_FRAMES);
+    if (first_frame != UINT64_MAX) {
+        occupancy.add(first_frame * PAGE_SIZE, HUGE_PAGE_SIZE, -1);
+    }
+    return first_frame;
+}
+
+size_t MemoryManager::promote_huge_pages(size_t max_promotions) {
+    if (!huge_pages_enabled || demand_paging || page_tables.empty() || max_promotions == 0) {
+        return 0;
+    }
+    // 每次只扫描一个进程，各进程轮流
+    auto it = page_tables.upper_bound(promotion_cursor);
+    if (it == page_tables.end()) {
+        it = page_tables.begin();
+    }
+    promotion_cursor = it->first;
+    ProcessPageTable& page_table = it->second;
+
+    // 只有 512 个虚拟页都以普通页驻留的对齐区间才可能合并
+    std::map<uint64_t, uint64_t> resident;
+    page_table.table.for_each([&](uint64_t page_number, PageTableEntry& pte) {
+        if (!pte.huge) {
+            ++resident[page_number / HUGE_PAGE_FRAMES];
+        }
+    });
+    size_t promoted = 0;
+    for (const auto& range : resident) {
+        if (promoted >= max_promotions) {
+            break;
+        }
+        if (range.second == HUGE_PAGE_FRAMES && promote_huge_page(page_table, range.first)) {
+            ++promoted;
+        }
+    }
+    return promoted;
+}
+
+bool MemoryManager::promote_huge_page(ProcessPageTable& page_table, uint64_t huge_index) {
+    uint64_t first_page = huge_index * HUGE_PAGE_FRAMES;
+    std::vector<uint64_t> frames(HUGE_PAGE_FRAMES);
+    bool dirty = false;
+    bool accessed = false;
+    for (uint64_t i = 0; i < HUGE_PAGE_FRAMES; ++i) {
+        const PageTableEntry* pte = page_table.table.find(first_page + i);
+        // 写时复制、共享内存页框由其他页表共同持有，不能合并；其他映射者都已退出的写时复制页视为私有
+        if (pte == nullptr || shared_frames.count(pte->frame_number) ||
+            shm_frame_owner.count(pte->frame_number) || file_frame_owner.count(pte->frame_number)) {
+            return false;
+        }
+        frames[i] = pte->frame_number;
+        dirty = dirty || pte->dirty;
+        accessed = accessed || pte->accessed;
+    }
+
+    // 页框本来就对齐且连续时原地合并，否则复制到新分配的对齐区间
+    bool in_place = frames[0] % HUGE_PAGE_FRAMES == 0;
+    for (uint64_t i = 1; in_place && i < HUGE_PAGE_FRAMES; ++i) {
+        in_place = frames[i] == frames[0] + i;
+    }
+    uint64_t first_frame = in_place ? frames[0] : allocate_huge_frame();
+    if (first_frame == UINT64_MAX) {
+        return false;
+    }
+    if (!in_place) {
+        char buffer[PAGE_SIZE];
+        for (uint64_t i = 0; i < HUGE_PAGE_FRAMES; ++i) {
+            uint64_t source = frames[i] * PAGE_SIZE;
+            uint64_t destination = (first_frame + i) * PAGE_SIZE;
+            if (memory_pool.is_committed(source)) {
+                memory_pool.read(source, buffer, PAGE_SIZE);
+                memory_pool.write(destination, buffer, PAGE_SIZE);
+            } else if (memory_pool.is_committed(destination)) {
+                std::memset(buffer, 0, PAGE_SIZE);
+                memory_pool.write(destination, buffer, PAGE_SIZE);
+            }
+        }
+    }
+    for (uint64_t i = 0; i < HUGE_PAGE_FRAMES; ++i) {
+        page_replacer.erase(frames[i]);
+        if (!in_place) {
+            free_frame(frames[i]);
+        }
+        page_table.table.unmap(first_page + i);
+    }
+    PageTableEntry& huge = page_table.table.map_huge(huge_index, first_frame);
+    for (uint64_t i = 0; i < HUGE_PAGE_FRAMES; ++i) {
+        set_frame_owner(first_frame + i, page_table.pid, first_page + i);
+    }
+    huge.dirty = dirty;
+    huge.accessed = accessed;
+    tlb.flush(page_table.pid);
+    ++huge_promotions;
+    return true;
+}
+
+void MemoryManager::split_huge_page(ProcessPageTable& page_table, uint64_t huge_index) {
+    uint64_t first_page = huge_index * HUGE_PAGE_FRAMES;
+    PageTableEntry huge = *page_table.table.find(first_page);
+    page_table.table.unmap_huge(huge_index);
+    for (uint64_t i = 0; i < HUGE_PAGE_FRAMES; ++i) {
+        PageTableEntry& pte = page_table.table.map(first_page + i, huge.frame_number + i);
+        pte.dirty = huge.dirty;
+        pte.accessed = huge.accessed;
+        if (swap_area.is_attached()) {
+            page_replacer.insert(pte.frame_number, page_table.pid, first_page + i); // 拆分后可以换出
+        }
+    }
+    ++huge_splits;
+}
+
+void MemoryManager::split_huge_pages(ProcessPageTable& page_table) {
+    std::vector<uint64_t> huge_indices;
+    page_table.table.for_each([&](uint64_t page_number, PageTableEntry& pte) {
+        if (pte.huge) {
+            huge_indices.push_back(page_number / HUGE_PAGE_FRAMES);
+        }
+    });
+    if (huge_indices.empty()) {
+        return;
+    }
+    for (uint64_t huge_index : huge_indices) {
+        split_huge_page(page_table, huge_index);
+    }
+    tlb.flush(page_table.pid);
+}
+
+ProcessPageTable& MemoryManager::page_table_for(ProcessID pid) {
+    auto it = page_tables.find(pid);
+    if (it == page_tables.end()) {
+        it = page_tables.emplace(pid, ProcessPageTable(pid, page_table_layout)).first;
+    }
+    return it->second;
+}
+
+std::optional<uint64_t> MemoryManager::mmap(ProcessID pid, uint64_t length, uint32_t prot, std::optional<uint64_t> address) {
+    if (current_strategy != MemoryAllocationStrategy::PAGED || length == 0 || (address && *address % PAGE_SIZE != 0)) {
+        return std::nullopt;
+    }
+    uint64_t pages = (length + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (!try_charge(pid, pages * PAGE_SIZE)) {
+        return std::nullopt;
+    }
+    auto mapped = place_vma(page_table_for(pid), Vma{0, pages, prot, VmaKind::ANONYMOUS, -1}, address);
+    if (!mapped) {
+        uncharge(pid, pages * PAGE_SIZE);
+    }
+    return mapped;
+}
+
+std::optional<uint64_t> MemoryManager::place_vma(ProcessPageTable& page_table, Vma vma, std::optional<uint64_t> address) {
+    if (address) {
+        vma.start_page = *address / PAGE_SIZE;
+    } else {
+        vma.start_page = page_table.vmas.find_gap(vma.pages, page_table.page_count).value_or(page_table.page_count);
+    }
+    uint64_t max_pages = page_table.table.max_pages();
+    if (vma.start_page >= max_pages || vma.pages > max_pages - vma.start_page || !page_table.vmas.insert(vma)) {
+        return std::nullopt;
+    }
+    page_table.page_count = std::max(page_table.page_count, vma.end_page());
+    return vma.start_page * PAGE_SIZE;
+}
+
+bool MemoryManager::munmap(ProcessID pid, uint64_t address, uint64_t length) {
+    auto it = page_tables.find(pid);
+    if (current_strategy != MemoryAllocationStrategy::PAGED || it == page_tables.end() || length == 0 || address % PAGE_SIZE != 0) {
+        return false;
+    }
+    ProcessPageTable& page_table = it->second;
+    uint64_t first_page = address / PAGE_SIZE;
+    uint64_t pages = (length - 1) / PAGE_SIZE + 1; // length 接近 UINT64_MAX 时不能先加再除
+    if (first_page >= page_table.table.max_pages() || pages > page_table.table.max_pages() - first_page) {
+        return false;
+    }
+    for (const Vma& vma : page_table.vmas.overlapping(first_page, pages)) {
+        if (vma.kind == VmaKind::SHARED_MEMORY) {
+            return false;
+        }
+    }
+    uncharge(pid, charged_bytes(page_table.vmas, first_page, pages));
+    release_page_range(page_table, first_page, pages);
+    page_table.vmas.remove(first_page, pages);
+    page_table.page_count = page_table.vmas.end_page();
+    refresh_file_mappers(page_table);
+    return true;
+}
+
+bool MemoryManager::mprotect(ProcessID pid, uint64_t address, uint64_t length, uint32_t prot) {
+    auto it = page_tables.find(pid);
+    if (current_strategy != MemoryAllocationStrategy::PAGED || it == page_tables.end() || length == 0 || address % PAGE_SIZE != 0) {
+        return false;
+    }
+    uint64_t first_page = address / PAGE_SIZE;
+    uint64_t pages = (length - 1) / PAGE_SIZE + 1;
+    if (first_page >= it->second.table.max_pages() || pages > it->second.table.max_pages() - first_page ||
+        !it->second.vmas.covers(first_page, pages)) {
+        return false;
+    }
+    it->second.vmas.protect(first_page, pages, prot);
+    tlb.flush(pid); // 缓存的可写表项可能已失去写权限
+    return true;
+}
+
+std::optional<uint64_t> MemoryManager::brk(ProcessID pid, uint64_t new_break) {
+    if (current_strategy != MemoryAllocationStrategy::PAGED) {
+        return std::nullopt;
+    }
+    ProcessPageTable& page_table = page_table_for(pid);
+    if (!page_table.has_heap) {
+        page_table.has_heap = true;
+        page_table.heap_start_page = page_table.page_count;
+        page_table.program_break = page_table.page_count * PAGE_SIZE;
+    }
+    if (new_break == 0) {
+        return page_table.program_break;
+    }
+    if (new_break < page_table.heap_start_page * PAGE_SIZE) {
+        return std::nullopt;
+    }
+
+    auto heap = heaps.find(pid);
+    if (heap != heaps.end() && new_break < page_table.program_break &&
+        heap->second.trailing_free() < page_table.program_break - new_break) {
+        return std::nullopt; // 会截断仍在使用的堆块
+    }
+
+    uint64_t old_end = (page_table.program_break + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint64_t new_end = (new_break + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (new_end > old_end) {
+        // 堆向上增长，不能越过其他映射
+        uint64_t growth = (new_end - old_end) * PAGE_SIZE;
+        if (!try_charge(pid, growth)) {
+            return std::nullopt;
+        }
+        if (new_end > page_table.table.max_pages() ||
+            !page_table.vmas.insert(Vma{old_end, new_end - old_end, VMA_PROT_READ | VMA_PROT_WRITE, VmaKind::HEAP, -1})) {
+            uncharge(pid, growth);
+            return std::nullopt;
+        }
+        page_table.page_count = std::max(page_table.page_count, new_end);
+    } else if (new_end < old_end) {
+        for (const Vma& vma : page_table.vmas.overlapping(new_end, old_end - new_end)) {
+            if (vma.kind == VmaKind::SHARED_MEMORY) {
+                return std::nullopt;
+            }
+        }
+        uncharge(pid, charged_bytes(page_table.vmas, new_end, old_end - new_end));
+        release_page_range(page_table, new_end, old_end - new_end);
+        page_table.vmas.remove(new_end, old_end - new_end);
+        page_table.page_count = page_table.vmas.end_page();
+        refresh_file_mappers(page_table);
+    }
+    page_table.program_break = new_break;
+    if (heap != heaps.end()) {
+        uint64_t capacity = new_break - page_table.heap_start_page * PAGE_SIZE;
+        if (capacity > heap->second.capacity()) {
+            heap->second.grow(capacity);
+        } else {
+            heap->second.shrink(capacity);
+        }
+    }
+    return new_break;
+}
+
+std::optional<uint64_t> MemoryManager::heap_alloc(ProcessID pid, uint64_t size) {
+    if (size == 0) {
+        return std::nullopt;
+    }
+    auto current = brk(pid, 0);
+    if (!current) {
+        return std::nullopt;
+    }
+    const ProcessPageTable& page_table = page_tables.at(pid);
+    uint64_t heap_base = page_table.heap_start_page * PAGE_SIZE;
+    auto heap = heaps.find(pid);
+    if (heap == heaps.end()) {
+        heap = heaps.emplace(pid, HeapAllocator(heap_policy)).first;
+        heap->second.grow(*current - heap_base); // 之前直接用 brk 扩大的部分
+    }
+    auto offset = heap->second.allocate(size);
+    if (!offset) {
+        // 按页扩大堆，每次至少 HEAP_GROW_STEP，避免频繁 brk；
+        // TLSF 查找时把请求向上取整到下一个二级区间，多留 1/16
+        uint64_t aligned = (size + HeapAllocator::ALIGNMENT - 1) / HeapAllocator::ALIGNMENT * HeapAllocator::ALIGNMENT;
+        uint64_t growth = std::max(aligned + aligned / 16, HEAP_GROW_STEP);
+        uint64_t new_break = (*current + growth + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        if (!brk(pid, new_break)) {
+            return std::nullopt;
+        }
+        offset = heap->second.allocate(size);
+        if (!offset) {
+            return std::nullopt;
+        }
+    }
+    return heap_base + *offset;
+}
+
+bool MemoryManager::heap_free(ProcessID pid, uint64_t address) {
+    auto heap = heaps.find(pid);
+    auto page_table = page_tables.find(pid);
+    if (heap == heaps.end() || page_table == page_tables.end()) {
+        return false;
+    }
+    uint64_t heap_base = page_table->second.heap_start_page * PAGE_SIZE;
+    if (address < heap_base || !heap->second.free(address - heap_base)) {
+        return false;
+    }
+    // 末尾空闲过多时按整页归还，页框随之释放
+    uint64_t trailing = heap->second.trailing_free();
+    if (trailing >= HEAP_TRIM_THRESHOLD) {
+        uint64_t in_use = heap->second.capacity() - trailing;
+        uint64_t new_break = heap_base + (in_use + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+        if (new_break > 0) {
+            brk(pid, new_break);
+        }
+    }
+    return true;
+}
+
+void MemoryManager::set_heap_policy(HeapPolicy policy) {
+    heap_policy = policy;
+}
+
+HeapPolicy MemoryManager::get_heap_policy() const {
+    return heap_policy;
+}
+
+const HeapAllocator* MemoryManager::get_heap(ProcessID pid) const {
+    auto it = heaps.find(pid);
+    return it == heaps.end() ? nullptr : &it->second;
+}
+
+const VmaTree* MemoryManager::get_vmas(ProcessID pid) const {
+    auto it = page_tables.find(pid);
+    return it == page_tables.end() ? nullptr : &it->second.vmas;
+}
+
+void MemoryManager::release_page_range(ProcessPageTable& page_table, uint64_t first_page, uint64_t pages) {
+    uint64_t end_page = first_page + pages;
+    // 区间比驻留页多时只遍历区间内驻留的页表项，开销与区间长度无关
+    bool sparse = pages > page_table.table.resident_count();
+    auto resident_in_range = [&](bool huge) {
+        std::vector<uint64_t> page_numbers;
+        page_table.table.for_each([&](uint64_t page_number, PageTableEntry& pte) {
+            uint64_t last = page_number + (pte.huge ? HUGE_PAGE_FRAMES : 1);
+            if (pte.huge == huge && page_number < end_page && last > first_page) {
+                page_numbers.push_back(page_number);
+            }
+        });
+        return page_numbers;
+    };
+
+    // 完整落在区间内的大页整体释放，只有一部分落在区间内的大页先拆分
+    auto release_huge = [&](uint64_t huge_index) {
+        uint64_t huge_first = huge_index * HUGE_PAGE_FRAMES;
+        const PageTableEntry* pte = page_table.table.find(huge_first);
+        if (pte == nullptr || !pte->huge) {
+            return;
+        }
+        if (huge_first >= first_page && huge_first + HUGE_PAGE_FRAMES <= end_page) {
+            for (uint64_t k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+                free_frame(pte->frame_number + k);
+            }
+            page_table.table.unmap_huge(huge_index);
+            used_memory -= HUGE_PAGE_SIZE;
+        } else {
+            split_huge_page(page_table, huge_index);
+        }
+    };
+    if (page_table.table.huge_count() > 0) {
+        if (sparse) {
+            for (uint64_t page_number : resident_in_range(true)) {
+                release_huge(page_number / HUGE_PAGE_FRAMES);
+            }
+        } else {
+            for (uint64_t huge_index = first_page / HUGE_PAGE_FRAMES; huge_index * HUGE_PAGE_FRAMES < end_page; ++huge_index) {
+                release_huge(huge_index);
+            }
+        }
+    }
+
+    auto release_page = [&](uint64_t page_number) {
+        PageTableEntry* pte = page_table.table.find(page_number);
+        if (pte == nullptr) {
+            return;
+        }
+        if (file_frame_owner.count(pte->frame_number)) {
+            unmap_file_page(pte->frame_number, page_table.pid, page_number, pte->dirty);
+        } else if (shared_frames.count(pte->frame_number)) {
+            release_shared_mapping(pte->frame_number, page_table.pid, page_number); // 其他进程仍在使用
+        } else {
+            page_replacer.erase(pte->frame_number);
+            free_frame(pte->frame_number);
+            used_memory -= PAGE_SIZE;
+        }
+        page_table.table.unmap(page_number);
+    };
+    if (sparse) {
+        for (uint64_t page_number : resident_in_range(false)) {
+            release_page(page_number);
+        }
+    } else {
+        for (uint64_t page_number = first_page; page_number < end_page; ++page_number) {
+            release_page(page_number);
+        }
+    }
+    drop_swapped_pages(page_table.pid, first_page, end_page);
+    tlb.flush(page_table.pid);
+}
+
+std::optional<uint64_t> MemoryManager::mmap_file(ProcessID pid, FileSystemManager& fs, const std::string& path, uint32_t prot,
+                                                uint64_t offset, uint64_t length, std::optional<uint64_t> address) {
+    if (current_strategy != MemoryAllocationStrategy::PAGED || offset % PAGE_SIZE != 0 || (address && *address % PAGE_SIZE != 0)) {
+        return std::nullopt;
+    }
+    auto block_map = fs.get_file_block_map(path);
+    if (!block_map || offset >= block_map->size) {
+        return std::nullopt;
+    }
+    if (length == 0) {
+        length = block_map->size - offset;
+    }
+    int file_id = static_cast<int>(block_map->inode);
+    Vma vma{0, (length + PAGE_SIZE - 1) / PAGE_SIZE, prot, VmaKind::FILE, -1, file_id, offset / PAGE_SIZE};
+    auto mapped = place_vma(page_table_for(pid), vma, address);
+    if (!mapped) {
+        return std::nullopt;
+    }
+    // 只记录块号，不读取文件内容
+    auto file = mapped_files.find(file_id);
+    if (file == mapped_files.end()) {
+        file = mapped_files.emplace(file_id, MappedFile{&fs, path, block_map->size, std::move(block_map->blocks), block_map->block_payload, {}}).first;
+    }
+    file->second.mappers.insert(pid);
+    return mapped;
+}
+
+PageTableEntry* MemoryManager::fault_file_page(ProcessPageTable& page_table, const Vma& vma, uint64_t page_number) {
+    std::pair<int, uint64_t> key{vma.file_id, vma.file_page + (page_number - vma.start_page)};
+    auto cached = file_pages.find(key);
+    if (cached == file_pages.end()) {
+        uint64_t frame = obtain_frame();
+        if (frame == UINT64_MAX) {
+            return nullptr;
+        }
+        // 读入文件块，块尾的链接指针与文件末尾之后的页面读作 0
+        const MappedFile& file = mapped_files.at(key.first);
+        static const char zero_page[PAGE_SIZE] = {};
+        char buffer[PAGE_SIZE] = {};
+        if (key.second < file.blocks.size()) {
+            file.fs->read_block(file.blocks[key.second], buffer);
+            std::memset(buffer + file.block_payload, 0, PAGE_SIZE - file.block_payload);
+        }
+        uint64_t address = frame * PAGE_SIZE;
+        if (std::memcmp(buffer, zero_page, PAGE_SIZE) != 0 || memory_pool.is_committed(address)) {
+            memory_pool.write(address, buffer, PAGE_SIZE);
+        }
+        cached = file_pages.emplace(key, CachedFilePage{frame, false, {}}).first;
+        file_frame_owner[frame] = key;
+        used_memory += PAGE_SIZE;
+    }
+    cached->second.mappers.push_back({page_table.pid, page_number});
+    if (cached->second.mappers.size() == 1) {
+        set_frame_owner(cached->second.frame, page_table.pid, page_number);
+    }
+    ++stats_for(page_table.pid).faults;
+    ++total_fault_stats.faults;
+    return &page_table.table.map(page_number, cached->second.frame);
+}
+
+void MemoryManager::unmap_file_page(uint64_t frame, ProcessID pid, uint64_t page_number, bool dirty) {
+    auto key = file_frame_owner.at(frame);
+    CachedFilePage& cached = file_pages.at(key);
+    cached.dirty = cached.dirty || dirty;
+    auto& mappers = cached.mappers;
+    mappers.erase(std::remove_if(mappers.begin(), mappers.end(), [&](const ResidentPage& page) {
+        return page.pid == pid && page.page_number == page_number;
+    }), mappers.end());
+    if (!mappers.empty()) {
+        set_frame_owner(frame, mappers.front().pid, mappers.front().page_number);
+        return;
+    }
+    if (cached.dirty) {
+        write_back_file_page(key, cached);
+    }
+    file_frame_owner.erase(frame);
+    file_pages.erase(key);
+    free_frame(frame);
+    used_memory -= PAGE_SIZE;
+}
+
+void MemoryManager::write_back_file_page(const std::pair<int, uint64_t>& key, CachedFilePage& page) {
+    page.dirty = false;
+    const MappedFile& file = mapped_files.at(key.first);
+    if (key.second >= file.blocks.size()) {
+        return; // 文件末尾之后的页面不写回
+    }
+    uint32_t block = file.blocks[key.second];
+    char buffer[PAGE_SIZE];
+    if (file.block_payload < PAGE_SIZE) {
+        file.fs->read_block(block, buffer); // 保留块尾的链接指针
+    }
+    memory_pool.read(page.frame * PAGE_SIZE, buffer, file.block_payload);
+    file.fs->write_block(block, buffer);
+}
+
+size_t MemoryManager::sync_file_pages() {
+    size_t written = 0;
+    for (auto& entry : file_pages) {
+        CachedFilePage& cached = entry.second;
+        for (const auto& mapper : cached.mappers) {
+            PageTableEntry* pte = page_tables[mapper.pid].table.find(mapper.page_number);
+            if (pte != nullptr && pte->dirty) {
+                // 清除脏位后作废 TLB 表项，之后的写入才能重新置位
+                pte->dirty = false;
+                tlb.invalidate(mapper.pid, mapper.page_number);
+                cached.dirty = true;
+            }
+        }
+        if (cached.dirty) {
+            write_back_file_page(entry.first, cached);
+            ++written;
+        }
+    }
+    return written;
+}
+
+const std::map<int, MappedFile>& MemoryManager::get_mapped_files() const {
+    return mapped_files;
+}
+
+void MemoryManager::refresh_file_mappers(const ProcessPageTable& page_table) {
+    std::set<int> referenced;
+    for (const auto& entry : page_table.vmas.areas()) {
+        if (entry.second.kind == VmaKind::FILE) {
+            referenced.insert(entry.second.file_id);
+        }
+    }
+    for (auto file = mapped_files.begin(); file != mapped_files.end();) {
+        if (!referenced.count(file->first)) {
+            file->second.mappers.erase(page_table.pid);
+        }
+        file = file->second.mappers.empty() ? mapped_files.erase(file) : std::next(file);
+    }
+}
+
+HugePageStats MemoryManager::get_huge_page_stats() const {
+    HugePageStats stats;
+    for (const auto& entry : page_tables) {
+        stats.huge_pages += entry.second.table.huge_count();
+    }
+    stats.allocations = huge_allocations;
+    stats.promotions = huge_promotions;
+    stats.splits = huge_splits;
+    return stats;
+}
+
+void MemoryManager::set_page_merging(bool enabled) {
+    page_merging_enabled = enabled; // 已合并的页框保持共享，直到写入时复制
+}
+
+bool MemoryManager::is_page_merging() const {
+    return page_merging_enabled;
+}
+
+size_t MemoryManager::merge_same_pages(size_t max_frames) {
+    if (!page_merging_enabled || current_strategy != MemoryAllocationStrategy::PAGED) {
+        return 0;
+    }
+    // 只合并只被一个进程以普通页映射的页框；共享内存段、页缓存与大页不参与
+    auto private_page = [this](uint64_t frame) -> PageTableEntry* {
+        if (frame >= frame_owners.size() || frame_owners[frame].pid < 0 || shared_frames.count(frame) ||
+            shm_frame_owner.count(frame) || file_frame_owner.count(frame)) {
+            return nullptr;
+        }
+        PageTableEntry* pte = page_tables.at(frame_owners[frame].pid).table.find(frame_owners[frame].page_number);
+        return pte != nullptr && !pte->huge && pte->frame_number == frame ? pte : nullptr;
+    };
+
+    size_t merged = 0;
+    std::vector<uint64_t> words(PAGE_SIZE / sizeof(uint64_t));
+    for (size_t scanned = 0; scanned < max_frames && !frame_owners.empty(); ++scanned) {
+        if (merge_cursor >= frame_owners.size()) {
+            // 一轮扫描结束，候选页框的内容可能已经改变
+            merge_cursor = 0;
+            merge_candidates.clear();
+            ++merge_stats.full_scans;
+        }
+        uint64_t frame = merge_cursor++;
+        if (private_page(frame) == nullptr) {
+            continue;
+        }
+        ++merge_stats.pages_scanned;
+        memory_pool.read(frame * PAGE_SIZE, words.data(), PAGE_SIZE);
+        uint64_t hash = 14695981039346656037ULL; // FNV-1a，按 64 位字计算
+        for (uint64_t word : words) {
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+
+        // 先与已合并的页框比较，再与本轮的候选页框比较；哈希相同时逐字节确认
+        const ResidentPage owner = frame_owners[frame];
+        std::optional<uint64_t> target;
+        auto range = merged_by_hash.equal_range(hash);
+        for (auto it = range.first; it != range.second && !target; ++it) {
+            if (frames_equal(it->second, frame)) {
+                target = it->second;
+            }
+        }
+        if (!target) {
+            auto candidate = merge_candidates.find(hash);
+            if (candidate != merge_candidates.end() && candidate->second != frame &&
+                private_page(candidate->second) != nullptr && frames_equal(candidate->second, frame)) {
+                target = candidate->second;
+                merged_frames[*target] = hash;
+                merged_by_hash.emplace(hash, *target);
+                merge_candidates.erase(candidate);
+            } else {
+                merge_candidates[hash] = frame;
+                continue;
+            }
+        }
+        merge_page_into(owner.pid, owner.page_number, *target);
+        ++merged;
+    }
+    merge_stats.merges += merged;
+    return merged;
+}
+
+PageMergingStats MemoryManager::get_page_merging_stats() const {
+    PageMergingStats stats = merge_stats;
+    for (const auto& entry : merged_frames) {
+        stats.merged_frames += 1;
+        stats.pages_sharing += shared_frames.at(entry.first).size() - 1;
+    }
+    stats.bytes_saved = stats.pages_sharing * PAGE_SIZE;
+    return stats;
+}
+
+bool MemoryManager::frames_equal(uint64_t a, uint64_t b) {
+    uint64_t first = a * PAGE_SIZE;
+    uint64_t second = b * PAGE_SIZE;
+    if (!memory_pool.is_committed(first) && !memory_pool.is_committed(second)) {
+        return true; // 都未提交，内容均为 0
+    }
+    char left[PAGE_SIZE];
+    char right[PAGE_SIZE];
+    memory_pool.read(first, left, PAGE_SIZE);
+    memory_pool.read(second, right, PAGE_SIZE);
+    return std::memcmp(left, right, PAGE_SIZE) == 0;
+}
+
+void MemoryManager::merge_page_into(ProcessID pid, uint64_t page_number, uint64_t target) {
+    auto& mappers = shared_frames[target];
+    if (mappers.empty()) {
+        // 目标页框原来私有，其映射者同样改为写时复制，TLB 中可写的表项作废
+        const ResidentPage first = frame_owners[target];
+        page_tables.at(first.pid).table.find(first.page_number)->copy_on_write = true;
+        tlb.invalidate(first.pid, first.page_number);
+        mappers.push_back(first);
+    }
+    mappers.push_back({pid, page_number});
+
+    PageTable& table = page_tables.at(pid).table;
+    bool accessed = table.find(page_number)->accessed;
+    bool dirty = table.find(page_number)->dirty;
+    uint64_t old_frame = table.find(page_number)->frame_number;
+    page_replacer.erase(old_frame);
+    free_frame(old_frame);
+    used_memory -= PAGE_SIZE;
+    // 内容未变，保留脏位：另一方退出后换出仍需写回
+    PageTableEntry& pte = table.map(page_number, target);
+    pte.copy_on_write = true;
+    pte.accessed = accessed;
+    pte.dirty = dirty;
+    tlb.invalidate(pid, page_number);
+}
+
+void MemoryManager::forget_merged_frame(uint64_t frame_number) {
+    auto it = merged_frames.find(frame_number);
+    if (it == merged_frames.end()) {
+        return;
+    }
+    auto range = merged_by_hash.equal_range(it->second);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second == frame_number) {
+            merged_by_hash.erase(entry);
+            break;
+        }
+    }
+    merged_frames.erase(it);
+}
+
+void MemoryManager::set_physical_frame_limit(uint64_t frames) {
+    frame_limit = frames > TOTAL_PAGES ? TOTAL_PAGES : frames;
+}
+
+uint64_t MemoryManager::get_physical_frame_limit() const {
+    return frame_limit;
+}
+
+void MemoryManager::set_page_replacement_policy(PageReplacementPolicy policy) {
+    page_replacer.set_policy(policy);
+}
+
+PageReplacementPolicy MemoryManager::get_page_replacement_policy() const {
+    return page_replacer.policy();
+}
+
+void MemoryManager::set_reference_trace(const std::vector<ResidentPage>& trace) {
+    page_replacer.set_reference_trace(trace);
+}
+
+PageFaultStats MemoryManager::get_page_fault_stats(ProcessID pid) const {
+    auto it = fault_stats.find(pid);
+    return it == fault_stats.end() ? PageFaultStats() : it->second;
+}
+
+const PageFaultStats& MemoryManager::get_total_page_fault_stats() const {
+    return total_fault_stats;
+}
+
+void MemoryManager::reset_page_fault_stats() {
+    fault_stats.clear();
+    total_fault_stats = PageFaultStats();
+    cached_stats_pid = -1;
+    cached_stats = nullptr;
+    tlb.reset_stats();
+    swap_outs = 0;
+    swap_ins = 0;
+    swap_queue_hits = 0;
+    writebacks_completed = 0;
+    swap_stats_since = std::chrono::steady_clock::now();
+    compressed_pool.reset_stats();
+    compressed_faults = 0;
+    compressed_fault_ns = 0;
+    disk_faults = 0;
+    disk_fault_ns = 0;
+}
+
+bool MemoryManager::attach_swap(FileSystemManager& fs, uint64_t size) {
+    if (!swapped_pages.empty() || !writeback_pending.empty()) {
+        return false;
+    }
+    if (!swap_area.attach(fs, size / PAGE_SIZE)) {
+        return false;
+    }
+    writeback_queue.clear();
+    return true;
+}
+
+bool MemoryManager::detach_swap() {
+    if (!swapped_pages.empty() || !writeback_pending.empty()) {
+        return false;
+    }
+    writeback_queue.clear();
+    return swap_area.detach();
+}
+
+size_t MemoryManager::pump_swap_writeback(size_t max_pages) {
+    size_t written = 0;
+    while (written < max_pages && !writeback_queue.empty()) {
+        auto key = writeback_queue.front();
+        auto pending = writeback_pending.find(key);
+        if (pending == writeback_pending.end()) {
+            writeback_queue.pop_front(); // 进程已退出
+            continue;
+        }
+        auto slot = swap_area.allocate_slot();
+        if (!slot) {
+            break; // 交换区已满，留在队列中
+        }
+        swap_area.write_slot(*slot, pending->second.data());
+        swapped_pages[key] = *slot;
+        writeback_pending.erase(pending);
+        writeback_queue.pop_front();
+        ++writebacks_completed;
+        ++written;
+    }
+    return written;
+}
+
+void MemoryManager::set_writeback_queue_limit(size_t pages) {
+    writeback_queue_limit = pages;
+    if (writeback_pending.size() > writeback_queue_limit) {
+        pump_swap_writeback(writeback_pending.size() - writeback_queue_limit);
+    }
+}
+
+size_t MemoryManager::get_writeback_queue_limit() const {
+    return writeback_queue_limit;
+}
+
+SwapStats MemoryManager::get_swap_stats() const {
+    SwapStats stats;
+    stats.on_disk = swap_area.is_attached();
+    stats.total_slots = swap_area.capacity();
+    stats.used_slots = swap_area.used_slots();
+    stats.pending_writeback = writeback_pending.size();
+    stats.swap_outs = swap_outs;
+    stats.swap_ins = swap_ins;
+    stats.queue_hits = swap_queue_hits;
+    stats.writebacks_completed = writebacks_completed;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - swap_stats_since).count();
+    if (seconds > 0) {
+        stats.swap_out_rate = swap_outs / seconds;
+        stats.swap_in_rate = swap_ins / seconds;
+    }
+    return stats;
+}
+
+void MemoryManager::set_compressed_swap(bool enabled) {
+    compressed_swap_enabled = enabled;
+}
+
+bool MemoryManager::is_compressed_swap() const {
+    return compressed_swap_enabled;
+}
+
+void MemoryManager::set_compressed_pool_limit(uint64_t bytes) {
+    compressed_pool.set_limit(bytes);
+}
+
+CompressedSwapStats MemoryManager::get_compressed_swap_stats() const {
+    CompressedSwapStats stats;
+    stats.enabled = compressed_swap_enabled;
+    stats.pool = compressed_pool.stats();
+    stats.faults = compressed_faults;
+    stats.fault_ns = compressed_fault_ns;
+    stats.disk_faults = disk_faults;
+    stats.disk_fault_ns = disk_fault_ns;
+    return stats;
+}
+
+void MemoryManager::store_swapped_page(ProcessID pid, uint64_t page_number, std::string data) {
+    // 交换区和压缩池中的旧副本已过时
+    auto slot = swapped_pages.find({pid, page_number});
+    if (slot != swapped_pages.end()) {
+        swap_area.free_slot(slot->second);
+        swapped_pages.erase(slot);
+    }
+    auto compressed = compressed_pages.find({pid, page_number});
+    if (compressed != compressed_pages.end()) {
+        compressed_pool.release(compressed->second);
+        compressed_pages.erase(compressed);
+    }
+    if (compressed_swap_enabled) {
+        auto handle = compressed_pool.store(data.data());
+        if (handle) {
+            // 写回队列中的旧内容同样过时，队列出队时跳过
+            writeback_pending.erase({pid, page_number});
+            compressed_pages[{pid, page_number}] = *handle;
+            return;
+        }
+    }
+    // 新内容先进入写回队列
+    auto inserted = writeback_pending.insert_or_assign({pid, page_number}, std::move(data));
+    if (inserted.second) {
+        writeback_queue.push_back({pid, page_number});
+    }
+    if (writeback_pending.size() > writeback_queue_limit) {
+        pump_swap_writeback(writeback_pending.size() - writeback_queue_limit);
+    }
+}
+
+bool MemoryManager::load_swapped_page(ProcessID pid, uint64_t page_number, void* buffer) {
+    auto pending = writeback_pending.find({pid, page_number});
+    if (pending != writeback_pending.end()) {
+        std::memcpy(buffer, pending->second.data(), PAGE_SIZE);
+        return true;
+    }
+    auto compressed = compressed_pages.find({pid, page_number});
+    if (compressed != compressed_pages.end()) {
+        return compressed_pool.load(compressed->second, buffer);
+    }
+    auto slot = swapped_pages.find({pid, page_number});
+    if (slot == swapped_pages.end()) {
+        return false;
+    }
+    swap_area.read_slot(slot->second, buffer);
+    return true;
+}
+
+bool MemoryManager::has_swapped_page(ProcessID pid, uint64_t page_number) const {
+    return writeback_pending.count({pid, page_number}) > 0 || compressed_pages.count({pid, page_number}) > 0 ||
+           swapped_pages.count({pid, page_number}) > 0;
+}
+
+void MemoryManager::drop_swapped_pages(ProcessID pid, uint64_t first_page, uint64_t end_page) {
+    auto first = swapped_pages.lower_bound({pid, first_page});
+    auto last = swapped_pages.lower_bound({pid, end_page});
+    for (auto it = first; it != last; ++it) {
+        swap_area.free_slot(it->second);
+    }
+    swapped_pages.erase(first, last);
+    auto first_compressed = compressed_pages.lower_bound({pid, first_page});
+    auto last_compressed = compressed_pages.lower_bound({pid, end_page});
+    for (auto it = first_compressed; it != last_compressed; ++it) {
+        compressed_pool.release(it->second);
+    }
+    compressed_pages.erase(first_compressed, last_compressed);
+    writeback_pending.erase(writeback_pending.lower_bound({pid, first_page}), writeback_pending.lower_bound({pid, end_page}));
+}
+
+PageFaultStats& MemoryManager::stats_for(ProcessID pid) {
+    if (cached_stats == nullptr || cached_stats_pid != pid) {
+        cached_stats = &fault_stats[pid];
+        cached_stats_pid = pid;
+    }
+    return *cached_stats;
+}
+
+void MemoryManager::set_page_table_layout(PageTableLayout layout) {
+    page_table_layout = layout;
+}
+
+PageTableLayout MemoryManager::get_page_table_layout() const {
+    return page_table_layout;
+}
+
+const PageTable* MemoryManager::get_page_table(ProcessID pid) const {
+    auto it = page_tables.find(pid);
+    return it == page_tables.end() ? nullptr : &it->second.table;
+}
+
+uint64_t MemoryManager::get_reclaimable_memory(ProcessID pid) {
+    auto it = page_tables.find(pid);
+    if (it == page_tables.end()) {
+        return 0;
+    }
+    uint64_t frames = 0;
+    it->second.table.for_each([&](uint64_t, PageTableEntry& pte) {
+        if (pte.huge) {
+            frames += HUGE_PAGE_FRAMES;
+            return;
+        }
+        auto file_page = file_frame_owner.find(pte.frame_number);
+        if (file_page != file_frame_owner.end()) {
+            frames += file_pages.at(file_page->second).mappers.size() == 1 ? 1 : 0;
+            return;
+        }
+        if (!shm_frame_owner.count(pte.frame_number) && !shared_frames.count(pte.frame_number)) {
+            ++frames;
+        }
+    });
+    return frames * PAGE_SIZE;
+}
+
+bool MemoryManager::fits_after_release(ProcessID pid, uint64_t size) {
+    switch (current_strategy) {
+        case MemoryAllocationStrategy::CONTINUOUS: {
+            uint64_t released = 0;
+            for (const auto& entry : continuous_blocks) {
+                if (entry.second.owner == pid) {
+                    released += entry.second.size;
+                }
+            }
+            if (relocation_callback) {
+                return free_list.total_free() + released >= size; // 分配失败时先紧凑
+            }
+            // 已分配块之间的空隙都是空闲空间，与该进程的块连成一段
+            uint64_t run = 0;
+            uint64_t run_end = 0;
+            for (const auto& entry : continuous_blocks) {
+                run += entry.first - run_end;
+                if (run >= size) {
+                    return true;
+                }
+                run = entry.second.owner == pid ? run + entry.second.size : 0;
+                run_end = entry.first + entry.second.size;
+            }
+            return run + (MEMORY_SIZE - run_end) >= size;
+        }
+
+        case MemoryAllocationStrategy::PARTITIONED: {
+            if (free_partitions_by_size.lower_bound(size) != free_partitions_by_size.end()) {
+                return true;
+            }
+            auto owned = partitions_by_pid.find(pid);
+            if (owned == partitions_by_pid.end()) {
+                return false;
+            }
+            for (size_t index : owned->second) {
+                if (partitions[index].size >= size) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        case MemoryAllocationStrategy::BUDDY: {
+            uint64_t needed = buddy.rounded_size(size);
+            if (needed < size) {
+                return false; // 超过最大的块
+            }
+            auto owned = buddy_blocks.find(pid);
+            if (owned == buddy_blocks.end() || buddy.largest_free_block() >= needed) {
+                return buddy.largest_free_block() >= needed;
+            }
+            BuddyAllocator released = buddy; // 在副本上释放，得到合并后的空闲块
+            for (const auto& block : owned->second) {
+                released.free(block.base_address);
+            }
+            return released.largest_free_block() >= needed;
+        }
+
+        case MemoryAllocationStrategy::PAGED:
+            return get_free_memory() + get_reclaimable_memory(pid) >= size;
+
+        default:
+            return false;
+    }
+}
+
+int MemoryManager::create_memory_group(const std::string& name, uint64_t hard_limit, uint64_t soft_limit) {
+    int id = next_memory_group_id++;
+    memory_groups.emplace(id, MemoryGroup{id, name, hard_limit, soft_limit, 0, 0, 0, 0, {}});
+    return id;
+}
+
+bool MemoryManager::set_memory_group_limits(int group_id, uint64_t hard_limit, uint64_t soft_limit) {
+    auto it = memory_groups.find(group_id);
+    if (it == memory_groups.end() || group_id == ROOT_MEMORY_GROUP) {
+        return false;
+    }
+    it->second.hard_limit = hard_limit;
+    it->second.soft_limit = soft_limit;
+    return true;
+}
+
+bool MemoryManager::remove_memory_group(int group_id) {
+    auto it = memory_groups.find(group_id);
+    if (it == memory_groups.end() || group_id == ROOT_MEMORY_GROUP || !it->second.members.empty()) {
+        return false;
+    }
+    memory_groups.erase(it);
+    return true;
+}
+
+bool MemoryManager::move_to_memory_group(ProcessID pid, int group_id) {
+    if (!memory_groups.count(group_id)) {
+        return false;
+    }
+    int old_group = get_memory_group_of(pid);
+    if (old_group == group_id) {
+        return true;
+    }
+    uint64_t bytes = get_memory_charge(pid);
+    if (!memory_group_fits(group_id, bytes)) {
+        ++memory_groups.at(group_id).failures;
+        return false;
+    }
+    uncharge(pid, bytes);
+    memory_groups.at(old_group).members.erase(pid);
+    process_groups[pid] = group_id;
+    memory_groups.at(group_id).members.insert(pid);
+    charge(pid, bytes);
+    return true;
+}
+
+int MemoryManager::get_memory_group_of(ProcessID pid) const {
+    auto it = process_groups.find(pid);
+    return it == process_groups.end() ? ROOT_MEMORY_GROUP : it->second;
+}
+
+uint64_t MemoryManager::get_memory_charge(ProcessID pid) const {
+    auto it = process_charges.find(pid);
+    return it == process_charges.end() ? 0 : it->second;
+}
+
+const MemoryGroup* MemoryManager::get_memory_group(int group_id) const {
+    auto it = memory_groups.find(group_id);
+    return it == memory_groups.end() ? nullptr : &it->second;
+}
+
+const std::map<int, MemoryGroup>& MemoryManager::get_memory_groups() const {
+    return memory_groups;
+}
+
+bool MemoryManager::memory_group_fits(int group_id, uint64_t bytes) const {
+    auto it = memory_groups.find(group_id);
+    if (it == memory_groups.end()) {
+        return false;
+    }
+    const MemoryGroup& group = it->second;
+    return group.hard_limit == 0 || (group.usage <= group.hard_limit && bytes <= group.hard_limit - group.usage);
+}
+
+bool MemoryManager::try_charge(ProcessID pid, uint64_t bytes) {
+    int group_id = get_memory_group_of(pid);
+    if (!memory_group_fits(group_id, bytes)) {
+        ++memory_groups.at(group_id).failures;
+        return false;
+    }
+    charge(pid, bytes);
+    return true;
+}
+
+void MemoryManager::charge(ProcessID pid, uint64_t bytes) {
+    MemoryGroup& group = memory_groups.at(get_memory_group_of(pid));
+    bool was_over = group.over_soft_limit();
+    group.usage += bytes;
+    group.peak = std::max(group.peak, group.usage);
+    group.members.insert(pid);
+    process_charges[pid] += bytes;
+    if (!was_over && group.over_soft_limit()) {
+        ++group.soft_limit_breaches;
+    }
+}
+
+void MemoryManager::uncharge(ProcessID pid, uint64_t bytes) {
+    auto it = process_charges.find(pid);
+    if (it == process_charges.end()) {
+        return;
+    }
+    bytes = std::min(bytes, it->second);
+    it->second -= bytes;
+    memory_groups.at(get_memory_group_of(pid)).usage -= bytes;
+}
+
+void MemoryManager::release_memory_group(ProcessID pid) {
+    uncharge(pid, get_memory_charge(pid));
+    memory_groups.at(get_memory_group_of(pid)).members.erase(pid);
+    process_charges.erase(pid);
+    process_groups.erase(pid);
+}
+
+uint64_t MemoryManager::charged_bytes(const VmaTree& vmas, uint64_t first_page, uint64_t pages) const {
+    uint64_t charged = 0;
+    for (const Vma& vma : vmas.overlapping(first_page, pages)) {
+        if (vma.kind == VmaKind::ANONYMOUS || vma.kind == VmaKind::HEAP) {
+            charged += vma.pages * PAGE_SIZE;
+        }
+    }
+    return charged;
+}
+
+uint64_t MemoryManager::get_page_table_memory() const {
+    uint64_t bytes = 0;
+    for (const auto& entry : page_tables) {
+        bytes += entry.second.table.memory_bytes();
+    }
+    return bytes;
+}
+
+std::vector<OccupancyBucket> MemoryManager::get_occupancy_map(size_t buckets) const {
+    return occupancy.summarize(buckets);
+}
+
+uint64_t MemoryManager::get_page_walks() const {
+    uint64_t walks = retired_page_walks;
+    for (const auto& entry : page_tables) {
+        walks += entry.second.table.walks();
+    }
+    return walks;
+}
+
+bool MemoryManager::configure_tlb(size_t sets, size_t ways) {
+    return tlb.configure(sets, ways);
+}
+
+const Tlb& MemoryManager::get_tlb() const {
+    return tlb;
+}
+
+const FreeBlockIndex& MemoryManager::get_free_blocks() const {
+    return free_list;
+}
+
+const std::vector<Partition>& MemoryManager::get_partitions() const {
+    return partitions;
+}
+
+uint64_t MemoryManager::get_total_memory() const {
+    return MEMORY_SIZE;
+}
+
+uint64_t MemoryManager::get_used_memory() const {
+    return used_memory;
+}
+
+uint64_t MemoryManager::get_free_memory() const {
+    return MEMORY_SIZE - used_memory;
+}
+
+std::string MemoryManager::read_memory(uint64_t address, size_t size) const {
+    if (address + size > MEMORY_SIZE || memory_pool.data() == nullptr) {
+        throw std::runtime_error("Invalid memory access");
+    }
+    std::string result(size, '\0');
+    memory_pool.read(address, &result[0], size);
+    return result;
+}
+
+void MemoryManager::write_memory(uint64_t address, const std::string& data) {
+    if (address + data.size() > MEMORY_SIZE || memory_pool.data() == nullptr) {
+        throw std::runtime_error("Invalid memory access");
+    }
+    memory_pool.write(address, data.data(), data.size());
+}
+
+void MemoryManager::read_memory(uint64_t address, void* buffer, size_t size) const {
+    if (address + size > MEMORY_SIZE || memory_pool.data() == nullptr) {
+        throw std::runtime_error("Invalid memory access in read");
+    }
+    memory_pool.read(address, buffer, size);
+}
+
+void MemoryManager::write_memory(uint64_t address, const void* data, size_t size) {
+    if (address + size > MEMORY_SIZE || memory_pool.data() == nullptr) {
+        throw std::runtime_error("Invalid memory access in write");
+    }
+    memory_pool.write(address, data, size);
+}
+
+void MemoryManager::write_memory(ProcessID pid, uint64_t virtual_address, const void* data, size_t size) {
+    if (!write_virtual(pid, virtual_address, data, size)) {
+        throw std::runtime_error("Invalid virtual memory access in write");
+    }
+}
+
+bool MemoryManager::read_virtual(ProcessID pid, uint64_t virtual_address, void* buffer, size_t size) {
+    return copy_virtual(pid, virtual_address, static_cast<char*>(buffer), size, false);
+}
+
+bool MemoryManager::write_virtual(ProcessID pid, uint64_t virtual_address, const void* data, size_t size) {
+    return copy_virtual(pid, virtual_address, const_cast<char*>(static_cast<const char*>(data)), size, true);
+}
+
+size_t MemoryManager::readv_virtual(ProcessID pid, const std::vector<VirtualIoVec>& iov) {
+    size_t copied = 0;
+    for (const auto& vec : iov) {
+        if (!read_virtual(pid, vec.virtual_address, vec.buffer, vec.size)) {
+            break;
+        }
+        copied += vec.size;
+    }
+    return copied;
+}
+
+size_t MemoryManager::writev_virtual(ProcessID pid, const std::vector<VirtualIoVec>& iov) {
+    size_t copied = 0;
+    for (const auto& vec : iov) {
+        if (!write_virtual(pid, vec.virtual_address, vec.buffer, vec.size)) {
+            break;
+        }
+        copied += vec.size;
+    }
+    return copied;
+}
+
+bool MemoryManager::copy_virtual(ProcessID pid, uint64_t virtual_address, char* buffer, size_t size, bool is_write) {
+    if (current_strategy != MemoryAllocationStrategy::PAGED) {
+        // 非分页模式，虚拟地址即物理地址，只能访问进程自己的内存块
+        if (!owns_physical_range(pid, virtual_address, size)) {
+            return false;
+        }
+        if (is_write) {
+            memory_pool.write(virtual_address, buffer, size);
+        } else {
+            memory_pool.read(virtual_address, buffer, size);
+        }
+        return true;
+    }
+
+    // 先转换整个区间并固定已转换的页框（之后的缺页不会换出它们），再按物理连续的区间批量复制。
+    // 可换出的页框全部已固定而转换失败时，先复制已转换的部分并解除固定，再重试
+    struct CopyRun {
+        uint64_t address;
+        size_t size;
+        char* buffer;
+    };
+    std::vector<CopyRun> runs;
+    auto flush = [&]() {
+        for (const CopyRun& run : runs) {
+            if (is_write) {
+                memory_pool.write(run.address, run.buffer, run.size);
+            } else {
+                memory_pool.read(run.address, run.buffer, run.size);
+            }
+            ++virtual_copy_runs;
+        }
+        runs.clear();
+        page_replacer.unpin_all();
+    };
+
+    while (size > 0) {
+        size_t chunk = std::min<uint64_t>(size, PAGE_SIZE - virtual_address % PAGE_SIZE);
+        auto physical = translate_virtual_to_physical(pid, virtual_address, is_write);
+        if (!physical && !runs.empty()) {
+            flush();
+            physical = translate_virtual_to_physical(pid, virtual_address, is_write);
+        }
+        if (!physical) {
+            flush();
+            return false;
+        }
+        page_replacer.pin(*physical / PAGE_SIZE);
+        if (!runs.empty() && runs.back().address + runs.back().size == *physical) {
+            runs.back().size += chunk;
+        } else {
+            runs.push_back({*physical, chunk, buffer});
+        }
+        buffer += chunk;
+        virtual_address += chunk;
+        size -= chunk;
+    }
+    flush();
+    return true;
+}
+
+uint64_t MemoryManager::get_virtual_copy_runs() const {
+    return virtual_copy_runs;
+}
+
+bool MemoryManager::owns_physical_range(ProcessID pid, uint64_t address, uint64_t size) const {
+    if (address >= MEMORY_SIZE || size > MEMORY_SIZE - address) {
+        return false;
+    }
+    auto contains = [&](uint64_t base, uint64_t block_size) {
+        return address >= base && address - base < block_size && size <= block_size - (address - base);
+    };
+    switch (current_strategy) {
+        case MemoryAllocationStrategy::CONTINUOUS: {
+            auto block = continuous_blocks.upper_bound(address);
+            if (block == continuous_blocks.begin()) {
+                return false;
+            }
+            --block;
+            return block->second.owner == pid && contains(block->first, block->second.size);
+        }
+
+        case MemoryAllocationStrategy::PARTITIONED: {
+            auto owned = partitions_by_pid.find(pid);
+            if (owned == partitions_by_pid.end()) {
+                return false;
+            }
+            for (size_t index : owned->second) {
+                if (contains(partitions[index].base_address, partitions[index].size)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        case MemoryAllocationStrategy::BUDDY: {
+            auto owned = buddy_blocks.find(pid);
+            if (owned == buddy_blocks.end()) {
+                return false;
+            }
+            for (const auto& block : owned->second) {
+                if (contains(block.base_address, block.block_size)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// === 新增分页统计信息接口实现 ===
+uint64_t MemoryManager::get_total_pages() const {
+    return TOTAL_PAGES;
+}
 
 uint64_t MemoryManager::get_used_pages() const {
-    return page_frames.count();
+    return page_frames.used_count();
 }
 
 uint64_t MemoryManager::get_free_pages() const {
-    return TOTAL_PAGES - page_frames.count();
+    return page_frames.free_count();
+}
+
+const BuddyAllocator& MemoryManager::get_buddy_allocator() const {
+    return buddy;
+}
+
+uint64_t MemoryManager::get_buddy_internal_fragmentation() const {
+    return buddy_allocated_bytes - buddy_requested_bytes;
 } 
\ No newline at end of file
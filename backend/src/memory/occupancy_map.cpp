@@ -0,0 +1,77 @@
+#include "memory/occupancy_map.h"
+#include <algorithm>
+
+OccupancyMap::OccupancyMap(uint64_t memory_size)
+    : memory_size_(memory_size), used_(0), regions_((memory_size + REGION_SIZE - 1) / REGION_SIZE) {}
+
+void OccupancyMap::reset() {
+    for (auto& region : regions_) {
+        region.used = 0;
+        region.owners.clear();
+    }
+    used_ = 0;
+}
+
+template <typename Fn>
+void OccupancyMap::for_each_region(uint64_t base, uint64_t size, Fn apply) {
+    uint64_t end = std::min(base + size, memory_size_);
+    while (base < end) {
+        uint64_t index = base / REGION_SIZE;
+        uint64_t chunk = std::min(end, (index + 1) * REGION_SIZE) - base;
+        apply(regions_[index], chunk);
+        base += chunk;
+    }
+}
+
+void OccupancyMap::add(uint64_t base, uint64_t size, ProcessID owner) {
+    for_each_region(base, size, [&](Region& region, uint64_t bytes) {
+        region.used += bytes;
+        region.owners[owner] += bytes;
+        used_ += bytes;
+    });
+}
+
+void OccupancyMap::remove(uint64_t base, uint64_t size, ProcessID owner) {
+    for_each_region(base, size, [&](Region& region, uint64_t bytes) {
+        // 记录不一致时按实际记入的字节数扣除，不让计数回绕
+        auto it = region.owners.find(owner);
+        uint64_t removed = it == region.owners.end() ? 0 : std::min(bytes, it->second);
+        if (removed > 0) {
+            it->second -= removed;
+            if (it->second == 0) {
+                region.owners.erase(it);
+            }
+        }
+        region.used -= removed;
+        used_ -= removed;
+    });
+}
+
+std::vector<OccupancyBucket> OccupancyMap::summarize(size_t buckets) const {
+    size_t regions = regions_.size();
+    buckets = std::max<size_t>(1, std::min(buckets, regions));
+    std::vector<OccupancyBucket> result;
+    result.reserve(buckets);
+    std::map<ProcessID, uint64_t> owners;
+    for (size_t i = 0; i < buckets; ++i) {
+        size_t first = i * regions / buckets;
+        size_t last = (i + 1) * regions / buckets;
+        OccupancyBucket bucket{first * REGION_SIZE, std::min<uint64_t>(last * REGION_SIZE, memory_size_) - first * REGION_SIZE, 0, 0, -1, 0};
+        owners.clear();
+        for (size_t r = first; r < last; ++r) {
+            bucket.used += regions_[r].used;
+            for (const auto& entry : regions_[r].owners) {
+                owners[entry.first] += entry.second;
+            }
+        }
+        bucket.owners = owners.size();
+        for (const auto& entry : owners) {
+            if (entry.second > bucket.top_owner_bytes) {
+                bucket.top_owner = entry.first;
+                bucket.top_owner_bytes = entry.second;
+            }
+        }
+        result.push_back(bucket);
+    }
+    return result;
+}
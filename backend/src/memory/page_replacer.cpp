@@ -0,0 +1,183 @@
+#include "memory/page_replacer.h"
+#include <algorithm>
+
+PageReplacer::PageReplacer()
+    : policy_(PageReplacementPolicy::FIFO), clock_hand_(clock_.end()), next_load_seq_(0), pinned_count_(0), trace_cursor_(0) {}
+
+void PageReplacer::clear() {
+    entries_.clear();
+    fifo_.clear();
+    lru_.clear();
+    clock_.clear();
+    clock_hand_ = clock_.end();
+    lfu_.clear();
+    next_load_seq_ = 0;
+    pinned_.clear();
+    pinned_count_ = 0;
+    trace_positions_.clear();
+    trace_cursor_ = 0;
+}
+
+void PageReplacer::insert(uint64_t frame, ProcessID pid, uint64_t page_number) {
+    erase(frame);
+    Entry entry;
+    entry.page = ResidentPage{pid, page_number};
+    entry.fifo_pos = fifo_.insert(fifo_.end(), frame);
+    entry.lru_pos = lru_.insert(lru_.end(), frame);
+    // 插在时钟指针之前，转满一圈后才会被检查
+    entry.clock_pos = clock_.insert(clock_hand_, frame);
+    entry.frequency = 0;
+    entry.load_seq = next_load_seq_++;
+    entry.pinned = false;
+    lfu_.insert({entry.frequency, entry.load_seq, frame});
+    entries_.emplace(frame, entry);
+}
+
+void PageReplacer::erase(uint64_t frame) {
+    auto it = entries_.find(frame);
+    if (it == entries_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    fifo_.erase(entry.fifo_pos);
+    lru_.erase(entry.lru_pos);
+    if (clock_hand_ == entry.clock_pos) {
+        ++clock_hand_;
+    }
+    clock_.erase(entry.clock_pos);
+    lfu_.erase({entry.frequency, entry.load_seq, frame});
+    if (entry.pinned) {
+        --pinned_count_;
+    }
+    entries_.erase(it);
+}
+
+void PageReplacer::pin(uint64_t frame) {
+    auto it = entries_.find(frame);
+    if (it == entries_.end() || it->second.pinned) {
+        return;
+    }
+    it->second.pinned = true;
+    pinned_.push_back(frame);
+    ++pinned_count_;
+}
+
+void PageReplacer::unpin_all() {
+    for (uint64_t frame : pinned_) {
+        auto it = entries_.find(frame);
+        if (it != entries_.end()) {
+            it->second.pinned = false;
+        }
+    }
+    pinned_.clear();
+    pinned_count_ = 0;
+}
+
+void PageReplacer::retarget(uint64_t frame, ProcessID pid, uint64_t page_number) {
+    auto it = entries_.find(frame);
+    if (it != entries_.end()) {
+        it->second.page = ResidentPage{pid, page_number};
+    }
+}
+
+void PageReplacer::touch(uint64_t frame) {
+    auto it = entries_.find(frame);
+    if (it != entries_.end()) {
+        Entry& entry = it->second;
+        lru_.splice(lru_.end(), lru_, entry.lru_pos);
+        lfu_.erase({entry.frequency, entry.load_seq, frame});
+        ++entry.frequency;
+        lfu_.insert({entry.frequency, entry.load_seq, frame});
+    }
+    if (!trace_positions_.empty()) {
+        ++trace_cursor_;
+    }
+}
+
+std::optional<uint64_t> PageReplacer::select_victim(const std::function<bool(const ResidentPage&)>& test_and_clear_referenced) {
+    if (entries_.size() == pinned_count_) {
+        return std::nullopt;
+    }
+    auto first_unpinned = [this](const std::list<uint64_t>& order) {
+        for (uint64_t frame : order) {
+            if (!entries_.at(frame).pinned) {
+                return frame;
+            }
+        }
+        return order.front(); // 不会到达：至少有一个页框未固定
+    };
+    switch (policy_) {
+        case PageReplacementPolicy::FIFO:
+            return first_unpinned(fifo_);
+        case PageReplacementPolicy::LRU:
+            return first_unpinned(lru_);
+        case PageReplacementPolicy::CLOCK:
+            return select_clock(test_and_clear_referenced);
+        case PageReplacementPolicy::LFU:
+            for (const auto& entry : lfu_) {
+                if (!entries_.at(std::get<2>(entry)).pinned) {
+                    return std::get<2>(entry);
+                }
+            }
+            return std::nullopt;
+        case PageReplacementPolicy::OPT:
+            return select_opt();
+    }
+    return std::nullopt;
+}
+
+uint64_t PageReplacer::select_clock(const std::function<bool(const ResidentPage&)>& test_and_clear_referenced) {
+    // 访问位为 1 的页面获得二次机会；最多转两圈必然找到访问位为 0 的页面
+    while (true) {
+        if (clock_hand_ == clock_.end()) {
+            clock_hand_ = clock_.begin();
+        }
+        uint64_t frame = *clock_hand_;
+        const Entry& entry = entries_.at(frame);
+        if (!entry.pinned && !test_and_clear_referenced(entry.page)) {
+            return frame;
+        }
+        ++clock_hand_;
+    }
+}
+
+uint64_t PageReplacer::select_opt() const {
+    // 未设置访问序列时所有页面都"不再使用"，退化为 FIFO
+    uint64_t victim = UINT64_MAX;
+    size_t farthest = 0;
+    for (uint64_t frame : fifo_) {
+        if (entries_.at(frame).pinned) {
+            continue;
+        }
+        const ResidentPage& page = entries_.at(frame).page;
+        size_t next_use = SIZE_MAX;
+        auto positions = trace_positions_.find({page.pid, page.page_number});
+        if (positions != trace_positions_.end()) {
+            auto next = std::lower_bound(positions->second.begin(), positions->second.end(), trace_cursor_);
+            if (next != positions->second.end()) {
+                next_use = *next;
+            }
+        }
+        if (next_use == SIZE_MAX) {
+            return frame; // 之后不再使用，调入最早的优先
+        }
+        if (victim == UINT64_MAX || next_use > farthest) {
+            farthest = next_use;
+            victim = frame;
+        }
+    }
+    return victim;
+}
+
+void PageReplacer::set_reference_trace(const std::vector<ResidentPage>& trace) {
+    trace_positions_.clear();
+    trace_cursor_ = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        trace_positions_[{trace[i].pid, trace[i].page_number}].push_back(i);
+    }
+}
+
+const ResidentPage* PageReplacer::find(uint64_t frame) const {
+    auto it = entries_.find(frame);
+    return it == entries_.end() ? nullptr : &it->second.page;
+}
@@ -0,0 +1,246 @@
+#include "memory/page_table.h"
+
+PageTable::PageTable(PageTableLayout layout)
+    : layout_(layout), resident_(0), walks_(0), walk_steps_(0) {
+    switch (layout_) {
+        case PageTableLayout::FLAT:
+            break;
+        case PageTableLayout::RADIX_2:
+            level_bits_ = {10, 10};
+            break;
+        case PageTableLayout::RADIX_4:
+            level_bits_ = {9, 9, 9, 9};
+            break;
+    }
+    if (!level_bits_.empty()) {
+        new_inner(0); // 根结点常驻
+    }
+}
+
+uint64_t PageTable::max_pages() const {
+    if (layout_ == PageTableLayout::FLAT) {
+        return TOTAL_PAGES; // 线性页表按最高页号稠密分配，虚拟地址空间与物理内存同为 32 位
+    }
+    uint32_t bits = 0;
+    for (uint32_t b : level_bits_) {
+        bits += b;
+    }
+    return 1ULL << bits;
+}
+
+uint64_t PageTable::index_at(uint64_t page_number, size_t level) const {
+    uint32_t shift = 0;
+    for (size_t i = level + 1; i < level_bits_.size(); ++i) {
+        shift += level_bits_[i];
+    }
+    return (page_number >> shift) & ((1ULL << level_bits_[level]) - 1);
+}
+
+int32_t PageTable::new_inner(size_t level) {
+    InnerNode node{std::vector<int32_t>(1ULL << level_bits_[level], NIL), 0};
+    if (!free_inner_.empty()) {
+        int32_t idx = free_inner_.back();
+        free_inner_.pop_back();
+        inner_[idx] = std::move(node);
+        return idx;
+    }
+    inner_.push_back(std::move(node));
+    return static_cast<int32_t>(inner_.size() - 1);
+}
+
+int32_t PageTable::new_leaf() {
+    LeafNode leaf{std::vector<PageTableEntry>(1ULL << level_bits_.back()), 0};
+    if (!free_leaves_.empty()) {
+        int32_t idx = free_leaves_.back();
+        free_leaves_.pop_back();
+        leaves_[idx] = std::move(leaf);
+        return idx;
+    }
+    leaves_.push_back(std::move(leaf));
+    return static_cast<int32_t>(leaves_.size() - 1);
+}
+
+PageTableEntry* PageTable::walk(uint64_t page_number) const {
+    ++walks_;
+    if (!huge_.empty()) {
+        auto huge = huge_.find(page_number / HUGE_PAGE_FRAMES);
+        if (huge != huge_.end()) {
+            // 大页表项位于叶结点的上一级
+            walk_steps_ += level_bits_.empty() ? 1 : level_bits_.size() - 1;
+            return const_cast<PageTableEntry*>(&huge->second);
+        }
+    }
+    PageTableEntry* entry = nullptr;
+    if (layout_ == PageTableLayout::FLAT) {
+        ++walk_steps_;
+        if (page_number < flat_.size()) {
+            entry = const_cast<PageTableEntry*>(&flat_[page_number]);
+        }
+    } else if (page_number < max_pages()) {
+        int32_t node = 0;
+        size_t leaf_level = level_bits_.size() - 1;
+        for (size_t level = 0; level < leaf_level && node != NIL; ++level) {
+            ++walk_steps_;
+            node = inner_[node].children[index_at(page_number, level)];
+        }
+        if (node != NIL) {
+            ++walk_steps_;
+            entry = const_cast<PageTableEntry*>(&leaves_[node].entries[index_at(page_number, leaf_level)]);
+        }
+    }
+    return (entry != nullptr && entry->valid) ? entry : nullptr;
+}
+
+PageTableEntry* PageTable::find(uint64_t page_number) {
+    return walk(page_number);
+}
+
+const PageTableEntry* PageTable::find(uint64_t page_number) const {
+    return walk(page_number);
+}
+
+PageTableEntry& PageTable::map(uint64_t page_number, uint64_t frame_number) {
+    PageTableEntry* entry;
+    uint32_t* live;
+    if (layout_ == PageTableLayout::FLAT) {
+        if (page_number >= flat_.size()) {
+            flat_.resize(page_number + 1);
+        }
+        entry = &flat_[page_number];
+        live = nullptr;
+    } else {
+        int32_t node = 0;
+        size_t leaf_level = level_bits_.size() - 1;
+        for (size_t level = 0; level < leaf_level; ++level) {
+            uint64_t idx = index_at(page_number, level);
+            int32_t child = inner_[node].children[idx];
+            if (child == NIL) {
+                // 新结点可能导致 inner_ 扩容，不能提前持有引用
+                child = (level + 1 == leaf_level) ? new_leaf() : new_inner(level + 1);
+                inner_[node].children[idx] = child;
+                ++inner_[node].live;
+            }
+            node = child;
+        }
+        entry = &leaves_[node].entries[index_at(page_number, leaf_level)];
+        live = &leaves_[node].live;
+    }
+
+    if (!entry->valid) {
+        ++resident_;
+        if (live != nullptr) {
+            ++*live;
+        }
+    }
+    *entry = PageTableEntry();
+    entry->valid = true;
+    entry->frame_number = frame_number;
+    return *entry;
+}
+
+void PageTable::unmap(uint64_t page_number) {
+    if (layout_ == PageTableLayout::FLAT) {
+        if (page_number < flat_.size() && flat_[page_number].valid) {
+            flat_[page_number] = PageTableEntry();
+            --resident_;
+        }
+        return;
+    }
+    if (page_number >= max_pages()) {
+        return;
+    }
+
+    // 记录路径，叶结点变空后自底向上回收
+    size_t leaf_level = level_bits_.size() - 1;
+    std::vector<int32_t> path(leaf_level + 1, NIL);
+    int32_t node = 0;
+    for (size_t level = 0; level < leaf_level; ++level) {
+        path[level] = node;
+        node = inner_[node].children[index_at(page_number, level)];
+        if (node == NIL) {
+            return;
+        }
+    }
+    PageTableEntry& entry = leaves_[node].entries[index_at(page_number, leaf_level)];
+    if (!entry.valid) {
+        return;
+    }
+    entry = PageTableEntry();
+    --resident_;
+    if (--leaves_[node].live > 0) {
+        return;
+    }
+
+    leaves_[node].entries = std::vector<PageTableEntry>();
+    free_leaves_.push_back(node);
+    for (size_t level = leaf_level; level-- > 0;) {
+        InnerNode& parent = inner_[path[level]];
+        parent.children[index_at(page_number, level)] = NIL;
+        if (--parent.live > 0 || level == 0) {
+            break;
+        }
+        parent.children = std::vector<int32_t>();
+        free_inner_.push_back(path[level]);
+    }
+}
+
+PageTableEntry& PageTable::map_huge(uint64_t huge_index, uint64_t first_frame) {
+    PageTableEntry& entry = huge_[huge_index];
+    entry = PageTableEntry();
+    entry.valid = true;
+    entry.huge = true;
+    entry.frame_number = first_frame;
+    return entry;
+}
+
+void PageTable::unmap_huge(uint64_t huge_index) {
+    huge_.erase(huge_index);
+}
+
+void PageTable::for_each(const std::function<void(uint64_t, PageTableEntry&)>& fn) {
+    for (auto& entry : huge_) {
+        fn(entry.first * HUGE_PAGE_FRAMES, entry.second);
+    }
+    if (layout_ == PageTableLayout::FLAT) {
+        for (uint64_t page = 0; page < flat_.size(); ++page) {
+            if (flat_[page].valid) {
+                fn(page, flat_[page]);
+            }
+        }
+        return;
+    }
+    for_each_in(0, 0, 0, fn);
+}
+
+void PageTable::for_each_in(int32_t node, size_t level, uint64_t prefix, const std::function<void(uint64_t, PageTableEntry&)>& fn) {
+    uint64_t fanout = 1ULL << level_bits_[level];
+    if (level + 1 == level_bits_.size()) {
+        for (uint64_t i = 0; i < fanout; ++i) {
+            PageTableEntry& entry = leaves_[node].entries[i];
+            if (entry.valid) {
+                fn((prefix << level_bits_[level]) | i, entry);
+            }
+        }
+        return;
+    }
+    for (uint64_t i = 0; i < fanout; ++i) {
+        int32_t child = inner_[node].children[i];
+        if (child != NIL) {
+            for_each_in(child, level + 1, (prefix << level_bits_[level]) | i, fn);
+        }
+    }
+}
+
+uint64_t PageTable::memory_bytes() const {
+    uint64_t bytes = huge_.size() * sizeof(PageTableEntry);
+    if (layout_ == PageTableLayout::FLAT) {
+        return bytes + flat_.capacity() * sizeof(PageTableEntry);
+    }
+    for (const auto& node : inner_) {
+        bytes += node.children.capacity() * sizeof(int32_t);
+    }
+    for (const auto& leaf : leaves_) {
+        bytes += leaf.entries.capacity() * sizeof(PageTableEntry);
+    }
+    return bytes;
+}
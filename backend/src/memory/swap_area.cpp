@@ -0,0 +1,87 @@
+#include "memory/swap_area.h"
+#include "common.h"
+#include "fs/fs_manager.h"
+#include <cstring>
+
+static_assert(BLOCK_SIZE == PAGE_SIZE, "swap slots map one page to one disk block");
+
+SwapArea::SwapArea() : fs_(nullptr), first_block_(0), slots_(0), next_memory_slot_(0) {}
+
+bool SwapArea::attach(FileSystemManager& fs, uint64_t slot_count) {
+    if (fs_ != nullptr || !memory_slots_.empty() || slot_count == 0 || slot_count > UINT32_MAX) {
+        return false;
+    }
+    auto blocks = fs.reserve_blocks(static_cast<uint32_t>(slot_count));
+    if (!blocks) {
+        return false;
+    }
+    fs_ = &fs;
+    first_block_ = blocks->start_block;
+    slots_ = FrameBitmap(slot_count);
+    return true;
+}
+
+bool SwapArea::detach() {
+    if (fs_ == nullptr || slots_.used_count() > 0) {
+        return false;
+    }
+    fs_->release_blocks({first_block_, static_cast<uint32_t>(slots_.size())});
+    fs_ = nullptr;
+    slots_ = FrameBitmap(0);
+    return true;
+}
+
+std::optional<uint64_t> SwapArea::allocate_slot() {
+    if (fs_ == nullptr) {
+        memory_slots_[next_memory_slot_];
+        return next_memory_slot_++;
+    }
+    uint64_t slot = slots_.allocate();
+    if (slot == UINT64_MAX) {
+        return std::nullopt;
+    }
+    return slot;
+}
+
+void SwapArea::free_slot(uint64_t slot) {
+    if (fs_ == nullptr) {
+        memory_slots_.erase(slot);
+        return;
+    }
+    if (slots_.clear(slot)) {
+        fs_->discard_block(first_block_ + static_cast<uint32_t>(slot));
+    }
+}
+
+void SwapArea::write_slot(uint64_t slot, const void* data) {
+    if (fs_ == nullptr) {
+        memory_slots_[slot].assign(static_cast<const char*>(data), PAGE_SIZE);
+        return;
+    }
+    fs_->write_block(first_block_ + static_cast<uint32_t>(slot), data);
+}
+
+void SwapArea::read_slot(uint64_t slot, void* buffer) const {
+    if (fs_ == nullptr) {
+        auto it = memory_slots_.find(slot);
+        if (it == memory_slots_.end() || it->second.empty()) {
+            std::memset(buffer, 0, PAGE_SIZE);
+        } else {
+            std::memcpy(buffer, it->second.data(), PAGE_SIZE);
+        }
+        return;
+    }
+    fs_->read_block(first_block_ + static_cast<uint32_t>(slot), buffer);
+}
+
+uint64_t SwapArea::capacity() const {
+    return fs_ == nullptr ? 0 : slots_.size();
+}
+
+uint64_t SwapArea::used_slots() const {
+    return fs_ == nullptr ? memory_slots_.size() : slots_.used_count();
+}
+
+bool SwapArea::has_free_slots(uint64_t count) const {
+    return fs_ == nullptr || slots_.free_count() >= count;
+}
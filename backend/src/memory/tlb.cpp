@@ -0,0 +1,113 @@
+#include "memory/tlb.h"
+
+Tlb::Tlb() : sets_(0), ways_(0), clock_(0) {
+    configure(DEFAULT_SETS, DEFAULT_WAYS);
+}
+
+bool Tlb::configure(size_t sets, size_t ways) {
+    if (sets != 0 && ((sets & (sets - 1)) != 0 || ways == 0)) {
+        return false;
+    }
+    sets_ = sets;
+    ways_ = sets == 0 ? 0 : ways;
+    entries_.assign(sets_ * ways_, Entry());
+    clock_ = 0;
+    return true;
+}
+
+size_t Tlb::set_index(ProcessID pid, uint64_t page_number) const {
+    // 混入进程 ID，避免各进程的低地址页面挤在同一组
+    uint64_t key = page_number ^ (static_cast<uint64_t>(static_cast<uint32_t>(pid)) * 0x9E3779B97F4A7C15ULL >> 32);
+    return static_cast<size_t>(key & (sets_ - 1));
+}
+
+Tlb::Entry* Tlb::find(ProcessID pid, uint64_t tag, bool huge) {
+    Entry* set = &entries_[set_index(pid, tag) * ways_];
+    for (size_t way = 0; way < ways_; ++way) {
+        if (set[way].valid && set[way].pid == pid && set[way].page_number == tag && set[way].huge == huge) {
+            return &set[way];
+        }
+    }
+    return nullptr;
+}
+
+std::optional<uint64_t> Tlb::lookup(ProcessID pid, uint64_t page_number, bool is_write) {
+    if (!enabled()) {
+        return std::nullopt;
+    }
+    Entry* entry = find(pid, page_number, false);
+    uint64_t offset = 0;
+    if (entry == nullptr) {
+        entry = find(pid, page_number / HUGE_PAGE_FRAMES, true);
+        offset = page_number % HUGE_PAGE_FRAMES;
+    }
+    if (entry == nullptr || (is_write && !entry->dirty)) {
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    ++stats_.hits;
+    entry->last_used = ++clock_;
+    return entry->frame_number + offset;
+}
+
+void Tlb::insert(ProcessID pid, uint64_t page_number, uint64_t frame_number, bool dirty, bool huge) {
+    if (!enabled()) {
+        return;
+    }
+    uint64_t tag = huge ? page_number / HUGE_PAGE_FRAMES : page_number;
+    Entry* target = find(pid, tag, huge);
+    if (target == nullptr) {
+        // 优先使用空闲表项，否则替换组内最久未用的表项
+        Entry* set = &entries_[set_index(pid, tag) * ways_];
+        target = &set[0];
+        for (size_t way = 0; way < ways_; ++way) {
+            if (!set[way].valid) {
+                target = &set[way];
+                break;
+            }
+            if (set[way].last_used < target->last_used) {
+                target = &set[way];
+            }
+        }
+    }
+    target->valid = true;
+    target->dirty = dirty;
+    target->huge = huge;
+    target->pid = pid;
+    target->page_number = tag;
+    target->frame_number = frame_number;
+    target->last_used = ++clock_;
+}
+
+void Tlb::invalidate(ProcessID pid, uint64_t page_number) {
+    if (!enabled()) {
+        return;
+    }
+    Entry* entries[] = {find(pid, page_number, false), find(pid, page_number / HUGE_PAGE_FRAMES, true)};
+    for (Entry* entry : entries) {
+        if (entry != nullptr) {
+            entry->valid = false;
+            ++stats_.invalidations;
+        }
+    }
+}
+
+void Tlb::flush(ProcessID pid) {
+    for (auto& entry : entries_) {
+        if (entry.valid && entry.pid == pid) {
+            entry.valid = false;
+            ++stats_.invalidations;
+        }
+    }
+    ++stats_.flushes;
+}
+
+void Tlb::flush_all() {
+    for (auto& entry : entries_) {
+        if (entry.valid) {
+            entry.valid = false;
+            ++stats_.invalidations;
+        }
+    }
+    ++stats_.flushes;
+}
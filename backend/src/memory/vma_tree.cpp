@@ -0,0 +1,155 @@
+#include "memory/vma_tree.h"
+#include <iterator>
+
+namespace {
+
+bool mergeable(const Vma& left, const Vma& right) {
+    return left.end_page() == right.start_page && left.prot == right.prot && left.kind == right.kind &&
+           left.kind != VmaKind::SHARED_MEMORY && left.file_id == right.file_id &&
+           (left.kind != VmaKind::FILE || left.file_page + left.pages == right.file_page);
+}
+
+} // namespace
+
+const Vma* VmaTree::find(uint64_t page_number) const {
+    auto it = areas_.upper_bound(page_number);
+    if (it == areas_.begin()) {
+        return nullptr;
+    }
+    --it;
+    return page_number < it->second.end_page() ? &it->second : nullptr;
+}
+
+bool VmaTree::is_free(uint64_t start_page, uint64_t pages) const {
+    if (find(start_page) != nullptr) {
+        return false;
+    }
+    auto next = areas_.lower_bound(start_page);
+    return next == areas_.end() || next->first >= start_page + pages;
+}
+
+bool VmaTree::covers(uint64_t start_page, uint64_t pages) const {
+    uint64_t page = start_page;
+    uint64_t end = start_page + pages;
+    while (page < end) {
+        const Vma* vma = find(page);
+        if (vma == nullptr) {
+            return false;
+        }
+        page = vma->end_page();
+    }
+    return true;
+}
+
+std::vector<Vma> VmaTree::overlapping(uint64_t start_page, uint64_t pages) const {
+    std::vector<Vma> result;
+    uint64_t end = start_page + pages;
+    auto it = areas_.upper_bound(start_page);
+    if (it != areas_.begin()) {
+        --it;
+    }
+    for (; it != areas_.end() && it->first < end; ++it) {
+        Vma piece = it->second;
+        uint64_t first = piece.start_page > start_page ? piece.start_page : start_page;
+        uint64_t last = piece.end_page() < end ? piece.end_page() : end;
+        if (first >= last) {
+            continue;
+        }
+        if (piece.kind == VmaKind::FILE) {
+            piece.file_page += first - piece.start_page;
+        }
+        piece.start_page = first;
+        piece.pages = last - first;
+        result.push_back(piece);
+    }
+    return result;
+}
+
+std::optional<uint64_t> VmaTree::find_gap(uint64_t pages, uint64_t limit) const {
+    uint64_t candidate = 0;
+    for (const auto& entry : areas_) {
+        if (entry.first >= candidate + pages) {
+            break;
+        }
+        candidate = entry.second.end_page();
+    }
+    if (candidate + pages > limit) {
+        return std::nullopt;
+    }
+    return candidate;
+}
+
+bool VmaTree::insert(const Vma& vma) {
+    if (vma.pages == 0 || !is_free(vma.start_page, vma.pages)) {
+        return false;
+    }
+    areas_.emplace(vma.start_page, vma);
+    merge_around(vma.start_page);
+    return true;
+}
+
+void VmaTree::remove(uint64_t start_page, uint64_t pages) {
+    uint64_t end = start_page + pages;
+    split_at(start_page);
+    split_at(end);
+    areas_.erase(areas_.lower_bound(start_page), areas_.lower_bound(end));
+}
+
+void VmaTree::protect(uint64_t start_page, uint64_t pages, uint32_t prot) {
+    uint64_t end = start_page + pages;
+    split_at(start_page);
+    split_at(end);
+    for (auto it = areas_.lower_bound(start_page); it != areas_.end() && it->first < end; ++it) {
+        it->second.prot = prot;
+    }
+    // 修改后的区间内部以及两端都可能变得可以合并
+    std::vector<uint64_t> starts;
+    for (auto it = areas_.lower_bound(start_page); it != areas_.end() && it->first <= end; ++it) {
+        starts.push_back(it->first);
+    }
+    for (auto it = starts.rbegin(); it != starts.rend(); ++it) {
+        if (areas_.count(*it)) {
+            merge_around(*it);
+        }
+    }
+}
+
+uint64_t VmaTree::end_page() const {
+    return areas_.empty() ? 0 : areas_.rbegin()->second.end_page();
+}
+
+void VmaTree::split_at(uint64_t page_number) {
+    auto it = areas_.upper_bound(page_number);
+    if (it == areas_.begin()) {
+        return;
+    }
+    --it;
+    Vma& vma = it->second;
+    if (vma.start_page == page_number || page_number >= vma.end_page()) {
+        return;
+    }
+    Vma upper = vma;
+    if (upper.kind == VmaKind::FILE) {
+        upper.file_page += page_number - vma.start_page;
+    }
+    upper.start_page = page_number;
+    upper.pages = vma.end_page() - page_number;
+    vma.pages = page_number - vma.start_page;
+    areas_.emplace(page_number, upper);
+}
+
+void VmaTree::merge_around(uint64_t start_page) {
+    auto it = areas_.find(start_page);
+    auto next = std::next(it);
+    if (next != areas_.end() && mergeable(it->second, next->second)) {
+        it->second.pages += next->second.pages;
+        areas_.erase(next);
+    }
+    if (it != areas_.begin()) {
+        auto prev = std::prev(it);
+        if (mergeable(prev->second, it->second)) {
+            prev->second.pages += it->second.pages;
+            areas_.erase(it);
+        }
+    }
+}
@@ -7,8 +7,40 @@
 #include <functional>
 #include <set>
 
+namespace {
+
+// 优先级与新近程度按总内存的千分比折算为页数
+const uint64_t OOM_PRIORITY_PERMILLE = 10;    // 每级优先级
+const uint64_t OOM_YOUTH_PERMILLE = 10;       // 刚创建的进程，随运行时间线性减少
+const uint64_t OOM_YOUTH_WINDOW_MS = 60000;   // 运行超过该时长的进程不再加分
+const uint64_t OOM_SOFT_LIMIT_PERMILLE = 1000; // 所属组超出软限制
+const size_t OOM_KILL_LOG_LIMIT = 64;
+
+uint64_t now_ms() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
 ProcessManager::ProcessManager(MemoryManager& mem_manager)
-    : memory_manager(mem_manager), next_pid(1), current_running_process(nullptr) {}
+    : memory_manager(mem_manager), next_pid(1), current_running_process(nullptr) {
+    // 连续分配紧凑移动内存块后，同步更新持有该块的 PCB
+    memory_manager.set_relocation_callback([this](uint64_t old_base, uint64_t new_base, uint64_t size) {
+        for (auto& entry : all_processes) {
+            for (auto& block : entry.second->memory_info) {
+                if (block.base_address == old_base && block.size == size) {
+                    block.base_address = new_base;
+                    return;
+                }
+            }
+        }
+    });
+}
+
+ProcessManager::~ProcessManager() {
+    memory_manager.set_relocation_callback(nullptr);
+}
 
 void ProcessManager::set_algorithm(SchedulingAlgorithm algo, uint64_t time_slice) {
     algorithm_ = algo;
@@ -30,28 +62,161 @@ std::optional<ProcessID> ProcessManager::create_process(uint64_t size, uint64_t
     return create_process("", size, cpu_time, priority, -1);
 }
 
-std::optional<ProcessID> ProcessManager::create_process(const std::string& name, uint64_t size, uint64_t cpu_time, uint32_t priority, ProcessID parent_pid) {
+std::optional<ProcessID> ProcessManager::create_process(const std::string& name, uint64_t size, uint64_t cpu_time, uint32_t priority, ProcessID parent_pid,
+                                                       std::optional<int> memory_group) {
     if (size == 0) {
         return std::nullopt;
     }
 
     ProcessID new_pid = next_pid++;
-    auto block_opt = memory_manager.allocate_for_process(new_pid, size);
+    int group = memory_group.value_or(parent_pid != -1 ? memory_manager.get_memory_group_of(parent_pid) : ROOT_MEMORY_GROUP);
+    std::optional<MemoryBlock> block_opt;
+    if (memory_manager.move_to_memory_group(new_pid, group)) {
+        block_opt = memory_manager.allocate_for_process(new_pid, size);
+        // 组的硬限制造成的失败不终止其他进程
+        while (!block_opt && oom_killer_enabled_ && memory_manager.memory_group_fits(group, size) && oom_kill(size, parent_pid)) {
+            block_opt = memory_manager.allocate_for_process(new_pid, size);
+        }
+    }
     if (!block_opt) {
+        memory_manager.free_process_memory(new_pid); // 撤销组成员关系
         next_pid--; // 回退PID
         return std::nullopt; // 内存不足
     }
 
+    auto pcb = register_process(new_pid, name, {block_opt.value()}, cpu_time, priority, parent_pid);
+
+    // 根据策略覆盖 base 地址
+    auto current_strategy = memory_manager.get_allocation_strategy();
+    if (current_strategy != MemoryAllocationStrategy::CONTINUOUS) {
+        uint64_t base_address = memory_manager.get_process_base_address(new_pid);
+        if (base_address != UINT64_MAX) {
+            pcb->memory_info[0].base_address = base_address;
+        }
+    }
+
+    return pcb->pid;
+}
+
+std::optional<ProcessID> ProcessManager::exec_process(FileSystemManager& fs, const std::string& path, const std::string& name, uint64_t cpu_time, uint32_t priority,
+                                                     std::optional<int> memory_group) {
+    auto image = fs.get_file_block_map(path);
+    if (!image || image->size == 0) {
+        return std::nullopt;
+    }
+    std::string process_name = name;
+    if (process_name.empty()) {
+        process_name = path.substr(path.find_last_of('/') + 1);
+    }
+
+    std::optional<ProcessID> pid;
+    if (memory_manager.get_allocation_strategy() == MemoryAllocationStrategy::PAGED) {
+        // 只建立映射，不分配页框
+        ProcessID new_pid = next_pid;
+        std::optional<uint64_t> address;
+        if (memory_manager.move_to_memory_group(new_pid, memory_group.value_or(ROOT_MEMORY_GROUP))) {
+            address = memory_manager.mmap_file(new_pid, fs, path, VMA_PROT_READ | VMA_PROT_EXEC, 0, 0, 0);
+        }
+        if (!address) {
+            memory_manager.free_process_memory(new_pid);
+        } else {
+            ++next_pid;
+            register_process(new_pid, process_name, {MemoryBlock(*address, image->size)}, cpu_time, priority, -1);
+            pid = new_pid;
+        }
+    } else {
+        pid = create_process(process_name, image->size, cpu_time, priority, -1, memory_group);
+    }
+    if (pid) {
+        all_processes[*pid]->image_path = path;
+    }
+    return pid;
+}
+
+void ProcessManager::set_oom_killer(bool enabled) {
+    oom_killer_enabled_ = enabled;
+}
+
+bool ProcessManager::is_oom_killer_enabled() const {
+    return oom_killer_enabled_;
+}
+
+uint64_t ProcessManager::oom_badness(ProcessID pid) const {
+    auto pcb = get_process(pid);
+    return pcb ? badness_of(*pcb, memory_footprint(*pcb)) : 0;
+}
+
+const std::deque<ProcessManager::OomKill>& ProcessManager::get_oom_kills() const {
+    return oom_kills_;
+}
+
+uint64_t ProcessManager::memory_footprint(const PCB& pcb) const {
+    if (memory_manager.get_allocation_strategy() == MemoryAllocationStrategy::PAGED) {
+        return memory_manager.get_reclaimable_memory(pcb.pid);
+    }
+    uint64_t bytes = 0;
+    for (const auto& block : pcb.memory_info) {
+        bytes += block.size;
+    }
+    return bytes;
+}
+
+uint64_t ProcessManager::badness_of(const PCB& pcb, uint64_t footprint) const {
+    if (footprint == 0) {
+        return 0; // 终止后释放不了内存
+    }
+    // 占用越多、优先级越低（数值越大）、创建越晚，越先被终止
+    uint64_t unit = memory_manager.get_total_memory() / PAGE_SIZE / 1000;
+    uint64_t now = now_ms();
+    uint64_t age = now - std::min(pcb.creation_time, now);
+    uint64_t youth = age < OOM_YOUTH_WINDOW_MS ? OOM_YOUTH_PERMILLE * unit * (OOM_YOUTH_WINDOW_MS - age) / OOM_YOUTH_WINDOW_MS : 0;
+    const MemoryGroup* group = memory_manager.get_memory_group(memory_manager.get_memory_group_of(pcb.pid));
+    uint64_t over_soft = group->over_soft_limit() ? OOM_SOFT_LIMIT_PERMILLE * unit : 0;
+    return (footprint + PAGE_SIZE - 1) / PAGE_SIZE + pcb.priority * OOM_PRIORITY_PERMILLE * unit + youth + over_soft;
+}
+
+bool ProcessManager::oom_kill(uint64_t requested_size, ProcessID protected_pid) {
+    std::shared_ptr<PCB> victim;
+    uint64_t victim_footprint = 0;
+    uint64_t victim_badness = 0;
+    for (const auto& entry : all_processes) {
+        if (entry.first == protected_pid) {
+            continue;
+        }
+        uint64_t footprint = memory_footprint(*entry.second);
+        uint64_t badness = badness_of(*entry.second, footprint);
+        // 按当前策略终止后仍容纳不下请求的进程不做候选，不白白终止进程
+        if (badness > victim_badness && memory_manager.fits_after_release(entry.first, requested_size)) {
+            victim = entry.second;
+            victim_footprint = footprint;
+            victim_badness = badness;
+        }
+    }
+    if (!victim) {
+        return false;
+    }
+
+    std::cout << "OOM killer: killed process " << victim->pid << " (" << victim->name << "), reclaimable "
+              << victim_footprint / 1024 << " KB, badness " << victim_badness << ", for a request of "
+              << requested_size / 1024 << " KB" << std::endl;
+    oom_kills_.push_back({victim->pid, victim->name, victim_footprint, victim_badness, requested_size, now_ms()});
+    if (oom_kills_.size() > OOM_KILL_LOG_LIMIT) {
+        oom_kills_.pop_front();
+    }
+    terminate_process(victim->pid);
+    return true;
+}
+
+std::shared_ptr<PCB> ProcessManager::register_process(ProcessID pid, const std::string& name, const std::vector<MemoryBlock>& memory_info, uint64_t cpu_time, uint32_t priority, ProcessID parent_pid) {
     auto pcb = std::make_shared<PCB>();
-    pcb->pid = new_pid;
+    pcb->pid = pid;
     pcb->state = ProcessState::READY;
-    pcb->memory_info.push_back(block_opt.value());
+    pcb->memory_info = memory_info;
     pcb->cpu_time = cpu_time;
     pcb->remaining_time = cpu_time;
     pcb->priority = priority;
-    pcb->creation_time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count());
-    pcb->name = name.empty() ? ("process_" + std::to_string(new_pid)) : name;
+    pcb->creation_time = now_ms();
+    pcb->name = name.empty() ? ("process_" + std::to_string(pid)) : name;
     pcb->parent_pid = parent_pid;
 
     // 挂载到父进程的子进程列表（如果需要）
@@ -62,22 +227,22 @@ std::optional<ProcessID> ProcessManager::create_process(const std::string& name,
         }
     }
 
-    // 根据策略覆盖 base 地址
-    auto current_strategy = memory_manager.get_allocation_strategy();
-    if (current_strategy != MemoryAllocationStrategy::CONTINUOUS) {
-        uint64_t base_address = memory_manager.get_process_base_address(new_pid);
-        if (base_address != UINT64_MAX) {
-            pcb->memory_info[0].base_address = base_address;
-        }
-    }
-
     all_processes[pcb->pid] = pcb;
     ready_queue.push_back(pcb);
-
-    return pcb->pid;
+    return pcb;
 }
 
 std::optional<ProcessID> ProcessManager::create_child_process(ProcessID parent_pid, const std::string& child_name, uint64_t size, uint64_t cpu_time, uint32_t priority) {
+    // 分页模式下以写时复制方式共享父进程的地址空间，不再单独分配内存
+    auto parent_pcb = get_process(parent_pid);
+    if (parent_pcb && memory_manager.get_allocation_strategy() == MemoryAllocationStrategy::PAGED) {
+        ProcessID child_pid = next_pid;
+        if (memory_manager.fork_address_space(parent_pid, child_pid)) {
+            ++next_pid;
+            register_process(child_pid, child_name, parent_pcb->memory_info, cpu_time, priority, parent_pid)->image_path = parent_pcb->image_path;
+            return child_pid;
+        }
+    }
     // 调用带名称的新建进程接口，提供 parent_pid
     return create_process(child_name, size, cpu_time, priority, parent_pid);
 }
@@ -1,8 +1,10 @@
 #include "memory/memory_manager.h"
+#include "process/process_manager.h"
 #include "test_common.h"
 #include <iostream>
 #include <cassert>
 #include <numeric>
+#include <vector>
 
 void test_mm_initialization() {
     std::cout << "  - Testing MM Initialization..." << std::endl;
@@ -80,9 +82,514 @@ void test_mm_free_and_merge() {
     std::cout << "    ...PASSED" << std::endl;
 }
 
+void test_mm_lazy_backing() {
+    std::cout << "  - Testing MM Lazy Backing..." << std::endl;
+    MemoryManager mm(MemoryBackingMode::LAZY);
+    ASSERT_EQUAL(mm.get_reserved_memory(), mm.get_total_memory());
+    ASSERT_EQUAL(mm.get_committed_memory(), 0);
+
+    // 读取从未写入的区域返回 0，且不提交
+    std::string untouched = mm.read_memory(1024 * 1024, 16);
+    ASSERT_TRUE(untouched == std::string(16, '\0'));
+    ASSERT_EQUAL(mm.get_committed_memory(), 0);
+
+    // 跨越提交粒度边界的写入提交两个粒度
+    const uint64_t granule = BackingStore::COMMIT_GRANULE;
+    mm.write_memory(granule - 4, std::string("lazy-pool"));
+    ASSERT_EQUAL(mm.get_committed_memory(), 2 * granule);
+    ASSERT_TRUE(mm.read_memory(granule - 4, 9) == "lazy-pool");
+    ASSERT_TRUE(mm.read_memory(granule + 5, 4) == std::string(4, '\0'));
+
+    // 释放覆盖整个粒度的内存块后归还提交
+    auto blk = mm.allocate(4 * granule);
+    ASSERT_TRUE(blk.has_value());
+    mm.write_memory(blk->base_address + 2 * granule, std::string("x"));
+    ASSERT_EQUAL(mm.get_committed_memory(), 3 * granule);
+    ASSERT_TRUE(mm.free(blk->base_address, blk->size));
+    ASSERT_EQUAL(mm.get_committed_memory(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_placement_policies() {
+    std::cout << "  - Testing MM Placement Policies..." << std::endl;
+    MemoryManager mm;
+    // 布局: A[0,100) B[100,400) C[400,500) D[500,700) E[700,800)
+    auto a = mm.allocate(100);
+    auto b = mm.allocate(300);
+    auto c = mm.allocate(100);
+    auto d = mm.allocate(200);
+    auto e = mm.allocate(100);
+    ASSERT_TRUE(a && b && c && d && e);
+    ASSERT_TRUE(mm.free(b->base_address, b->size));
+    ASSERT_TRUE(mm.free(d->base_address, d->size));
+    ASSERT_FALSE(mm.free(d->base_address, d->size)); // 重复释放被拒绝
+
+    mm.set_placement_policy(PlacementPolicy::BEST_FIT);
+    auto best = mm.allocate(150);
+    ASSERT_EQUAL(best->base_address, 500);
+    ASSERT_TRUE(mm.free(best->base_address, best->size));
+
+    mm.set_placement_policy(PlacementPolicy::WORST_FIT);
+    auto worst = mm.allocate(150);
+    ASSERT_EQUAL(worst->base_address, 800);
+    ASSERT_TRUE(mm.free(worst->base_address, worst->size));
+
+    mm.set_placement_policy(PlacementPolicy::FIRST_FIT);
+    auto first = mm.allocate(150);
+    ASSERT_EQUAL(first->base_address, 100);
+
+    // 循环首次适应从上次分配的末尾继续
+    mm.set_placement_policy(PlacementPolicy::NEXT_FIT);
+    auto next1 = mm.allocate(150);
+    auto next2 = mm.allocate(150);
+    ASSERT_EQUAL(next1->base_address, 250);
+    ASSERT_EQUAL(next2->base_address, 500);
+    ASSERT_EQUAL(mm.get_free_blocks().size(), 2);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_free_index_consistency() {
+    std::cout << "  - Testing MM Free Index Consistency..." << std::endl;
+    MemoryManager mm;
+    const uint64_t total_mem = mm.get_total_memory();
+    std::vector<MemoryBlock> live;
+    uint32_t seed = 12345;
+    auto next_rand = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 8) & 0xFFFF; };
+
+    const PlacementPolicy policies[] = {PlacementPolicy::FIRST_FIT, PlacementPolicy::BEST_FIT,
+                                        PlacementPolicy::WORST_FIT, PlacementPolicy::NEXT_FIT};
+    for (int round = 0; round < 2000; ++round) {
+        mm.set_placement_policy(policies[round % 4]);
+        if (live.empty() || next_rand() % 3 != 0) {
+            auto blk = mm.allocate(1 + next_rand() % 5000);
+            ASSERT_TRUE(blk.has_value());
+            live.push_back(*blk);
+        } else {
+            size_t idx = next_rand() % live.size();
+            ASSERT_TRUE(mm.free(live[idx].base_address, live[idx].size));
+            live[idx] = live.back();
+            live.pop_back();
+        }
+    }
+
+    // 空闲块必须按地址有序、互不重叠且不存在可合并的相邻块
+    uint64_t free_sum = 0;
+    uint64_t prev_end = 0;
+    bool first_block = true;
+    for (const auto& block : mm.get_free_blocks()) {
+        ASSERT_TRUE(first_block || block.base_address > prev_end);
+        prev_end = block.base_address + block.size;
+        free_sum += block.size;
+        first_block = false;
+    }
+    ASSERT_EQUAL(free_sum, total_mem - mm.get_used_memory());
+
+    for (const auto& blk : live) {
+        ASSERT_TRUE(mm.free(blk.base_address, blk.size));
+    }
+    ASSERT_EQUAL(mm.get_free_blocks().size(), 1);
+    ASSERT_EQUAL(mm.get_free_blocks().front().size, total_mem);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_buddy_allocation() {
+    std::cout << "  - Testing MM Buddy Allocation..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::BUDDY);
+    const auto& buddy = mm.get_buddy_allocator();
+    const uint32_t top = buddy.max_order();
+    ASSERT_EQUAL(buddy.free_block_count(top), 1);
+
+    // 5000 字节向上取整为 8KB（阶 1），拆分时每一阶留下一个伙伴
+    auto a = mm.allocate_for_process(1, 5000);
+    ASSERT_TRUE(a.has_value());
+    ASSERT_EQUAL(a->base_address, 0);
+    ASSERT_EQUAL(a->size, 2 * PAGE_SIZE);
+    ASSERT_EQUAL(buddy.free_block_count(top), 0);
+    ASSERT_EQUAL(buddy.free_block_count(1), 1);
+    ASSERT_EQUAL(mm.get_buddy_internal_fragmentation(), 2 * PAGE_SIZE - 5000);
+
+    // 同阶的伙伴块被直接使用
+    auto b = mm.allocate_for_process(2, 2 * PAGE_SIZE);
+    auto c = mm.allocate_for_process(1, PAGE_SIZE);
+    ASSERT_TRUE(b.has_value() && c.has_value());
+    ASSERT_EQUAL(b->base_address, 2 * PAGE_SIZE);
+    ASSERT_EQUAL(c->base_address, 4 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_process_base_address(2), 2 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_used_memory(), 5 * PAGE_SIZE);
+
+    // 按进程释放，无需传入地址和大小
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_FALSE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_memory(), 2 * PAGE_SIZE);
+    ASSERT_TRUE(mm.free(b->base_address, b->size));
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+
+    // 全部释放后逐阶合并回一个最大块
+    ASSERT_EQUAL(buddy.free_block_count(top), 1);
+    for (uint32_t order = 0; order < top; ++order) {
+        ASSERT_EQUAL(buddy.free_block_count(order), 0);
+    }
+    ASSERT_FALSE(mm.allocate_for_process(3, mm.get_total_memory() + 1).has_value());
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_partition_size_classes() {
+    std::cout << "  - Testing MM Partition Size Classes..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PARTITIONED);
+
+    // 数千个分区的自定义布局
+    ASSERT_TRUE(mm.set_partition_layout({{64 * 1024, 4000}, {1024 * 1024, 1000}}));
+    ASSERT_EQUAL(mm.get_partitions().size(), 5000);
+    ASSERT_FALSE(mm.set_partition_layout({{mm.get_total_memory(), 2}}));
+
+    // 选择能容纳请求的最小类别中下标最小的分区
+    auto small = mm.allocate_for_process(1, 1000);
+    auto large = mm.allocate_for_process(2, 100 * 1024);
+    ASSERT_TRUE(small.has_value() && large.has_value());
+    ASSERT_EQUAL(small->base_address, 0);
+    ASSERT_EQUAL(small->size, 64 * 1024);
+    ASSERT_EQUAL(large->base_address, 4000ULL * 64 * 1024);
+    ASSERT_EQUAL(mm.get_process_base_address(2), large->base_address);
+    ASSERT_FALSE(mm.allocate_for_process(3, 2 * 1024 * 1024).has_value());
+
+    // 占用期间不能修改布局
+    ASSERT_FALSE(mm.set_partition_layout({{64 * 1024, 10}}));
+
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_FALSE(mm.free_process_memory(1));
+    ASSERT_TRUE(mm.get_partitions()[0].is_free);
+    auto reused = mm.allocate_for_process(4, 10);
+    ASSERT_EQUAL(reused->base_address, 0);
+
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_TRUE(mm.free_process_memory(4));
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    ASSERT_TRUE(mm.set_partition_layout({}));
+    ASSERT_EQUAL(mm.get_partitions().size(), 152);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_strategy_migration() {
+    std::cout << "  - Testing MM Strategy Migration..." << std::endl;
+    const uint64_t MB = 1024 * 1024;
+    MemoryManager mm;
+    std::vector<MigrationEntry> entries;
+    for (ProcessID pid = 1; pid <= 3; ++pid) {
+        auto block = mm.allocate_for_process(pid, pid * MB);
+        ASSERT_TRUE(block.has_value());
+        entries.push_back({pid, pid * MB, {*block}, std::nullopt});
+    }
+    ASSERT_FALSE(mm.begin_strategy_migration(MemoryAllocationStrategy::CONTINUOUS, entries));
+    ASSERT_TRUE(mm.begin_strategy_migration(MemoryAllocationStrategy::BUDDY, entries));
+    ASSERT_FALSE(mm.begin_strategy_migration(MemoryAllocationStrategy::PAGED, entries));
+
+    // 预分配期间旧分配仍然有效，新建和释放的进程同步加入或移出计划
+    const MigrationStatus& status = mm.step_strategy_migration(2);
+    ASSERT_TRUE(status.state == MigrationState::PLANNING);
+    ASSERT_EQUAL(status.planned_processes, 2);
+    ASSERT_TRUE(mm.get_allocation_strategy() == MemoryAllocationStrategy::CONTINUOUS);
+    auto late = mm.allocate_for_process(4, MB);
+    ASSERT_TRUE(late.has_value());
+    ASSERT_EQUAL(status.total_processes, 4);
+    mm.free_process_memory(2);
+    ASSERT_TRUE(mm.free(entries[1].old_blocks[0].base_address, 2 * MB));
+    ASSERT_EQUAL(status.total_processes, 3);
+    ASSERT_EQUAL(status.planned_processes, 1);
+
+    mm.step_strategy_migration(10);
+    ASSERT_TRUE(status.state == MigrationState::COMMITTED);
+    ASSERT_TRUE(mm.get_allocation_strategy() == MemoryAllocationStrategy::BUDDY);
+    ASSERT_EQUAL(mm.get_migration_entries().size(), 3);
+    for (const auto& entry : mm.get_migration_entries()) {
+        ASSERT_TRUE(entry.new_block.has_value());
+    }
+    ASSERT_EQUAL(mm.get_used_memory(), 6 * MB); // 1MB + 4MB + 1MB 的伙伴块
+    ASSERT_EQUAL(mm.get_free_blocks().total_free(), mm.get_total_memory());
+
+    // 任一进程在新策略下分配失败时整体回滚
+    ASSERT_TRUE(mm.allocate_for_process(5, 512 * MB).has_value());
+    entries.clear();
+    for (const auto& entry : mm.get_migration_entries()) {
+        entries.push_back({entry.pid, entry.size, {*entry.new_block}, std::nullopt});
+    }
+    entries.push_back({5, 512 * MB, {}, std::nullopt});
+    uint64_t used = mm.get_used_memory();
+    ASSERT_TRUE(mm.begin_strategy_migration(MemoryAllocationStrategy::PARTITIONED, entries));
+    mm.step_strategy_migration(SIZE_MAX);
+    ASSERT_TRUE(status.state == MigrationState::ROLLED_BACK);
+    ASSERT_EQUAL(status.failed_pid, 5);
+    ASSERT_TRUE(mm.get_allocation_strategy() == MemoryAllocationStrategy::BUDDY);
+    ASSERT_EQUAL(mm.get_used_memory(), used);
+    for (const auto& partition : mm.get_partitions()) {
+        ASSERT_TRUE(partition.is_free);
+    }
+    ASSERT_FALSE(mm.abort_strategy_migration());
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_compaction() {
+    std::cout << "  - Testing MM Compaction..." << std::endl;
+    const uint64_t MB = 1024 * 1024;
+    MemoryManager mm;
+    std::vector<MemoryBlock> blocks;
+    for (int i = 0; i < 4; ++i) {
+        blocks.push_back(*mm.allocate(MB));
+    }
+    blocks.push_back(*mm.allocate(mm.get_total_memory() - 4 * MB));
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        mm.write_memory(blocks[i].base_address, std::string(1, static_cast<char>('A' + i)));
+    }
+    ASSERT_TRUE(mm.free(blocks[1].base_address, MB));
+    ASSERT_TRUE(mm.free(blocks[3].base_address, MB));
+
+    auto frag = mm.get_fragmentation_stats();
+    ASSERT_EQUAL(frag.free_bytes, 2 * MB);
+    ASSERT_EQUAL(frag.free_blocks, 2);
+    ASSERT_EQUAL(frag.largest_free_block, MB);
+    ASSERT_TRUE(frag.external_fragmentation == 0.5);
+    ASSERT_FALSE(mm.allocate(2 * MB).has_value()); // 没有注册重定位回调时不会自动紧凑
+
+    // 注册回调后，分配失败时先紧凑再重试
+    std::vector<std::pair<uint64_t, uint64_t>> moves;
+    mm.set_relocation_callback([&](uint64_t old_base, uint64_t new_base, uint64_t) {
+        moves.push_back({old_base, new_base});
+    });
+    auto big = mm.allocate(2 * MB);
+    ASSERT_TRUE(big.has_value());
+    ASSERT_EQUAL(big->base_address, mm.get_total_memory() - 2 * MB);
+    ASSERT_EQUAL(moves.size(), 2);
+    ASSERT_EQUAL(moves[0].first, 2 * MB);
+    ASSERT_EQUAL(moves[0].second, MB);
+    ASSERT_TRUE(mm.read_memory(MB, 1) == "C");
+    ASSERT_TRUE(mm.read_memory(2 * MB, 1) == "E");
+
+    // 每步至少移动一个块，达到字节上限后停止
+    ASSERT_TRUE(mm.free(0, MB));
+    moves.clear();
+    ASSERT_EQUAL(mm.compact(1), MB);
+    ASSERT_EQUAL(moves.size(), 1);
+    ASSERT_TRUE(mm.read_memory(0, 1) == "C");
+    ASSERT_FALSE(mm.is_compacted());
+    mm.compact(UINT64_MAX);
+    ASSERT_TRUE(mm.is_compacted());
+    ASSERT_EQUAL(moves.size(), 3);
+    ASSERT_TRUE(mm.read_memory(MB, 1) == "E");
+    frag = mm.get_fragmentation_stats();
+    ASSERT_TRUE(frag.external_fragmentation == 0.0);
+    ASSERT_EQUAL(frag.largest_free_block, MB);
+    ASSERT_EQUAL(frag.compacted_blocks, 5);
+    ASSERT_TRUE(mm.free(mm.get_total_memory() - 3 * MB, 2 * MB));
+    ASSERT_EQUAL(mm.get_free_memory(), 3 * MB);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_pm_compaction_updates_pcb() {
+    std::cout << "  - Testing PM Compaction Updates PCB..." << std::endl;
+    const uint64_t MB = 1024 * 1024;
+    MemoryManager mm;
+    ProcessManager pm(mm);
+    auto first = pm.create_process("first", MB, 10, 5);
+    auto second = pm.create_process("second", MB, 10, 5);
+    auto rest = pm.create_process("rest", mm.get_total_memory() - 3 * MB, 10, 5);
+    ASSERT_TRUE(first.has_value() && second.has_value() && rest.has_value());
+    ASSERT_TRUE(pm.terminate_process(*first));
+
+    // 剩余 2MB 分成两块，创建 2MB 的进程时先紧凑
+    auto large = pm.create_process("large", 2 * MB, 10, 5);
+    ASSERT_TRUE(large.has_value());
+    ASSERT_EQUAL(pm.get_process(*second)->memory_info[0].base_address, 0);
+    ASSERT_EQUAL(pm.get_process(*rest)->memory_info[0].base_address, MB);
+    ASSERT_EQUAL(pm.get_process(*large)->memory_info[0].base_address, mm.get_total_memory() - 2 * MB);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_memory_groups() {
+    std::cout << "  - Testing MM Memory Groups..." << std::endl;
+    const uint64_t MB = 1024 * 1024;
+    MemoryManager mm;
+    int tenant = mm.create_memory_group("tenant", 4 * MB, 2 * MB);
+    ASSERT_TRUE(mm.move_to_memory_group(1, tenant));
+    ASSERT_TRUE(mm.allocate_for_process(1, MB).has_value());
+    ASSERT_TRUE(mm.move_to_memory_group(2, tenant));
+    ASSERT_TRUE(mm.allocate_for_process(2, 2 * MB).has_value());
+    const MemoryGroup* group = mm.get_memory_group(tenant);
+    ASSERT_EQUAL(group->usage, 3 * MB);
+    ASSERT_EQUAL(group->members.size(), 2);
+    ASSERT_TRUE(group->over_soft_limit());
+    ASSERT_EQUAL(group->soft_limit_breaches, 1);
+
+    // 硬限制只约束本组，根组不受影响
+    ASSERT_FALSE(mm.allocate_for_process(1, 2 * MB).has_value());
+    ASSERT_EQUAL(group->failures, 1);
+    ASSERT_EQUAL(group->usage, 3 * MB);
+    ASSERT_TRUE(mm.allocate_for_process(3, 8 * MB).has_value());
+    ASSERT_EQUAL(mm.get_memory_group(ROOT_MEMORY_GROUP)->usage, 8 * MB);
+
+    // 移组时计费随之转移，目标组容纳不下时拒绝
+    ASSERT_FALSE(mm.move_to_memory_group(3, tenant));
+    ASSERT_TRUE(mm.move_to_memory_group(2, ROOT_MEMORY_GROUP));
+    ASSERT_EQUAL(group->usage, MB);
+    ASSERT_EQUAL(mm.get_memory_group(ROOT_MEMORY_GROUP)->usage, 10 * MB);
+    ASSERT_EQUAL(group->peak, 3 * MB);
+
+    ASSERT_FALSE(mm.remove_memory_group(tenant)); // 还有进程
+    mm.free_process_memory(1);
+    ASSERT_EQUAL(group->usage, 0);
+    ASSERT_TRUE(mm.remove_memory_group(tenant));
+    ASSERT_FALSE(mm.remove_memory_group(ROOT_MEMORY_GROUP));
+    ASSERT_FALSE(mm.set_memory_group_limits(ROOT_MEMORY_GROUP, MB, 0));
+    ASSERT_FALSE(mm.move_to_memory_group(2, tenant));
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_heap_allocator_policies() {
+    std::cout << "  - Testing Heap Allocator Policies..." << std::endl;
+    for (HeapPolicy policy : {HeapPolicy::TLSF, HeapPolicy::FIRST_FIT, HeapPolicy::BEST_FIT}) {
+        HeapAllocator heap(policy);
+        ASSERT_FALSE(heap.allocate(16).has_value()); // 容量为 0
+        heap.grow(64 * 1024);
+        auto a = heap.allocate(100);
+        auto b = heap.allocate(5000);
+        auto c = heap.allocate(100);
+        ASSERT_TRUE(a && b && c);
+        ASSERT_EQUAL(*a % HeapAllocator::ALIGNMENT, 0);
+        ASSERT_EQUAL(heap.block_size(*a), 112);
+        ASSERT_EQUAL(heap.stats().requested, 5200);
+        ASSERT_EQUAL(heap.stats().live_blocks, 3);
+        ASSERT_FALSE(heap.free(*a + 16));
+
+        // 释放后与相邻空闲块合并
+        ASSERT_TRUE(heap.free(*b));
+        ASSERT_FALSE(heap.free(*b));
+        ASSERT_TRUE(heap.free(*a));
+        ASSERT_EQUAL(heap.stats().free_blocks, 2);
+        ASSERT_FALSE(heap.shrink(0)); // c 仍在使用
+        ASSERT_TRUE(heap.free(*c));
+        ASSERT_EQUAL(heap.stats().free_blocks, 1);
+        ASSERT_EQUAL(heap.stats().largest_free, 64 * 1024);
+        ASSERT_EQUAL(heap.stats().allocated, 0);
+
+        // 扩大的空间与末尾空闲块合并；收缩只能截掉末尾的空闲部分
+        auto big = heap.allocate(60 * 1024);
+        ASSERT_TRUE(big.has_value());
+        heap.grow(128 * 1024);
+        ASSERT_EQUAL(heap.trailing_free(), 68 * 1024);
+        ASSERT_TRUE(heap.allocate(64 * 1024).has_value());
+        ASSERT_FALSE(heap.shrink(*big + 1024));
+        ASSERT_EQUAL(heap.stats().allocations, heap.stats().live_blocks + heap.stats().frees);
+    }
+
+    // 交错释放后留下的空洞：最佳适应放进最小的空洞，首次适应放进地址最低的空洞
+    for (HeapPolicy policy : {HeapPolicy::FIRST_FIT, HeapPolicy::BEST_FIT}) {
+        HeapAllocator heap(policy);
+        heap.grow(1024 * 1024);
+        std::vector<uint64_t> blocks;
+        for (uint64_t size : {4096, 64, 1024, 64, 256, 64}) {
+            blocks.push_back(*heap.allocate(size));
+        }
+        heap.free(blocks[0]);
+        heap.free(blocks[2]);
+        heap.free(blocks[4]);
+        uint64_t placed = *heap.allocate(200);
+        ASSERT_EQUAL(placed, policy == HeapPolicy::FIRST_FIT ? blocks[0] : blocks[4]);
+    }
+
+    // TLSF 按二级区间取整后直接取链表头，不会分到太小的块
+    HeapAllocator tlsf(HeapPolicy::TLSF);
+    tlsf.grow(4 * 1024 * 1024);
+    std::vector<uint64_t> live;
+    for (int i = 0; i < 256; ++i) {
+        uint64_t size = 16 + static_cast<uint64_t>(i * 37 % 3000);
+        auto offset = tlsf.allocate(size);
+        ASSERT_TRUE(offset.has_value());
+        ASSERT_TRUE(tlsf.block_size(*offset) >= size);
+        live.push_back(*offset);
+    }
+    for (size_t i = 0; i < live.size(); i += 2) {
+        ASSERT_TRUE(tlsf.free(live[i]));
+    }
+    for (int i = 0; i < 64; ++i) {
+        auto offset = tlsf.allocate(1000);
+        ASSERT_TRUE(offset.has_value());
+        ASSERT_EQUAL(tlsf.block_size(*offset), 1008);
+    }
+    for (size_t i = 1; i < live.size(); i += 2) {
+        ASSERT_TRUE(tlsf.free(live[i]));
+    }
+    ASSERT_EQUAL(tlsf.stats().live_blocks, 64);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_occupancy_map() {
+    std::cout << "  - Testing MM Occupancy Map..." << std::endl;
+    const uint64_t MB = 1024 * 1024;
+    MemoryManager mm;
+    auto empty = mm.get_occupancy_map(4);
+    ASSERT_EQUAL(empty.size(), 4);
+    ASSERT_EQUAL(empty[3].base_address, 3 * mm.get_total_memory() / 4);
+    ASSERT_EQUAL(empty[0].top_owner, -1);
+    ASSERT_EQUAL(mm.get_occupancy_map(1000000).size(), mm.get_total_memory() / OccupancyMap::REGION_SIZE);
+
+    // 连续分配：跨越区域的块按字节拆分，紧凑移动后随之更新
+    auto a = mm.allocate_for_process(1, MB + MB / 2);
+    auto b = mm.allocate_for_process(2, MB / 2);
+    ASSERT_EQUAL(b->base_address, a->size);
+    auto map = mm.get_occupancy_map(4096);
+    ASSERT_EQUAL(map[0].used, MB);
+    ASSERT_EQUAL(map[1].used, MB);
+    ASSERT_EQUAL(map[1].owners, 2);
+    ASSERT_EQUAL(map[1].top_owner_bytes, MB / 2);
+    mm.set_relocation_callback([](uint64_t, uint64_t, uint64_t) {});
+    ASSERT_TRUE(mm.free(a->base_address, a->size));
+    mm.compact(UINT64_MAX);
+    map = mm.get_occupancy_map(4096);
+    ASSERT_EQUAL(map[0].used, MB / 2);
+    ASSERT_EQUAL(map[0].top_owner, 2);
+    ASSERT_EQUAL(map[1].used, 0);
+
+    // 伙伴系统按块大小计入
+    mm.initialize();
+    mm.set_allocation_strategy(MemoryAllocationStrategy::BUDDY);
+    mm.allocate_for_process(3, 3 * MB);
+    map = mm.get_occupancy_map(1024);
+    ASSERT_EQUAL(map[0].used, 4 * MB);
+    ASSERT_EQUAL(map[0].top_owner, 3);
+    ASSERT_TRUE(mm.free_process_memory(3));
+    ASSERT_EQUAL(mm.get_occupancy_map(1)[0].used, 0);
+
+    // 分页：页框先无主，映射进进程时记到进程名下
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(4, 3 * PAGE_SIZE);
+    auto shmid = mm.shm_create(PAGE_SIZE);
+    map = mm.get_occupancy_map(4096);
+    ASSERT_EQUAL(map[0].used, 4 * PAGE_SIZE);
+    ASSERT_EQUAL(map[0].owners, 2);
+    ASSERT_EQUAL(map[0].top_owner, 4);
+    ASSERT_TRUE(mm.free_process_memory(4));
+    map = mm.get_occupancy_map(4096);
+    ASSERT_EQUAL(map[0].used, PAGE_SIZE);
+    ASSERT_EQUAL(map[0].top_owner, -1);
+    ASSERT_TRUE(mm.shm_remove(*shmid));
+    ASSERT_EQUAL(mm.get_occupancy_map(16)[0].used, 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
 void run_memory_manager_tests() {
     test_mm_initialization();
     test_mm_simple_allocation();
     test_mm_allocation_oom();
     test_mm_free_and_merge();
+    test_mm_lazy_backing();
+    test_mm_placement_policies();
+    test_mm_free_index_consistency();
+    test_mm_buddy_allocation();
+    test_mm_partition_size_classes();
+    test_mm_strategy_migration();
+    test_mm_compaction();
+    test_pm_compaction_updates_pcb();
+    test_mm_memory_groups();
+    test_heap_allocator_policies();
+    test_mm_occupancy_map();
 } 
\ No newline at end of file
@@ -1 +1,1408 @@
- 
\ No newline at end of file
+#include "memory/memory_manager.h"
+#include "memory/frame_bitmap.h"
+#include "memory/page_table.h"
+#include "memory/vma_tree.h"
+#include "memory/compressed_pool.h"
+#include "process/process_manager.h"
+#include "fs/fs_manager.h"
+#include "test_common.h"
+#include <iostream>
+
+void test_frame_bitmap_hierarchy() {
+    std::cout << "  - Testing Frame Bitmap Hierarchy..." << std::endl;
+    // 非 64 整数倍，覆盖尾部填充位
+    const uint64_t frames = 64 * 64 * 3 + 17;
+    FrameBitmap bitmap(frames);
+    ASSERT_EQUAL(bitmap.free_count(), frames);
+
+    for (uint64_t i = 0; i < frames; ++i) {
+        ASSERT_EQUAL(bitmap.allocate(), i);
+    }
+    ASSERT_EQUAL(bitmap.used_count(), frames);
+    ASSERT_EQUAL(bitmap.allocate(), UINT64_MAX);
+
+    // 释放一个位于满子树中的页框后，应能重新找到它
+    ASSERT_TRUE(bitmap.clear(64 * 64 + 5));
+    ASSERT_FALSE(bitmap.clear(64 * 64 + 5));
+    ASSERT_EQUAL(bitmap.free_count(), 1);
+    ASSERT_EQUAL(bitmap.find_first_free(), 64 * 64 + 5);
+    ASSERT_TRUE(bitmap.clear(frames - 1));
+    ASSERT_EQUAL(bitmap.allocate(), 64 * 64 + 5);
+    ASSERT_EQUAL(bitmap.allocate(), frames - 1);
+    ASSERT_EQUAL(bitmap.allocate(), UINT64_MAX);
+
+    bitmap.reset();
+    ASSERT_EQUAL(bitmap.used_count(), 0);
+    ASSERT_FALSE(bitmap.test(0));
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_paged_page_statistics() {
+    std::cout << "  - Testing MM Paged Page Statistics..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+
+    auto blk1 = mm.allocate_for_process(1, 3 * PAGE_SIZE + 1);
+    auto blk2 = mm.allocate_for_process(2, PAGE_SIZE);
+    ASSERT_TRUE(blk1.has_value() && blk2.has_value());
+    ASSERT_EQUAL(mm.get_used_pages(), 5);
+    ASSERT_EQUAL(mm.get_free_pages(), TOTAL_PAGES - 5);
+    ASSERT_EQUAL(mm.get_process_base_address(2), 4 * PAGE_SIZE);
+
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 1);
+
+    // 释放的低编号页框应被优先复用
+    auto blk3 = mm.allocate_for_process(3, PAGE_SIZE);
+    ASSERT_TRUE(blk3.has_value());
+    ASSERT_EQUAL(mm.get_process_base_address(3), 0);
+    ASSERT_EQUAL(mm.get_used_memory(), 2 * PAGE_SIZE);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+// 经典访问串 7 0 1 2 0 3 0 4 2 3 0 3 2 1 2 0 1 7 0 1，3 个页框
+static uint64_t count_faults(PageReplacementPolicy policy) {
+    const std::vector<uint64_t> refs = {7, 0, 1, 2, 0, 3, 0, 4, 2, 3, 0, 3, 2, 1, 2, 0, 1, 7, 0, 1};
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_demand_paging(true);
+    mm.set_physical_frame_limit(3);
+    mm.set_page_replacement_policy(policy);
+    mm.allocate_for_process(1, 8 * PAGE_SIZE);
+
+    std::vector<ResidentPage> trace;
+    for (uint64_t page : refs) {
+        trace.push_back({1, page});
+    }
+    mm.set_reference_trace(trace);
+    for (uint64_t page : refs) {
+        mm.translate_virtual_to_physical(1, page * PAGE_SIZE);
+    }
+    ASSERT_EQUAL(mm.get_used_pages(), 3);
+    ASSERT_EQUAL(mm.get_page_fault_stats(1).accesses, refs.size());
+    return mm.get_page_fault_stats(1).faults;
+}
+
+void test_mm_demand_paging_policies() {
+    std::cout << "  - Testing MM Demand Paging Policies..." << std::endl;
+    ASSERT_EQUAL(count_faults(PageReplacementPolicy::FIFO), 15);
+    ASSERT_EQUAL(count_faults(PageReplacementPolicy::LRU), 12);
+    ASSERT_EQUAL(count_faults(PageReplacementPolicy::OPT), 9);
+    ASSERT_EQUAL(count_faults(PageReplacementPolicy::CLOCK), 14);
+    ASSERT_EQUAL(count_faults(PageReplacementPolicy::LFU), 13);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_demand_paging_writeback() {
+    std::cout << "  - Testing MM Demand Paging Write-back..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_demand_paging(true);
+    mm.set_physical_frame_limit(2);
+
+    auto blk = mm.allocate_for_process(1, 4 * PAGE_SIZE);
+    ASSERT_TRUE(blk.has_value());
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_process_base_address(1), UINT64_MAX); // 首页尚未调入
+
+    auto pa = mm.translate_virtual_to_physical(1, 100, true);
+    ASSERT_TRUE(pa.has_value());
+    mm.write_memory(*pa, std::string("dirty page"));
+    mm.translate_virtual_to_physical(1, PAGE_SIZE);
+    mm.translate_virtual_to_physical(1, 2 * PAGE_SIZE); // 换出第 0 页并写回
+    ASSERT_EQUAL(mm.get_page_fault_stats(1).writebacks, 1);
+    ASSERT_EQUAL(mm.get_used_memory(), 2 * PAGE_SIZE);
+
+    // 重新调入后内容保持不变；干净页面换出不需要写回
+    pa = mm.translate_virtual_to_physical(1, 100);
+    ASSERT_TRUE(mm.read_memory(*pa, 10) == "dirty page");
+    auto stats = mm.get_page_fault_stats(1);
+    ASSERT_EQUAL(stats.faults, 4);
+    ASSERT_EQUAL(stats.evictions, 2);
+    ASSERT_EQUAL(stats.writebacks, 1);
+    ASSERT_FALSE(mm.translate_virtual_to_physical(1, 4 * PAGE_SIZE).has_value());
+
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_tlb() {
+    std::cout << "  - Testing MM TLB..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    ASSERT_FALSE(mm.configure_tlb(3, 2));
+    ASSERT_TRUE(mm.configure_tlb(4, 2));
+    mm.allocate_for_process(1, 4 * PAGE_SIZE);
+    mm.allocate_for_process(2, 4 * PAGE_SIZE);
+
+    // 热循环：首次访问未命中，之后全部命中
+    for (int round = 0; round < 10; ++round) {
+        for (uint64_t page = 0; page < 4; ++page) {
+            auto pa = mm.translate_virtual_to_physical(1, page * PAGE_SIZE + 8);
+            ASSERT_EQUAL(*pa, page * PAGE_SIZE + 8);
+        }
+    }
+    ASSERT_EQUAL(mm.get_tlb().stats().misses, 4);
+    ASSERT_EQUAL(mm.get_tlb().stats().hits, 36);
+
+    // 不同进程相同虚拟页不会互相命中；首次写入需要走页表置脏位
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, 0), 4 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_tlb().stats().misses, 5);
+    mm.translate_virtual_to_physical(1, 0, true);
+    mm.translate_virtual_to_physical(1, 0, true);
+    ASSERT_EQUAL(mm.get_tlb().stats().misses, 6);
+    ASSERT_EQUAL(mm.get_tlb().stats().hits, 37);
+
+    // 释放进程内存后其表项被清空
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_tlb().stats().flushes, 1);
+    ASSERT_FALSE(mm.translate_virtual_to_physical(1, 0).has_value());
+    mm.allocate_for_process(3, PAGE_SIZE);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(3, 0), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_tlb_demand_paging() {
+    std::cout << "  - Testing MM TLB With Demand Paging..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_demand_paging(true);
+    mm.set_physical_frame_limit(1);
+    mm.allocate_for_process(1, 2 * PAGE_SIZE);
+
+    // 换出的页面不能再通过 TLB 命中
+    auto first = mm.translate_virtual_to_physical(1, 0);
+    mm.translate_virtual_to_physical(1, 0);
+    mm.translate_virtual_to_physical(1, PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_tlb().stats().hits, 1);
+    ASSERT_TRUE(mm.get_tlb().stats().invalidations >= 1);
+    auto again = mm.translate_virtual_to_physical(1, 0);
+    ASSERT_EQUAL(*again, *first);
+    ASSERT_EQUAL(mm.get_page_fault_stats(1).faults, 3);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_page_table_layouts() {
+    std::cout << "  - Testing Page Table Layouts..." << std::endl;
+    const uint64_t far_page = (1ULL << 20) - 1;
+    for (auto layout : {PageTableLayout::FLAT, PageTableLayout::RADIX_2, PageTableLayout::RADIX_4}) {
+        PageTable table(layout);
+        ASSERT_TRUE(table.find(5) == nullptr);
+        table.map(5, 42).dirty = true;
+        table.map(far_page, 7);
+        ASSERT_EQUAL(table.resident_count(), 2);
+        ASSERT_EQUAL(table.find(5)->frame_number, 42);
+        ASSERT_TRUE(table.find(5)->dirty);
+        ASSERT_EQUAL(table.find(far_page)->frame_number, 7);
+        ASSERT_TRUE(table.find(6) == nullptr);
+
+        std::vector<uint64_t> visited;
+        table.for_each([&](uint64_t page, PageTableEntry&) { visited.push_back(page); });
+        ASSERT_EQUAL(visited.size(), 2);
+        ASSERT_EQUAL(visited[0], 5);
+        ASSERT_EQUAL(visited[1], far_page);
+
+        table.unmap(far_page);
+        ASSERT_TRUE(table.find(far_page) == nullptr);
+        ASSERT_EQUAL(table.resident_count(), 1);
+    }
+
+    // 稀疏映射时多级页表只分配路径上的结点，撤销后结点被回收
+    PageTable flat(PageTableLayout::FLAT);
+    PageTable radix(PageTableLayout::RADIX_4);
+    uint64_t empty_radix = radix.memory_bytes();
+    flat.map(far_page, 1);
+    radix.map(far_page, 1);
+    ASSERT_TRUE(radix.memory_bytes() * 100 < flat.memory_bytes());
+    radix.unmap(far_page);
+    ASSERT_EQUAL(radix.memory_bytes(), empty_radix);
+
+    // 四级页表的一次遍历访问 4 个结点
+    uint64_t steps = radix.walk_steps();
+    radix.map(3, 1);
+    radix.find(3);
+    ASSERT_EQUAL(radix.walk_steps() - steps, 4);
+    ASSERT_EQUAL(PageTable(PageTableLayout::RADIX_2).max_pages(), 1ULL << 20);
+    ASSERT_EQUAL(PageTable(PageTableLayout::FLAT).max_pages(), 1ULL << 20);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_radix_page_tables() {
+    std::cout << "  - Testing MM Radix Page Tables..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_page_table_layout(PageTableLayout::RADIX_4);
+    mm.set_demand_paging(true);
+    mm.configure_tlb(0, 0);
+
+    // 大而稀疏的虚拟地址空间：只触及首尾两页
+    const uint64_t pages = 1ULL << 24;
+    ASSERT_TRUE(mm.allocate_for_process(1, pages * PAGE_SIZE).has_value());
+    mm.translate_virtual_to_physical(1, 0);
+    mm.translate_virtual_to_physical(1, (pages - 1) * PAGE_SIZE);
+    const PageTable* table = mm.get_page_table(1);
+    ASSERT_EQUAL(table->resident_count(), 2);
+    ASSERT_TRUE(mm.get_page_table_memory() < 64 * 1024);
+    uint64_t walks = mm.get_page_walks();
+    mm.translate_virtual_to_physical(1, 0);
+    ASSERT_EQUAL(mm.get_page_walks(), walks + 1);
+
+    // 超出两级页表可映射范围的分配被拒绝
+    mm.set_page_table_layout(PageTableLayout::RADIX_2);
+    ASSERT_FALSE(mm.allocate_for_process(2, ((1ULL << 20) + 1) * PAGE_SIZE).has_value());
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_copy_on_write_fork() {
+    std::cout << "  - Testing MM Copy-on-Write Fork..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(1, 4 * PAGE_SIZE);
+    mm.write_memory(1, PAGE_SIZE - 3, "parent", 6); // 跨页写入
+
+    ASSERT_TRUE(mm.fork_address_space(1, 2));
+    ASSERT_FALSE(mm.fork_address_space(1, 2));
+    ASSERT_EQUAL(mm.get_used_pages(), 4);
+    auto stats = mm.get_frame_sharing_stats();
+    ASSERT_EQUAL(stats.shared_frames, 4);
+    ASSERT_EQUAL(stats.private_frames, 0);
+    ASSERT_EQUAL(stats.shared_mappings, 8);
+
+    // 读访问不复制
+    auto parent_pa = mm.translate_virtual_to_physical(1, PAGE_SIZE);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, PAGE_SIZE), *parent_pa);
+    ASSERT_EQUAL(mm.get_frame_refcount(*parent_pa / PAGE_SIZE), 2);
+
+    // 子进程首次写入得到私有副本，父进程内容不变
+    mm.write_memory(2, PAGE_SIZE, "C", 1);
+    auto child_pa = mm.translate_virtual_to_physical(2, PAGE_SIZE);
+    ASSERT_TRUE(*child_pa != *parent_pa);
+    ASSERT_TRUE(mm.read_memory(*mm.translate_virtual_to_physical(2, PAGE_SIZE - 3), 3) == "par");
+    ASSERT_TRUE(mm.read_memory(*child_pa, 3) == "Cnt");
+    ASSERT_TRUE(mm.read_memory(*parent_pa, 3) == "ent");
+    stats = mm.get_frame_sharing_stats();
+    ASSERT_EQUAL(stats.shared_frames, 3);
+    ASSERT_EQUAL(stats.private_frames, 2);
+    ASSERT_EQUAL(stats.cow_copies, 1);
+    ASSERT_EQUAL(mm.get_used_memory(), 5 * PAGE_SIZE);
+
+    // 父进程写入只剩自己映射的页面时不再复制
+    mm.write_memory(1, PAGE_SIZE, "P", 1);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(1, PAGE_SIZE), *parent_pa);
+    ASSERT_EQUAL(mm.get_frame_sharing_stats().cow_copies, 1);
+
+    // 父进程退出后共享页框仍由子进程持有
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 4);
+    ASSERT_EQUAL(mm.get_frame_sharing_stats().shared_frames, 0);
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_copy_on_write_fork_eviction() {
+    std::cout << "  - Testing MM Copy-on-Write Fork Eviction..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_demand_paging(true);
+    mm.set_physical_frame_limit(4);
+    mm.allocate_for_process(1, 4 * PAGE_SIZE);
+    mm.allocate_for_process(3, 4 * PAGE_SIZE);
+    ASSERT_TRUE(mm.write_virtual(1, 0, "hello", 5));
+
+    // 父进程退出后子进程成为唯一映射者，页框被换出时内容不能丢失
+    ASSERT_TRUE(mm.fork_address_space(1, 2));
+    ASSERT_TRUE(mm.free_process_memory(1));
+    for (uint64_t page = 0; page < 4; ++page) {
+        ASSERT_TRUE(mm.translate_virtual_to_physical(3, page * PAGE_SIZE).has_value());
+    }
+    ASSERT_TRUE(mm.get_page_fault_stats(2).evictions >= 1);
+    char buffer[5] = {};
+    ASSERT_TRUE(mm.read_virtual(2, 0, buffer, 5));
+    ASSERT_TRUE(std::string(buffer, 5) == "hello");
+
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_TRUE(mm.free_process_memory(3));
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_pm_fork_shares_frames() {
+    std::cout << "  - Testing PM Fork Shares Frames..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    ProcessManager pm(mm);
+    auto parent = pm.create_process("shell", 16 * PAGE_SIZE, 10, 1);
+    ASSERT_TRUE(parent.has_value());
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(pm.create_child_process(*parent, "cmd.exe", 16 * PAGE_SIZE, 5, 1).has_value());
+    }
+    ASSERT_EQUAL(mm.get_used_pages(), 16);
+    ASSERT_EQUAL(mm.get_frame_sharing_stats().shared_mappings, 16 * 9);
+
+    // 按需淘汰共享页框时撤销所有映射者，内容保存在交换区
+    MemoryManager demand;
+    demand.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    demand.set_demand_paging(true);
+    demand.set_physical_frame_limit(1);
+    demand.allocate_for_process(1, 2 * PAGE_SIZE);
+    demand.write_memory(1, 0, "shared", 6);
+    ASSERT_TRUE(demand.fork_address_space(1, 2));
+    demand.translate_virtual_to_physical(2, PAGE_SIZE); // 换出共享的第 0 页
+    ASSERT_EQUAL(demand.get_frame_sharing_stats().shared_frames, 0);
+    auto pa = demand.translate_virtual_to_physical(2, 0);
+    ASSERT_TRUE(demand.read_memory(*pa, 6) == "shared");
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_pm_exec_shares_image() {
+    std::cout << "  - Testing PM Exec Shares Image..." << std::endl;
+    FileSystemManager fs;
+    fs.create_directory("/bin", 755);
+    ASSERT_TRUE(fs.create_file("/bin/notepad.pubt", 64 * PAGE_SIZE, 755) == FsCreateResult::Success);
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    ProcessManager pm(mm);
+    ASSERT_FALSE(pm.exec_process(fs, "/bin/missing.pubt", "", 10, 5).has_value());
+
+    // 装入时不分配页框，多个实例共享映像页
+    std::vector<ProcessID> pids;
+    for (int i = 0; i < 10; ++i) {
+        auto pid = pm.exec_process(fs, "/bin/notepad.pubt", "", 10, 5);
+        ASSERT_TRUE(pid.has_value());
+        pids.push_back(*pid);
+    }
+    auto pcb = pm.get_process(pids[0]);
+    ASSERT_TRUE(pcb->name == "notepad.pubt");
+    ASSERT_TRUE(pcb->image_path == "/bin/notepad.pubt");
+    ASSERT_EQUAL(pcb->memory_info[0].size, 64 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    char byte;
+    for (ProcessID pid : pids) {
+        ASSERT_TRUE(mm.read_virtual(pid, 0, &byte, 1));
+        ASSERT_TRUE(mm.read_virtual(pid, 63 * PAGE_SIZE, &byte, 1));
+    }
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    ASSERT_FALSE(mm.write_virtual(pids[0], 0, "x", 1)); // 映像只读
+
+    // 子进程继承映像
+    auto child = pm.create_child_process(pids[0], "child", 0, 10, 5);
+    ASSERT_TRUE(pm.get_process(*child)->image_path == "/bin/notepad.pubt");
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    ASSERT_TRUE(pm.terminate_process(*child));
+    for (ProcessID pid : pids) {
+        ASSERT_TRUE(pm.terminate_process(pid));
+    }
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+
+    // 非分页模式按文件大小分配
+    MemoryManager contiguous;
+    ProcessManager eager(contiguous);
+    auto pid = eager.exec_process(fs, "/bin/notepad.pubt", "notepad", 10, 5);
+    ASSERT_TRUE(pid.has_value());
+    ASSERT_EQUAL(contiguous.get_used_memory(), 64 * PAGE_SIZE);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_pm_oom_killer() {
+    std::cout << "  - Testing PM OOM Killer..." << std::endl;
+    const uint64_t GB = 1024ULL * 1024 * 1024;
+    MemoryManager mm;
+    ProcessManager pm(mm);
+    auto a = pm.create_process("a", GB, 10, 1);
+    auto b = pm.create_process("b", GB, 10, 8);
+    auto c = pm.create_process("c", GB + GB / 2, 10, 0);
+    ASSERT_FALSE(pm.create_process("d", GB, 10, 5).has_value()); // 默认关闭
+    ASSERT_EQUAL(pm.get_all_processes().size(), 3);
+
+    // 占用相同时优先级低（数值大）的进程 badness 更高
+    pm.set_oom_killer(true);
+    ASSERT_TRUE(pm.oom_badness(*b) > pm.oom_badness(*a));
+    ASSERT_TRUE(pm.oom_badness(*c) > pm.oom_badness(*b));
+    auto d = pm.create_process("d", GB, 10, 5);
+    ASSERT_TRUE(d.has_value());
+    const auto& kills = pm.get_oom_kills();
+    ASSERT_EQUAL(kills.size(), 1);
+    ASSERT_EQUAL(kills[0].pid, *c);
+    ASSERT_EQUAL(kills[0].reclaimable, GB + GB / 2);
+    ASSERT_EQUAL(kills[0].requested_size, GB);
+    ASSERT_TRUE(pm.get_process(*c) == nullptr);
+
+    // 终止全部进程也不够时不终止任何进程
+    ASSERT_FALSE(pm.create_process("e", 5 * GB, 10, 5).has_value());
+    ASSERT_EQUAL(pm.get_all_processes().size(), 3);
+
+    // 分区分配：没有分区容纳得下的请求不终止任何进程，只终止占用足够大分区的进程
+    const uint64_t MB = 1024 * 1024;
+    MemoryManager partitioned;
+    partitioned.set_allocation_strategy(MemoryAllocationStrategy::PARTITIONED);
+    ASSERT_TRUE(partitioned.set_partition_layout({{MB, 4}, {64 * MB, 1}}));
+    ProcessManager ppart(partitioned);
+    ppart.set_oom_killer(true);
+    auto large = ppart.create_process("large", 64 * MB, 10, 0);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ppart.create_process("small", MB, 10, 9).has_value());
+    }
+    ASSERT_FALSE(ppart.create_process("huge", 200 * MB, 10, 5).has_value());
+    ASSERT_EQUAL(ppart.get_all_processes().size(), 5);
+    ASSERT_EQUAL(ppart.get_oom_kills().size(), 0);
+    ASSERT_TRUE(ppart.create_process("big", 32 * MB, 10, 5).has_value());
+    ASSERT_EQUAL(ppart.get_oom_kills().size(), 1);
+    ASSERT_EQUAL(ppart.get_oom_kills()[0].pid, *large);
+
+    // 伙伴系统：各进程的块互不为伙伴，单独终止任何一个都合并不出足够大的块
+    MemoryManager buddy;
+    buddy.set_allocation_strategy(MemoryAllocationStrategy::BUDDY);
+    ProcessManager pbuddy(buddy);
+    pbuddy.set_oom_killer(true);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(pbuddy.create_process("quarter", GB, 10, 5).has_value());
+    }
+    ASSERT_FALSE(pbuddy.create_process("half", 2 * GB, 10, 5).has_value());
+    ASSERT_EQUAL(pbuddy.get_all_processes().size(), 4);
+    ASSERT_EQUAL(pbuddy.get_oom_kills().size(), 0);
+    ASSERT_TRUE(pbuddy.create_process("one", GB, 10, 5).has_value());
+    ASSERT_EQUAL(pbuddy.get_oom_kills().size(), 1);
+
+    // 分页模式下仍被共享的页框不计入可回收内存
+    MemoryManager paged;
+    paged.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    ProcessManager ppm(paged);
+    ppm.set_oom_killer(true);
+    auto parent = ppm.create_process("parent", 16 * PAGE_SIZE, 10, 5);
+    ASSERT_EQUAL(paged.get_reclaimable_memory(*parent), 16 * PAGE_SIZE);
+    auto child = ppm.create_child_process(*parent, "child", 0, 10, 5);
+    ASSERT_EQUAL(paged.get_reclaimable_memory(*parent), 0);
+    ASSERT_EQUAL(ppm.oom_badness(*child), 0);
+    ASSERT_TRUE(paged.write_virtual(*child, 0, "x", 1));
+    ASSERT_EQUAL(paged.get_reclaimable_memory(*child), PAGE_SIZE);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_pm_memory_group_fork_storm() {
+    std::cout << "  - Testing PM Memory Group Fork Storm..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    ProcessManager pm(mm);
+    pm.set_oom_killer(true);
+    int tenant = mm.create_memory_group("tenant", 64 * PAGE_SIZE, 0);
+    auto other = pm.create_process("other", 16 * PAGE_SIZE, 10, 5);
+    auto shell = pm.create_process("shell", 16 * PAGE_SIZE, 10, 5, -1, tenant);
+    ASSERT_EQUAL(mm.get_memory_group_of(*shell), tenant);
+    ASSERT_FALSE(pm.create_process("bad", PAGE_SIZE, 10, 5, -1, 99).has_value());
+
+    // fork 按父进程的计费记入，组满后拒绝且不终止其他进程
+    size_t forks = 0;
+    while (pm.create_child_process(*shell, "child", 16 * PAGE_SIZE, 10, 5)) {
+        ++forks;
+    }
+    ASSERT_EQUAL(forks, 3);
+    const MemoryGroup* group = mm.get_memory_group(tenant);
+    ASSERT_EQUAL(group->usage, 64 * PAGE_SIZE);
+    ASSERT_TRUE(pm.get_oom_kills().empty());
+    ASSERT_TRUE(pm.get_process(*other) != nullptr);
+    ASSERT_TRUE(pm.create_process("free", 16 * PAGE_SIZE, 10, 5).has_value());
+
+    // mmap 与 brk 增量计费，munmap 与 brk 收缩退还
+    ASSERT_FALSE(mm.mmap(*shell, PAGE_SIZE, VMA_PROT_READ).has_value());
+    ASSERT_TRUE(pm.terminate_process(*shell + 1));
+    ASSERT_EQUAL(group->usage, 48 * PAGE_SIZE);
+    auto address = mm.mmap(*shell, 8 * PAGE_SIZE, VMA_PROT_READ | VMA_PROT_WRITE);
+    ASSERT_EQUAL(group->usage, 56 * PAGE_SIZE);
+    ASSERT_TRUE(mm.munmap(*shell, *address, 4 * PAGE_SIZE));
+    ASSERT_EQUAL(group->usage, 52 * PAGE_SIZE);
+    uint64_t base = *mm.brk(*shell, 0);
+    ASSERT_FALSE(mm.brk(*shell, base + 13 * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(*mm.brk(*shell, base + 12 * PAGE_SIZE), base + 12 * PAGE_SIZE);
+    ASSERT_EQUAL(group->usage, 64 * PAGE_SIZE);
+    ASSERT_EQUAL(*mm.brk(*shell, base), base);
+    ASSERT_EQUAL(group->usage, 52 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_memory_charge(*shell), 20 * PAGE_SIZE);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_shared_memory() {
+    std::cout << "  - Testing MM Shared Memory..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(1, 2 * PAGE_SIZE);
+    mm.allocate_for_process(2, PAGE_SIZE);
+
+    auto shmid = mm.shm_create(PAGE_SIZE + 1);
+    ASSERT_TRUE(shmid.has_value());
+    ASSERT_EQUAL(mm.get_shared_segments().at(*shmid).size, 2 * PAGE_SIZE);
+    ASSERT_FALSE(mm.shm_attach(*shmid + 1, 1).has_value());
+
+    auto va1 = mm.shm_attach(*shmid, 1);
+    auto va2 = mm.shm_attach(*shmid, 2);
+    ASSERT_EQUAL(*va1, 2 * PAGE_SIZE);
+    ASSERT_EQUAL(*va2, PAGE_SIZE);
+
+    // 一方写入，另一方通过自己的虚拟地址直接看到
+    mm.write_memory(1, *va1 + PAGE_SIZE - 2, "ipc!", 4);
+    auto pa = mm.translate_virtual_to_physical(2, *va2 + PAGE_SIZE - 2);
+    ASSERT_TRUE(mm.read_memory(*pa, 2) == "ip");
+    ASSERT_EQUAL(mm.get_frame_sharing_stats().shm_frames, 2);
+    ASSERT_EQUAL(mm.get_used_pages(), 5);
+
+    // 进程退出不释放段；标记删除后最后一个进程分离才释放
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 3);
+    ASSERT_EQUAL(mm.get_shared_segments().at(*shmid).attachments.size(), 1);
+    ASSERT_TRUE(mm.shm_remove(*shmid));
+    ASSERT_FALSE(mm.shm_attach(*shmid, 3).has_value());
+    ASSERT_EQUAL(mm.get_used_pages(), 3);
+    ASSERT_TRUE(mm.shm_detach(*shmid, 2));
+    ASSERT_FALSE(mm.shm_detach(*shmid, 2));
+    ASSERT_TRUE(mm.get_shared_segments().empty());
+    ASSERT_EQUAL(mm.get_used_pages(), 1);
+    ASSERT_EQUAL(mm.get_used_memory(), PAGE_SIZE);
+    ASSERT_FALSE(mm.translate_virtual_to_physical(2, *va2).has_value());
+
+    // 分离中间的段留下不可访问的空洞
+    auto a = mm.shm_create(PAGE_SIZE);
+    auto b = mm.shm_create(PAGE_SIZE);
+    auto va_a = mm.shm_attach(*a, 2);
+    auto va_b = mm.shm_attach(*b, 2);
+    ASSERT_TRUE(mm.shm_detach(*a, 2));
+    ASSERT_FALSE(mm.translate_virtual_to_physical(2, *va_a).has_value());
+    ASSERT_TRUE(mm.translate_virtual_to_physical(2, *va_b).has_value());
+
+    // fork 的子进程继续共享段，不做写时复制
+    ASSERT_TRUE(mm.fork_address_space(2, 3));
+    mm.write_memory(3, *va_b, "k", 1);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(3, *va_b), *mm.translate_virtual_to_physical(2, *va_b));
+    ASSERT_EQUAL(mm.get_shared_segments().at(*b).attachments.size(), 2);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_virtual_io() {
+    std::cout << "  - Testing MM Virtual I/O..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    // 两个进程交替分配，进程 1 的页框不连续
+    mm.allocate_for_process(1, 2 * PAGE_SIZE);
+    mm.allocate_for_process(2, PAGE_SIZE);
+    mm.allocate_for_process(1, 6 * PAGE_SIZE);
+
+    std::string image(7 * PAGE_SIZE + 123, '\0');
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<char>('a' + i % 26);
+    }
+    ASSERT_TRUE(mm.write_virtual(1, 100, image.data(), image.size()));
+    ASSERT_EQUAL(mm.get_page_fault_stats(1).accesses, 8); // 每页转换一次
+    ASSERT_EQUAL(mm.get_virtual_copy_runs(), 2);          // 页框 0-1 与 3-8 各一次
+
+    std::string back(image.size(), '\0');
+    ASSERT_TRUE(mm.read_virtual(1, 100, &back[0], back.size()));
+    ASSERT_TRUE(back == image);
+    ASSERT_TRUE(mm.read_memory(2 * PAGE_SIZE, 4) == std::string(4, '\0')); // 进程 2 的页框未被写到
+    ASSERT_FALSE(mm.read_virtual(1, 7 * PAGE_SIZE, &back[0], 2 * PAGE_SIZE));
+
+    // 分散/聚集
+    char head[4] = {};
+    char tail[4] = {};
+    std::vector<VirtualIoVec> iov = {{PAGE_SIZE - 2, head, 4}, {100 + image.size() - 4, tail, 4}};
+    ASSERT_EQUAL(mm.readv_virtual(1, iov), 8);
+    ASSERT_TRUE(std::string(head, 4) == image.substr(PAGE_SIZE - 102, 4));
+    ASSERT_TRUE(std::string(tail, 4) == image.substr(image.size() - 4));
+    char patch[] = "XYZ";
+    std::vector<VirtualIoVec> bad = {{0, patch, 3}, {8 * PAGE_SIZE, patch, 3}};
+    ASSERT_EQUAL(mm.writev_virtual(1, bad), 3);
+    ASSERT_TRUE(mm.read_virtual(1, 0, head, 3));
+    ASSERT_TRUE(std::string(head, 3) == "XYZ");
+
+    // 请求调页且只有一个页框时，跨页复制仍然正确
+    MemoryManager demand;
+    demand.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    demand.set_demand_paging(true);
+    demand.set_physical_frame_limit(1);
+    demand.allocate_for_process(1, 3 * PAGE_SIZE);
+    std::string data(3 * PAGE_SIZE, 'q');
+    data[PAGE_SIZE] = 'w';
+    ASSERT_TRUE(demand.write_virtual(1, 0, data.data(), data.size()));
+    std::string out(data.size(), '\0');
+    ASSERT_TRUE(demand.read_virtual(1, 0, &out[0], out.size()));
+    ASSERT_TRUE(out == data);
+
+    // 请求调页、页框充足时，整个进程映像仍合并为一次复制；页框不足时已转换的页框不会被换出
+    MemoryManager loader;
+    loader.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    loader.set_demand_paging(true);
+    loader.set_physical_frame_limit(16);
+    loader.allocate_for_process(1, 8 * PAGE_SIZE);
+    ASSERT_TRUE(loader.write_virtual(1, 0, image.data(), image.size()));
+    ASSERT_EQUAL(loader.get_virtual_copy_runs(), 1);
+    std::fill(back.begin(), back.end(), '\0');
+    ASSERT_TRUE(loader.read_virtual(1, 0, &back[0], back.size()));
+    ASSERT_TRUE(back == image);
+    ASSERT_EQUAL(loader.get_virtual_copy_runs(), 2);
+    loader.set_physical_frame_limit(4);
+    loader.allocate_for_process(2, 8 * PAGE_SIZE);
+    ASSERT_TRUE(loader.write_virtual(2, 0, image.data(), image.size()));
+    std::fill(back.begin(), back.end(), '\0');
+    ASSERT_TRUE(loader.read_virtual(2, 0, &back[0], back.size()));
+    ASSERT_TRUE(back == image);
+    ASSERT_TRUE(loader.read_virtual(1, 0, &back[0], back.size()));
+    ASSERT_TRUE(back == image);
+
+    // 非分页模式下只能访问进程自己的内存块，越界（包括地址回绕）时失败
+    MemoryManager continuous;
+    auto own = continuous.allocate_for_process(1, 2 * PAGE_SIZE);
+    auto other = continuous.allocate_for_process(2, PAGE_SIZE);
+    ASSERT_TRUE(continuous.write_virtual(1, own->base_address + 10, "abc", 3));
+    ASSERT_TRUE(continuous.read_virtual(1, own->base_address + 10, head, 3));
+    ASSERT_TRUE(std::string(head, 3) == "abc");
+    ASSERT_FALSE(continuous.read_virtual(1, other->base_address, head, 3));
+    ASSERT_FALSE(continuous.write_virtual(1, own->base_address + 2 * PAGE_SIZE - 1, "ab", 2));
+    ASSERT_FALSE(continuous.write_virtual(1, UINT64_MAX, "ab", 2));
+    ASSERT_FALSE(continuous.read_virtual(3, own->base_address, head, 1));
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_swap_area() {
+    std::cout << "  - Testing MM Swap Area on Disk..." << std::endl;
+    FileSystemManager fs;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_physical_frame_limit(2);
+    ASSERT_TRUE(mm.attach_swap(fs, 4 * PAGE_SIZE));
+    ASSERT_FALSE(mm.attach_swap(fs, 4 * PAGE_SIZE));
+    auto stats = mm.get_swap_stats();
+    ASSERT_TRUE(stats.on_disk);
+    ASSERT_EQUAL(stats.total_slots, 4);
+
+    // 挂接交换区后即使不开启请求调页，页框不足时也能换出页面完成分配
+    ASSERT_TRUE(mm.allocate_for_process(1, 3 * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    ASSERT_EQUAL(mm.get_swap_stats().swap_outs, 0); // 干净页面直接丢弃
+    ASSERT_TRUE(mm.allocate_for_process(3, 8 * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    ASSERT_TRUE(mm.free_process_memory(3));
+
+    // 脏页先进入写回队列，缺页时可以直接从队列取回
+    mm.set_writeback_queue_limit(8);
+    for (uint64_t page = 0; page < 3; ++page) {
+        std::string data(PAGE_SIZE, static_cast<char>('a' + page));
+        ASSERT_TRUE(mm.write_virtual(1, page * PAGE_SIZE, data.data(), data.size()));
+    }
+    stats = mm.get_swap_stats();
+    ASSERT_EQUAL(stats.swap_outs, 1);
+    ASSERT_EQUAL(stats.pending_writeback, 1);
+    ASSERT_EQUAL(stats.used_slots, 0);
+    char byte = 0;
+    ASSERT_TRUE(mm.read_virtual(1, 0, &byte, 1));
+    ASSERT_EQUAL(byte, 'a');
+    ASSERT_EQUAL(mm.get_swap_stats().queue_hits, 1);
+
+    // 写回后内容落在文件系统的磁盘块上
+    ASSERT_EQUAL(mm.pump_swap_writeback(16), 2);
+    stats = mm.get_swap_stats();
+    ASSERT_EQUAL(stats.pending_writeback, 0);
+    ASSERT_EQUAL(stats.used_slots, 2);
+    ASSERT_EQUAL(stats.writebacks_completed, 2);
+    for (uint64_t page = 0; page < 3; ++page) {
+        ASSERT_TRUE(mm.read_virtual(1, page * PAGE_SIZE + 7, &byte, 1));
+        ASSERT_EQUAL(byte, static_cast<char>('a' + page));
+    }
+    ASSERT_TRUE(mm.get_swap_stats().swap_ins >= 3);
+
+    // 队列上限为 0 时换出同步写回；交换区满后无法再换出脏页
+    mm.set_writeback_queue_limit(0);
+    ASSERT_TRUE(mm.allocate_for_process(2, 3 * PAGE_SIZE).has_value());
+    for (uint64_t page = 0; page < 3; ++page) {
+        std::string data(PAGE_SIZE, 'z');
+        mm.write_virtual(2, page * PAGE_SIZE, data.data(), data.size());
+    }
+    stats = mm.get_swap_stats();
+    ASSERT_EQUAL(stats.pending_writeback, 0);
+    ASSERT_EQUAL(stats.used_slots, 4);
+    std::string full(PAGE_SIZE, 'y');
+    bool all_written = true;
+    for (uint64_t page = 0; page < 3; ++page) {
+        all_written = mm.write_virtual(2, page * PAGE_SIZE, full.data(), full.size()) && all_written;
+    }
+    ASSERT_FALSE(all_written);
+    ASSERT_EQUAL(mm.get_swap_stats().used_slots, 4);
+
+    // 进程退出归还交换槽，之后才能卸下交换区
+    ASSERT_FALSE(mm.detach_swap());
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_EQUAL(mm.get_swap_stats().used_slots, 0);
+    ASSERT_TRUE(mm.detach_swap());
+    ASSERT_FALSE(mm.get_swap_stats().on_disk);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+// 伪随机内容，几乎无法压缩
+static std::string random_page(uint32_t seed) {
+    std::string page(PAGE_SIZE, '\0');
+    for (auto& byte : page) {
+        seed = seed * 1103515245u + 12345u;
+        byte = static_cast<char>(seed >> 24);
+    }
+    return page;
+}
+
+void test_compressed_pool() {
+    std::cout << "  - Testing Compressed Pool..." << std::endl;
+    std::string text;
+    while (text.size() < PAGE_SIZE) {
+        text += "pid=" + std::to_string(text.size() % 97) + " state=READY;";
+    }
+    text.resize(PAGE_SIZE);
+    std::string pages[] = {std::string(PAGE_SIZE, '\0'), std::string(PAGE_SIZE, 'x'), text, random_page(7)};
+    uint8_t compressed[PAGE_SIZE * 2];
+    for (const auto& page : pages) {
+        auto src = reinterpret_cast<const uint8_t*>(page.data());
+        size_t length = CompressedPool::compress(src, PAGE_SIZE, compressed, sizeof(compressed));
+        ASSERT_TRUE(length > 0);
+        std::string out(PAGE_SIZE, '\0');
+        ASSERT_TRUE(CompressedPool::decompress(compressed, length, reinterpret_cast<uint8_t*>(&out[0]), PAGE_SIZE));
+        ASSERT_TRUE(out == page);
+        ASSERT_FALSE(CompressedPool::decompress(compressed, length, reinterpret_cast<uint8_t*>(&out[0]), PAGE_SIZE - 1));
+    }
+    ASSERT_TRUE(CompressedPool::compress(reinterpret_cast<const uint8_t*>(text.data()), PAGE_SIZE, compressed, PAGE_SIZE / 4) > 0);
+    ASSERT_EQUAL(CompressedPool::compress(reinterpret_cast<const uint8_t*>(pages[3].data()), PAGE_SIZE, compressed, PAGE_SIZE), 0);
+
+    // 池上限两个最小槽位：不可压缩的页面与超出上限的页面都不存入
+    CompressedPool pool(2 * CompressedPool::CLASS_SIZE);
+    ASSERT_FALSE(pool.store(pages[3].data()).has_value());
+    auto zero = pool.store(pages[0].data());
+    auto same = pool.store(pages[1].data());
+    ASSERT_TRUE(zero.has_value() && same.has_value());
+    ASSERT_FALSE(pool.store(pages[1].data()).has_value());
+    auto stats = pool.stats();
+    ASSERT_EQUAL(stats.stored_pages, 2);
+    ASSERT_EQUAL(stats.pool_bytes, 2 * CompressedPool::CLASS_SIZE);
+    ASSERT_EQUAL(stats.rejected_incompressible, 1);
+    ASSERT_EQUAL(stats.rejected_full, 1);
+    ASSERT_TRUE(stats.compressed_bytes < 2 * CompressedPool::CLASS_SIZE);
+
+    // 释放的槽位被同一尺寸类复用
+    pool.release(*zero);
+    auto reused = pool.store(pages[1].data());
+    ASSERT_TRUE(reused.has_value());
+    ASSERT_EQUAL(*reused, *zero);
+    std::string out(PAGE_SIZE, '\0');
+    ASSERT_TRUE(pool.load(*reused, &out[0]));
+    ASSERT_TRUE(out == pages[1]);
+    ASSERT_EQUAL(pool.stats().loads, 1);
+    pool.release(*reused);
+    ASSERT_FALSE(pool.load(*reused, &out[0]));
+    pool.clear();
+    ASSERT_EQUAL(pool.stats().stored_pages, 0);
+    ASSERT_EQUAL(pool.stats().pool_bytes, 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_compressed_swap() {
+    std::cout << "  - Testing MM Compressed Swap..." << std::endl;
+    FileSystemManager fs;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_physical_frame_limit(1);
+    ASSERT_TRUE(mm.attach_swap(fs, 4 * PAGE_SIZE));
+    mm.set_writeback_queue_limit(0);
+    mm.set_compressed_swap(true);
+    ASSERT_TRUE(mm.is_compressed_swap());
+
+    // 只有一个页框：依次写入 4 页，前 3 页被换出，其中第 1 页无法压缩
+    ASSERT_TRUE(mm.allocate_for_process(1, 4 * PAGE_SIZE).has_value());
+    std::string pages[] = {std::string(PAGE_SIZE, 'a'), random_page(11), std::string(PAGE_SIZE, 'c'), std::string(PAGE_SIZE, 'd')};
+    for (uint64_t page = 0; page < 4; ++page) {
+        ASSERT_TRUE(mm.write_virtual(1, page * PAGE_SIZE, pages[page].data(), PAGE_SIZE));
+    }
+    auto compressed = mm.get_compressed_swap_stats();
+    ASSERT_EQUAL(compressed.pool.stores, 2);
+    ASSERT_EQUAL(compressed.pool.stored_pages, 2);
+    ASSERT_EQUAL(compressed.pool.rejected_incompressible, 1);
+    ASSERT_TRUE(compressed.pool.compressed_bytes * 10 < 2 * PAGE_SIZE);
+    auto swap = mm.get_swap_stats();
+    ASSERT_EQUAL(swap.swap_outs, 3);
+    ASSERT_EQUAL(swap.writebacks_completed, 1); // 只有不可压缩的页面写入磁盘
+    ASSERT_EQUAL(swap.used_slots, 1);
+
+    // 缺页时从压缩池或磁盘读回；干净页面再次换出时不必重新存入
+    std::string out(PAGE_SIZE, '\0');
+    for (uint64_t page = 0; page < 4; ++page) {
+        ASSERT_TRUE(mm.read_virtual(1, page * PAGE_SIZE, &out[0], PAGE_SIZE));
+        ASSERT_TRUE(out == pages[page]);
+    }
+    compressed = mm.get_compressed_swap_stats();
+    ASSERT_EQUAL(compressed.faults, 3);
+    ASSERT_EQUAL(compressed.disk_faults, 1);
+    ASSERT_EQUAL(compressed.pool.stores, 3); // 第 3 页首次换出
+    ASSERT_EQUAL(compressed.pool.loads, 3);
+    ASSERT_EQUAL(mm.get_swap_stats().writebacks_completed, 1);
+
+    // 关闭后已存入的页面仍可调入，新换出的页面写入磁盘
+    mm.set_compressed_swap(false);
+    ASSERT_TRUE(mm.write_virtual(1, 0, "A", 1));
+    ASSERT_TRUE(mm.read_virtual(1, 2 * PAGE_SIZE, &out[0], PAGE_SIZE));
+    ASSERT_TRUE(out == pages[2]);
+    ASSERT_EQUAL(mm.get_swap_stats().writebacks_completed, 2);
+
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_compressed_swap_stats().pool.stored_pages, 0);
+    ASSERT_EQUAL(mm.get_swap_stats().used_slots, 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_huge_pages() {
+    std::cout << "  - Testing MM Huge Pages..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_page_table_layout(PageTableLayout::RADIX_4);
+    ASSERT_TRUE(mm.configure_tlb(4, 2));
+    mm.allocate_for_process(1, PAGE_SIZE); // 占用页框 0，第一个对齐区间不再空闲
+
+    // 对齐的 2MB 区间映射为大页，剩余部分使用普通页
+    mm.set_huge_pages(true);
+    ASSERT_TRUE(mm.allocate_for_process(2, 2 * HUGE_PAGE_SIZE + PAGE_SIZE).has_value());
+    auto huge = mm.get_huge_page_stats();
+    ASSERT_EQUAL(huge.huge_pages, 2);
+    ASSERT_EQUAL(huge.allocations, 2);
+    ASSERT_EQUAL(mm.get_used_pages(), 2 * HUGE_PAGE_FRAMES + 2);
+    ASSERT_EQUAL(mm.get_page_table(2)->resident_count(), 2 * HUGE_PAGE_FRAMES + 1);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, 3 * PAGE_SIZE + 5), (HUGE_PAGE_FRAMES + 3) * PAGE_SIZE + 5);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, 600 * PAGE_SIZE), (2 * HUGE_PAGE_FRAMES + 88) * PAGE_SIZE);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, 1024 * PAGE_SIZE), PAGE_SIZE);
+
+    // 8 个 TLB 表项覆盖 4MB：每个大页只在首次访问时未命中
+    mm.reset_page_fault_stats();
+    for (uint64_t page = 0; page < 2 * HUGE_PAGE_FRAMES; ++page) {
+        mm.translate_virtual_to_physical(2, page * PAGE_SIZE);
+    }
+    ASSERT_EQUAL(mm.get_tlb().stats().misses, 0);
+    ASSERT_EQUAL(mm.get_tlb().stats().hits, 2 * HUGE_PAGE_FRAMES);
+
+    // 同样大小的普通页页表需要叶结点，占用更多内存
+    mm.set_huge_pages(false);
+    ASSERT_TRUE(mm.allocate_for_process(3, 2 * HUGE_PAGE_SIZE + PAGE_SIZE).has_value());
+    ASSERT_TRUE(mm.get_page_table(2)->memory_bytes() < mm.get_page_table(3)->memory_bytes());
+    ASSERT_TRUE(mm.free_process_memory(3));
+
+    // fork 前拆分为普通页，子进程以写时复制共享内容
+    std::string data(PAGE_SIZE, 'h');
+    ASSERT_TRUE(mm.write_virtual(2, 5 * PAGE_SIZE, data.data(), data.size()));
+    ASSERT_TRUE(mm.fork_address_space(2, 4));
+    huge = mm.get_huge_page_stats();
+    ASSERT_EQUAL(huge.huge_pages, 0);
+    ASSERT_EQUAL(huge.splits, 2);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(4, 5 * PAGE_SIZE), (HUGE_PAGE_FRAMES + 5) * PAGE_SIZE);
+    char byte = 0;
+    ASSERT_TRUE(mm.read_virtual(4, 5 * PAGE_SIZE + 1, &byte, 1));
+    ASSERT_EQUAL(byte, 'h');
+    ASSERT_EQUAL(mm.get_frame_refcount(HUGE_PAGE_FRAMES + 5), 2);
+
+    // 释放后所有页框归还
+    ASSERT_TRUE(mm.free_process_memory(4));
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_huge_page_promotion() {
+    std::cout << "  - Testing MM Huge Page Promotion..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(1, PAGE_SIZE);
+    ASSERT_TRUE(mm.allocate_for_process(2, HUGE_PAGE_SIZE).has_value()); // 页框 1..512，未对齐
+    ASSERT_TRUE(mm.allocate_for_process(3, HUGE_PAGE_SIZE + PAGE_SIZE).has_value());
+    std::string data(PAGE_SIZE, 'p');
+    ASSERT_TRUE(mm.write_virtual(2, 7 * PAGE_SIZE, data.data(), data.size()));
+
+    // 未开启大页时不合并
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 0);
+    mm.set_huge_pages(true);
+
+    // 每次扫描一个进程：进程 1 不足 512 页，进程 2 的页框复制到新的对齐区间
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 0);
+    uint64_t used_pages = mm.get_used_pages();
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 1);
+    ASSERT_EQUAL(mm.get_used_pages(), used_pages);
+    ASSERT_EQUAL(mm.get_page_table(2)->huge_count(), 1);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, 0) % HUGE_PAGE_SIZE, 0);
+    char byte = 0;
+    ASSERT_TRUE(mm.read_virtual(2, 7 * PAGE_SIZE + 9, &byte, 1));
+    ASSERT_EQUAL(byte, 'p');
+
+    // 写时复制共享的区间不合并
+    ASSERT_TRUE(mm.fork_address_space(3, 4));
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 0);
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 0);
+    ASSERT_TRUE(mm.free_process_memory(4));
+
+    // 子进程退出后页框回到私有，原地址不对齐时再次复制
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 0); // 进程 1
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 0); // 进程 2 已是大页
+    ASSERT_EQUAL(mm.promote_huge_pages(4), 1);
+    auto huge = mm.get_huge_page_stats();
+    ASSERT_EQUAL(huge.huge_pages, 2);
+    ASSERT_EQUAL(huge.promotions, 2);
+    ASSERT_EQUAL(huge.allocations, 0);
+
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_TRUE(mm.free_process_memory(3));
+    ASSERT_EQUAL(mm.get_used_pages(), 1);
+
+    // 已对齐且连续的页框原地合并，不复制
+    ASSERT_TRUE(mm.free_process_memory(1));
+    mm.set_huge_pages(false);
+    ASSERT_TRUE(mm.allocate_for_process(5, HUGE_PAGE_SIZE).has_value());
+    mm.set_huge_pages(true);
+    ASSERT_EQUAL(mm.promote_huge_pages(1), 1);
+    ASSERT_EQUAL(mm.get_used_pages(), HUGE_PAGE_FRAMES);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(5, 3 * PAGE_SIZE), 3 * PAGE_SIZE);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_vma_tree() {
+    std::cout << "  - Testing VMA Tree..." << std::endl;
+    const uint32_t rw = VMA_PROT_READ | VMA_PROT_WRITE;
+    VmaTree vmas;
+    ASSERT_TRUE(vmas.insert(Vma{0, 4, rw, VmaKind::ANONYMOUS, -1}));
+    ASSERT_TRUE(vmas.insert(Vma{4, 4, rw, VmaKind::ANONYMOUS, -1}));
+    ASSERT_FALSE(vmas.insert(Vma{6, 4, rw, VmaKind::ANONYMOUS, -1}));
+    ASSERT_EQUAL(vmas.size(), 1); // 相邻且属性相同的区域合并
+    ASSERT_TRUE(vmas.insert(Vma{10, 2, rw, VmaKind::HEAP, -1}));
+    ASSERT_EQUAL(vmas.size(), 2);
+    ASSERT_EQUAL(*vmas.find_gap(2, 16), 8);
+    ASSERT_FALSE(vmas.find_gap(3, 12).has_value());
+    ASSERT_TRUE(vmas.find(9) == nullptr);
+    ASSERT_FALSE(vmas.covers(6, 5));
+
+    // 修改中间一段的权限会拆分区域，改回后重新合并
+    vmas.protect(2, 3, VMA_PROT_READ);
+    ASSERT_EQUAL(vmas.size(), 4);
+    ASSERT_EQUAL(vmas.find(3)->prot, VMA_PROT_READ);
+    ASSERT_EQUAL(vmas.find(5)->prot, rw);
+    vmas.protect(2, 3, rw);
+    ASSERT_EQUAL(vmas.size(), 2);
+
+    vmas.remove(3, 8);
+    ASSERT_EQUAL(vmas.size(), 2);
+    ASSERT_EQUAL(vmas.find(0)->pages, 3);
+    ASSERT_EQUAL(vmas.find(11)->start_page, 11);
+    ASSERT_EQUAL(vmas.end_page(), 12);
+    ASSERT_TRUE(vmas.is_free(3, 8));
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_mmap_brk() {
+    std::cout << "  - Testing MM mmap/munmap/mprotect/brk..." << std::endl;
+    MemoryManager mm;
+    ASSERT_FALSE(mm.mmap(1, PAGE_SIZE, VMA_PROT_READ).has_value()); // 仅分页模式
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(1, 2 * PAGE_SIZE);
+    const uint32_t rw = VMA_PROT_READ | VMA_PROT_WRITE;
+
+    // 映射在地址空间顶端，页框在首次访问时分配
+    auto address = mm.mmap(1, 3 * PAGE_SIZE, rw);
+    ASSERT_EQUAL(*address, 2 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_vmas(1)->size(), 1);
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    std::string data(PAGE_SIZE, 'm');
+    ASSERT_TRUE(mm.write_virtual(1, 2 * PAGE_SIZE, data.data(), data.size()));
+    ASSERT_EQUAL(mm.get_used_pages(), 3);
+    ASSERT_FALSE(mm.translate_virtual_to_physical(1, 5 * PAGE_SIZE).has_value());
+
+    // 改为只读后写入失败（TLB 中缓存的可写表项同时作废），读取仍然成功
+    ASSERT_TRUE(mm.mprotect(1, 2 * PAGE_SIZE, 2 * PAGE_SIZE, VMA_PROT_READ));
+    ASSERT_EQUAL(mm.get_vmas(1)->size(), 3);
+    ASSERT_FALSE(mm.write_virtual(1, 2 * PAGE_SIZE, data.data(), 1));
+    char byte = 0;
+    ASSERT_TRUE(mm.read_virtual(1, 2 * PAGE_SIZE + 3, &byte, 1));
+    ASSERT_EQUAL(byte, 'm');
+    ASSERT_TRUE(mm.mprotect(1, 2 * PAGE_SIZE, 2 * PAGE_SIZE, VMA_PROT_NONE));
+    ASSERT_FALSE(mm.read_virtual(1, 2 * PAGE_SIZE, &byte, 1));
+    ASSERT_FALSE(mm.mprotect(1, 4 * PAGE_SIZE, 2 * PAGE_SIZE, rw)); // 区间未完全映射
+    ASSERT_TRUE(mm.mprotect(1, 2 * PAGE_SIZE, 2 * PAGE_SIZE, rw));
+    ASSERT_EQUAL(mm.get_vmas(1)->size(), 1);
+
+    // 撤销中间一页后留下空洞，新的映射优先填补
+    ASSERT_TRUE(mm.munmap(1, 2 * PAGE_SIZE, PAGE_SIZE));
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    ASSERT_FALSE(mm.translate_virtual_to_physical(1, 2 * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(*mm.mmap(1, PAGE_SIZE, rw), 2 * PAGE_SIZE);
+    ASSERT_TRUE(mm.read_virtual(1, 2 * PAGE_SIZE, &byte, 1));
+    ASSERT_EQUAL(byte, 0);
+    ASSERT_FALSE(mm.mmap(1, PAGE_SIZE, rw, 4 * PAGE_SIZE).has_value()); // 指定的地址已被占用
+    // 线性页表按最高页号稠密分配，超出其可映射范围的地址被拒绝，不影响之后的分配位置
+    ASSERT_FALSE(mm.mmap(1, PAGE_SIZE, rw, 1ULL << 40).has_value());
+    ASSERT_FALSE(mm.mmap(1, 2 * PAGE_SIZE, rw, (TOTAL_PAGES - 1) * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(mm.get_vmas(1)->end_page(), 5);
+    ASSERT_EQUAL(*mm.mmap(1, PAGE_SIZE, VMA_PROT_READ, 8 * PAGE_SIZE), 8 * PAGE_SIZE);
+
+    // 堆建立在地址空间顶端，向上增长时不能越过其他映射
+    ASSERT_EQUAL(*mm.brk(1, 0), 9 * PAGE_SIZE);
+    ASSERT_EQUAL(*mm.brk(1, 9 * PAGE_SIZE + 100), 9 * PAGE_SIZE + 100);
+    ASSERT_TRUE(mm.write_virtual(1, 9 * PAGE_SIZE + 50, data.data(), 10));
+    ASSERT_FALSE(mm.brk(1, 8 * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(*mm.mmap(1, PAGE_SIZE, rw, 10 * PAGE_SIZE), 10 * PAGE_SIZE);
+    ASSERT_FALSE(mm.brk(1, 12 * PAGE_SIZE).has_value());
+    uint64_t used_pages = mm.get_used_pages();
+    ASSERT_EQUAL(*mm.brk(1, 9 * PAGE_SIZE), 9 * PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_used_pages(), used_pages - 1);
+    ASSERT_FALSE(mm.translate_virtual_to_physical(1, 9 * PAGE_SIZE).has_value());
+
+    // 共享内存段只能通过 shm_detach 撤销
+    auto shmid = mm.shm_create(PAGE_SIZE);
+    auto shm_address = mm.shm_attach(*shmid, 1);
+    ASSERT_EQUAL(*shm_address, 11 * PAGE_SIZE);
+    ASSERT_FALSE(mm.munmap(1, 10 * PAGE_SIZE, 2 * PAGE_SIZE));
+    ASSERT_TRUE(mm.shm_detach(*shmid, 1));
+    ASSERT_TRUE(mm.shm_remove(*shmid));
+    ASSERT_TRUE(mm.munmap(1, 10 * PAGE_SIZE, 2 * PAGE_SIZE));
+    ASSERT_EQUAL(mm.get_vmas(1)->end_page(), 9);
+
+    // 超出虚拟地址空间（包括 length 溢出）的区间直接拒绝；覆盖整个剩余地址空间的撤销只遍历驻留页
+    uint64_t max_pages = mm.get_page_table(1)->max_pages();
+    ASSERT_FALSE(mm.munmap(1, 8 * PAGE_SIZE, UINT64_MAX));
+    ASSERT_FALSE(mm.mprotect(1, 0, UINT64_MAX - PAGE_SIZE + 2, rw));
+    ASSERT_FALSE(mm.munmap(1, max_pages * PAGE_SIZE, PAGE_SIZE));
+    ASSERT_TRUE(mm.munmap(1, 8 * PAGE_SIZE, (max_pages - 8) * PAGE_SIZE));
+    ASSERT_EQUAL(mm.get_vmas(1)->end_page(), 5);
+
+    // 子进程继承区域与权限
+    ASSERT_TRUE(mm.mprotect(1, 0, PAGE_SIZE, VMA_PROT_READ));
+    ASSERT_TRUE(mm.fork_address_space(1, 2));
+    ASSERT_FALSE(mm.write_virtual(2, 0, data.data(), 1));
+    ASSERT_TRUE(mm.write_virtual(2, PAGE_SIZE, data.data(), 1));
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_munmap_huge_page() {
+    std::cout << "  - Testing MM munmap Splits Huge Pages..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.set_huge_pages(true);
+    ASSERT_TRUE(mm.allocate_for_process(1, 2 * HUGE_PAGE_SIZE).has_value());
+    ASSERT_EQUAL(mm.get_huge_page_stats().huge_pages, 2);
+
+    // 整个大页被撤销时直接释放，只撤销其中一部分时先拆分
+    ASSERT_TRUE(mm.munmap(1, 0, HUGE_PAGE_SIZE + 10 * PAGE_SIZE));
+    auto huge = mm.get_huge_page_stats();
+    ASSERT_EQUAL(huge.huge_pages, 0);
+    ASSERT_EQUAL(huge.splits, 1);
+    ASSERT_EQUAL(mm.get_used_pages(), HUGE_PAGE_FRAMES - 10);
+    ASSERT_EQUAL(mm.get_used_memory(), (HUGE_PAGE_FRAMES - 10) * PAGE_SIZE);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(1, (HUGE_PAGE_FRAMES + 10) * PAGE_SIZE), (HUGE_PAGE_FRAMES + 10) * PAGE_SIZE);
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_file_mapping() {
+    std::cout << "  - Testing MM File Mapping..." << std::endl;
+    FileSystemManager fs;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    ASSERT_TRUE(fs.create_file("/data.bin", 3 * PAGE_SIZE + 100, 644) == FsCreateResult::Success);
+    auto block_map = fs.get_file_block_map("/data.bin");
+    ASSERT_TRUE(block_map.has_value());
+    ASSERT_EQUAL(block_map->blocks.size(), 4);
+    std::vector<char> block(PAGE_SIZE, 'b');
+    fs.write_block(block_map->blocks[1], block.data());
+
+    // 映射只建立区域，页面在首次访问时读入
+    auto address = mm.mmap_file(1, fs, "/data.bin", VMA_PROT_READ | VMA_PROT_WRITE);
+    ASSERT_EQUAL(*address, 0);
+    ASSERT_EQUAL(mm.get_vmas(1)->areas().at(0).pages, 4);
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    char byte = 0;
+    ASSERT_TRUE(mm.read_virtual(1, PAGE_SIZE + 7, &byte, 1));
+    ASSERT_EQUAL(byte, 'b');
+    ASSERT_EQUAL(mm.get_used_pages(), 1);
+    ASSERT_FALSE(mm.mmap_file(1, fs, "/data.bin", VMA_PROT_READ, 100).has_value()); // 偏移未对齐
+    ASSERT_FALSE(mm.mmap_file(1, fs, "/missing.bin", VMA_PROT_READ).has_value());
+
+    // 另一进程与子进程共享页缓存中的同一页框
+    auto other = mm.mmap_file(2, fs, "/data.bin", VMA_PROT_READ, PAGE_SIZE, PAGE_SIZE);
+    ASSERT_TRUE(mm.read_virtual(2, *other, &byte, 1));
+    ASSERT_EQUAL(byte, 'b');
+    ASSERT_EQUAL(mm.get_used_pages(), 1);
+    uint64_t frame = *mm.translate_virtual_to_physical(1, PAGE_SIZE) / PAGE_SIZE;
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(2, *other) / PAGE_SIZE, frame);
+    ASSERT_TRUE(mm.fork_address_space(1, 3));
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(3, PAGE_SIZE) / PAGE_SIZE, frame);
+    ASSERT_EQUAL(mm.get_frame_refcount(frame), 3);
+    ASSERT_EQUAL(mm.get_frame_sharing_stats().file_frames, 1);
+    ASSERT_FALSE(mm.write_virtual(2, *other, "x", 1)); // 只读映射
+
+    // 写入对所有映射者可见，最后一个映射者撤销后写回文件块
+    ASSERT_TRUE(mm.write_virtual(3, PAGE_SIZE + 7, "w", 1));
+    ASSERT_TRUE(mm.read_virtual(1, PAGE_SIZE + 7, &byte, 1));
+    ASSERT_EQUAL(byte, 'w');
+    ASSERT_TRUE(mm.free_process_memory(3));
+    ASSERT_TRUE(mm.munmap(1, PAGE_SIZE, PAGE_SIZE));
+    fs.read_block(block_map->blocks[1], block.data());
+    ASSERT_EQUAL(block[7], 'b');
+    ASSERT_TRUE(mm.free_process_memory(2));
+    fs.read_block(block_map->blocks[1], block.data());
+    ASSERT_EQUAL(block[7], 'w');
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_mapped_files().size(), 1);
+
+    // sync 立即写回，之后的写入重新置脏
+    ASSERT_TRUE(mm.write_virtual(1, 2 * PAGE_SIZE, "s", 1));
+    ASSERT_EQUAL(mm.sync_file_pages(), 1);
+    ASSERT_EQUAL(mm.sync_file_pages(), 0);
+    fs.read_block(block_map->blocks[2], block.data());
+    ASSERT_EQUAL(block[0], 's');
+    ASSERT_TRUE(mm.write_virtual(1, 2 * PAGE_SIZE, "t", 1));
+    ASSERT_EQUAL(mm.sync_file_pages(), 1);
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_used_memory(), 0);
+    ASSERT_TRUE(mm.get_mapped_files().empty());
+
+    // 链接分配的块尾保存下一块的指针，写回时保留
+    fs.set_allocation_strategy(AllocationStrategy::LINKED);
+    ASSERT_TRUE(fs.create_file("/linked.bin", 2 * PAGE_SIZE, 644) == FsCreateResult::Success);
+    auto linked = fs.get_file_block_map("/linked.bin");
+    ASSERT_EQUAL(linked->block_payload, PAGE_SIZE - 4);
+    ASSERT_EQUAL(linked->blocks.size(), 2);
+    address = mm.mmap_file(4, fs, "/linked.bin", VMA_PROT_READ | VMA_PROT_WRITE);
+    std::vector<char> fill(2 * PAGE_SIZE, 'l');
+    ASSERT_TRUE(mm.write_virtual(4, *address, fill.data(), fill.size()));
+    ASSERT_TRUE(mm.free_process_memory(4));
+    auto relinked = fs.get_file_block_map("/linked.bin");
+    ASSERT_TRUE(relinked->blocks == linked->blocks);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_process_heap() {
+    std::cout << "  - Testing MM Process Heap..." << std::endl;
+    MemoryManager mm;
+    ASSERT_FALSE(mm.heap_alloc(1, 64).has_value()); // 仅分页模式
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(1, 2 * PAGE_SIZE);
+    uint64_t heap_base = 2 * PAGE_SIZE;
+
+    // 首次分配建立堆并按 HEAP_GROW_STEP 扩大 brk，页框在首次访问时分配
+    auto a = mm.heap_alloc(1, 100);
+    ASSERT_EQUAL(*a, heap_base);
+    ASSERT_EQUAL(*mm.brk(1, 0), heap_base + HEAP_GROW_STEP);
+    ASSERT_EQUAL(mm.get_used_pages(), 2);
+    ASSERT_TRUE(mm.write_virtual(1, *a, "heap", 4));
+    ASSERT_EQUAL(mm.get_used_pages(), 3);
+    auto b = mm.heap_alloc(1, 200);
+    ASSERT_EQUAL(*b, heap_base + 112);
+    ASSERT_EQUAL(mm.get_heap(1)->stats().failures, 1);
+
+    // 大块分配继续扩大堆；brk 收缩不能截断使用中的块
+    auto big = mm.heap_alloc(1, 512 * 1024);
+    ASSERT_TRUE(big.has_value());
+    uint64_t program_break = *mm.brk(1, 0);
+    ASSERT_TRUE(program_break >= *big + 512 * 1024);
+    ASSERT_FALSE(mm.brk(1, *big + PAGE_SIZE).has_value());
+    ASSERT_EQUAL(mm.get_memory_charge(1), program_break - heap_base + 2 * PAGE_SIZE);
+
+    // fork 后子进程拥有独立的堆状态
+    ASSERT_TRUE(mm.fork_address_space(1, 2));
+    ASSERT_TRUE(mm.heap_free(2, *b));
+    ASSERT_EQUAL(mm.get_heap(1)->stats().live_blocks, 3);
+    ASSERT_EQUAL(mm.get_heap(2)->stats().live_blocks, 2);
+
+    // 释放大块后末尾空闲超过阈值，堆按整页收缩
+    ASSERT_TRUE(mm.heap_free(1, *big));
+    ASSERT_FALSE(mm.heap_free(1, *big));
+    ASSERT_EQUAL(*mm.brk(1, 0), heap_base + PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_heap(1)->capacity(), PAGE_SIZE);
+    ASSERT_EQUAL(mm.get_memory_charge(1), 3 * PAGE_SIZE);
+    char text[4] = {};
+    ASSERT_TRUE(mm.read_virtual(1, *a, text, 4));
+    ASSERT_TRUE(std::string(text, 4) == "heap");
+
+    // 直接用 brk 扩大的部分同样交给分配器
+    ASSERT_TRUE(mm.brk(1, heap_base + 4 * PAGE_SIZE).has_value());
+    ASSERT_EQUAL(mm.get_heap(1)->capacity(), 4 * PAGE_SIZE);
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_TRUE(mm.get_heap(1) == nullptr);
+
+    // 策略只影响之后建立的堆
+    mm.set_heap_policy(HeapPolicy::BEST_FIT);
+    mm.allocate_for_process(3, PAGE_SIZE);
+    ASSERT_TRUE(mm.heap_alloc(3, 64).has_value());
+    ASSERT_TRUE(mm.get_heap(3)->policy() == HeapPolicy::BEST_FIT);
+    ASSERT_TRUE(mm.get_heap(2)->policy() == HeapPolicy::TLSF);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_reverse_map() {
+    std::cout << "  - Testing MM Reverse Map..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    mm.allocate_for_process(1, 3 * PAGE_SIZE);
+    auto frame_of = [&](ProcessID pid, uint64_t page_number) {
+        return *mm.translate_virtual_to_physical(pid, page_number * PAGE_SIZE) / PAGE_SIZE;
+    };
+    for (uint64_t page = 0; page < 3; ++page) {
+        auto owner = mm.get_frame_owner(frame_of(1, page));
+        ASSERT_EQUAL(owner->pid, 1);
+        ASSERT_EQUAL(owner->page_number, page);
+    }
+
+    // 写时复制共享的页框列出全部映射者；原映射者退出后改由剩余的映射者持有
+    ASSERT_TRUE(mm.fork_address_space(1, 2));
+    uint64_t shared = frame_of(2, 1);
+    ASSERT_EQUAL(mm.get_frame_mappers(shared).size(), 2);
+    mm.write_memory(2, PAGE_SIZE, "c", 1);
+    uint64_t copy = frame_of(2, 1);
+    ASSERT_EQUAL(mm.get_frame_owner(copy)->pid, 2);
+    ASSERT_EQUAL(mm.get_frame_mappers(shared).size(), 1);
+    uint64_t still_shared = frame_of(2, 2);
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_EQUAL(mm.get_frame_owner(still_shared)->pid, 2);
+    ASSERT_EQUAL(mm.get_frame_owner(still_shared)->page_number, 2);
+    ASSERT_FALSE(mm.get_frame_owner(shared).has_value()); // 已释放
+    ASSERT_TRUE(mm.get_frame_mappers(shared).empty());
+
+    // 共享内存段的页框由段持有，映射者为各进程映射的位置
+    auto shmid = mm.shm_create(2 * PAGE_SIZE);
+    auto shm_address = mm.shm_attach(*shmid, 2);
+    uint64_t shm_frame = frame_of(2, *shm_address / PAGE_SIZE + 1);
+    ASSERT_FALSE(mm.get_frame_owner(shm_frame).has_value());
+    auto mappers = mm.get_frame_mappers(shm_frame);
+    ASSERT_EQUAL(mappers.size(), 1);
+    ASSERT_EQUAL(mappers[0].page_number, *shm_address / PAGE_SIZE + 1);
+
+    // 请求调页与大页
+    mm.set_demand_paging(true);
+    auto block = mm.allocate_for_process(3, 2 * PAGE_SIZE);
+    ASSERT_TRUE(mm.write_virtual(3, block->base_address + PAGE_SIZE, "d", 1));
+    ASSERT_EQUAL(mm.get_frame_owner(frame_of(3, 1))->pid, 3);
+    mm.set_demand_paging(false);
+    mm.set_huge_pages(true);
+    mm.allocate_for_process(4, HUGE_PAGE_SIZE);
+    uint64_t huge_first = frame_of(4, 0);
+    ASSERT_EQUAL(mm.get_frame_owner(huge_first + 511)->page_number, 511);
+    ASSERT_TRUE(mm.free_process_memory(4));
+    ASSERT_FALSE(mm.get_frame_owner(huge_first).has_value());
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_page_merging() {
+    std::cout << "  - Testing MM Same-Page Merging..." << std::endl;
+    MemoryManager mm;
+    mm.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+    // 三个进程：第 0 页内容相同，第 1 页各不相同，第 2、3 页从未写入（全 0）
+    const std::string image = "svchost.exe";
+    for (ProcessID pid = 1; pid <= 3; ++pid) {
+        mm.allocate_for_process(pid, 4 * PAGE_SIZE);
+        ASSERT_TRUE(mm.write_virtual(pid, 0, image.data(), image.size()));
+        std::string own = "private-" + std::to_string(pid);
+        ASSERT_TRUE(mm.write_virtual(pid, PAGE_SIZE, own.data(), own.size()));
+    }
+    ASSERT_EQUAL(mm.get_used_pages(), 12);
+    ASSERT_EQUAL(mm.merge_same_pages(64), 0); // 未开启
+
+    mm.set_page_merging(true);
+    ASSERT_EQUAL(mm.merge_same_pages(64), 7);
+    ASSERT_EQUAL(mm.get_used_pages(), 5);
+    auto stats = mm.get_page_merging_stats();
+    ASSERT_EQUAL(stats.merged_frames, 2);
+    ASSERT_EQUAL(stats.pages_sharing, 7);
+    ASSERT_EQUAL(stats.bytes_saved, 7 * PAGE_SIZE);
+    ASSERT_TRUE(stats.full_scans >= 1);
+    uint64_t shared = *mm.translate_virtual_to_physical(1, 0);
+    ASSERT_EQUAL(*mm.translate_virtual_to_physical(3, 0), shared);
+    ASSERT_EQUAL(mm.get_frame_refcount(shared / PAGE_SIZE), 3);
+    ASSERT_EQUAL(mm.merge_same_pages(64), 0); // 再次扫描不会重复合并
+
+    // 写入合并的页面时复制出私有副本，其他进程不受影响
+    ASSERT_TRUE(mm.write_virtual(2, 0, "X", 1));
+    ASSERT_EQUAL(mm.get_used_pages(), 6);
+    char buffer[11] = {};
+    ASSERT_TRUE(mm.read_virtual(1, 0, buffer, image.size()));
+    ASSERT_TRUE(std::string(buffer, image.size()) == image);
+    ASSERT_TRUE(mm.read_virtual(2, 0, buffer, image.size()));
+    ASSERT_TRUE(std::string(buffer, image.size()) == "Xvchost.exe");
+    ASSERT_TRUE(mm.read_virtual(3, PAGE_SIZE, buffer, 9));
+    ASSERT_TRUE(std::string(buffer, 9) == "private-3");
+    ASSERT_EQUAL(mm.get_page_merging_stats().pages_sharing, 6);
+
+    // 只剩一个映射者的页框移出稳定表
+    ASSERT_TRUE(mm.free_process_memory(1));
+    ASSERT_TRUE(mm.free_process_memory(3));
+    stats = mm.get_page_merging_stats();
+    ASSERT_EQUAL(stats.merged_frames, 1); // 进程 2 的两个全 0 页面
+    ASSERT_EQUAL(stats.pages_sharing, 1);
+    ASSERT_TRUE(mm.free_process_memory(2));
+    ASSERT_EQUAL(mm.get_used_pages(), 0);
+    ASSERT_EQUAL(mm.get_page_merging_stats().merged_frames, 0);
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void test_mm_page_merging_eviction() {
+    std::cout << "  - Testing MM Same-Page Merging Eviction..." << std::endl;
+    // 任一映射者退出后，剩下的映射者换出时必须写回唯一的副本
+    for (ProcessID survivor = 1; survivor <= 2; ++survivor) {
+        MemoryManager merged;
+        merged.set_allocation_strategy(MemoryAllocationStrategy::PAGED);
+        merged.set_demand_paging(true);
+        merged.set_physical_frame_limit(4);
+        merged.set_page_merging(true);
+        for (ProcessID pid = 1; pid <= 2; ++pid) {
+            merged.allocate_for_process(pid, PAGE_SIZE);
+            ASSERT_TRUE(merged.write_virtual(pid, 0, "same", 4));
+        }
+        ASSERT_EQUAL(merged.merge_same_pages(64), 1);
+        ASSERT_TRUE(merged.free_process_memory(3 - survivor));
+        merged.allocate_for_process(3, 4 * PAGE_SIZE);
+        for (uint64_t page = 0; page < 4; ++page) {
+            ASSERT_TRUE(merged.translate_virtual_to_physical(3, page * PAGE_SIZE).has_value());
+        }
+        ASSERT_EQUAL(merged.get_page_fault_stats(survivor).evictions, 1);
+        char buffer[4] = {};
+        ASSERT_TRUE(merged.read_virtual(survivor, 0, buffer, 4));
+        ASSERT_TRUE(std::string(buffer, 4) == "same");
+    }
+    std::cout << "    ...PASSED" << std::endl;
+}
+
+void run_memory_manager_paged_tests() {
+    test_frame_bitmap_hierarchy();
+    test_mm_paged_page_statistics();
+    test_mm_demand_paging_policies();
+    test_mm_demand_paging_writeback();
+    test_mm_tlb();
+    test_mm_tlb_demand_paging();
+    test_page_table_layouts();
+    test_mm_radix_page_tables();
+    test_mm_copy_on_write_fork();
+    test_mm_copy_on_write_fork_eviction();
+    test_pm_fork_shares_frames();
+    test_pm_exec_shares_image();
+    test_pm_oom_killer();
+    test_pm_memory_group_fork_storm();
+    test_mm_shared_memory();
+    test_mm_virtual_io();
+    test_mm_swap_area();
+    test_compressed_pool();
+    test_mm_compressed_swap();
+    test_mm_huge_pages();
+    test_mm_huge_page_promotion();
+    test_vma_tree();
+    test_mm_mmap_brk();
+    test_mm_munmap_huge_page();
+    test_mm_file_mapping();
+    test_mm_process_heap();
+    test_mm_reverse_map();
+    test_mm_page_merging();
+    test_mm_page_merging_eviction();
+}
@@ -11,6 +11,7 @@ void run_clock_manager_tests();
 void run_device_manager_tests();
 void run_fs_manager_tests();
 void run_memory_manager_tests();
+void run_memory_manager_paged_tests();
 void run_process_manager_tests();
 void run_interrupt_manager_tests();
 // Add more declarations as new test files are created
@@ -21,6 +22,7 @@ int main() {
         {"Device Manager", run_device_manager_tests},
         {"FS Manager", run_fs_manager_tests},
         {"Memory Manager", run_memory_manager_tests},
+        {"Memory Manager (Paged)", run_memory_manager_paged_tests},
         {"Process Manager", run_process_manager_tests},
         {"Interrupt Manager", run_interrupt_manager_tests}
         // Add more test suites here